@@ -96,7 +96,12 @@ public:
 
 	template <class T>
 	void transfer_all_solvables(T& from) {
-		advanced_cosm.assign_solvable(from.advanced_cosm);
+		/*
+			The predicted and the referential cosmos are mostly identical between repredictions,
+			so only write the entities that either of them accessed since the last transfer.
+		*/
+
+		advanced_cosm.assign_solvable_changes(from.advanced_cosm);
 		current_mode_state = from.current_mode_state;
 
 		verify_mode_hasnt_changed();
@@ -1,10 +1,12 @@
 #pragma once
 #include "augs/log_direct.h"
+#include "augs/filesystem/file.h"
 #include "application/arena/arena_paths.h"
 #include "application/setups/editor/project/editor_project_paths.h"
 #include "application/setups/editor/project/editor_project_readwrite.h"
 #include "application/arena/arena_playtesting_context.h"
 #include "application/arena/build_arena_from_editor_project.h"
+#include "application/arena/compiled_arena.h"
 #include "application/setups/editor/packaged_official_content_declaration.h"
 
 #include "application/setups/editor/project/editor_project.h"
@@ -36,46 +38,49 @@ struct choose_arena_input {
 	}
 };
 
-inline void load_arena_from_path(
-	const choose_arena_input in,
-	const augs::path_type& json_path,
-	augs::secure_hash_type* const output_arena_hash
+inline bool choose_compiled_arena(
+	const choose_arena_input& in,
+	const augs::path_type& compiled_path
 ) {
-	auto project = editor_project_readwrite::read_project_json(
-		json_path,
-		official_get_resources(in.official),
-		official_get_resource_map(in.official),
-		in.settings,
-		output_arena_hash
-	);
+	all_rulesets_variant ruleset;
 
-	const auto project_dir = json_path.parent_path();
+	if (!::load_compiled_arena(compiled_path, in.handle.scene, ruleset)) {
+		return false;
+	}
 
-	::build_arena_from_editor_project(
-		in.handle,
-		{
-			project,
-			in.override_game_mode,
-			project_dir,
-			in.official,
-			in.entity_to_node,
-			std::addressof(in.clean_round_state),
-			in.is_for_playtesting(),
-			false /* editor_preview */
-		}
-	);
+	auto handle = in.handle;
+	handle.choose_mode(ruleset);
 
-	if (in.keep_loaded_project) {
-		*in.keep_loaded_project = std::move(project);
-	}
+	in.clean_round_state = handle.scene.world.get_solvable().significant;
+
+	return true;
 }
 
-inline void load_arena_from_string(
+inline void build_arena_from_json(
 	const choose_arena_input in,
 	const augs::path_type& project_dir,
 	const std::string& json_document,
-	scene_entity_to_node_map* const entity_to_node = nullptr
+	const augs::secure_hash_type& json_hash,
+	scene_entity_to_node_map* const entity_to_node
 ) {
+	/*
+		The editor needs the loaded project and the entity to node mapping, neither of which is compiled.
+		Arenas being playtested change all the time, so their artifacts would only pile up.
+	*/
+
+	const bool compilable =
+		in.keep_loaded_project == nullptr
+		&& entity_to_node == nullptr
+		&& !in.is_for_playtesting()
+	;
+
+	const auto compiled_path = compilable ? ::get_compiled_arena_path({ json_hash, in.override_game_mode, project_dir, in.settings }) : augs::path_type();
+
+	if (::choose_compiled_arena(in, compiled_path)) {
+		LOG_NOFORMAT("Loaded the compiled arena from: " + compiled_path.string());
+		return;
+	}
+
 	auto project = editor_project_readwrite::read_project_json(
 		project_dir,
 		json_document,
@@ -99,14 +104,47 @@ inline void load_arena_from_string(
 		}
 	);
 
+	::save_compiled_arena(compiled_path, in.handle.scene, in.handle.ruleset);
+
 	if (in.keep_loaded_project) {
 		*in.keep_loaded_project = std::move(project);
 	}
 }
 
+inline void load_arena_from_path(
+	const choose_arena_input in,
+	const augs::path_type& json_path,
+	augs::secure_hash_type* const output_arena_hash,
+	editor_project_readwrite::external_resource_database* const output_external_resources = nullptr
+) {
+	const auto project_dir = json_path.parent_path();
+	const auto json_document = augs::file_to_string_crlf_to_lf(json_path);
+	const auto json_hash = augs::secure_hash(json_document);
+
+	if (output_arena_hash) {
+		*output_arena_hash = json_hash;
+	}
+
+	if (output_external_resources) {
+		*output_external_resources = editor_project_readwrite::read_only_external_resources(project_dir, json_document);
+	}
+
+	::build_arena_from_json(in, project_dir, json_document, json_hash, in.entity_to_node);
+}
+
+inline void load_arena_from_string(
+	const choose_arena_input in,
+	const augs::path_type& project_dir,
+	const std::string& json_document,
+	scene_entity_to_node_map* const entity_to_node = nullptr
+) {
+	::build_arena_from_json(in, project_dir, json_document, augs::secure_hash(json_document), entity_to_node);
+}
+
 struct server_choose_arena_result {
 	augs::secure_hash_type loaded_arena_hash = augs::secure_hash_type();
 	augs::path_type arena_folder_path;
+	editor_project_readwrite::external_resource_database external_resources;
 };
 
 inline server_choose_arena_result choose_arena_server(
@@ -121,7 +159,12 @@ inline server_choose_arena_result choose_arena_server(
 	if (const auto path = ::server_choose_arena_file_by(in.name); !path.empty()) {
 		LOG_NOFORMAT("Loading arena from: " + path.string());
 
-		::load_arena_from_path(in, path, std::addressof(result.loaded_arena_hash));
+		::load_arena_from_path(
+			in,
+			path,
+			std::addressof(result.loaded_arena_hash),
+			std::addressof(result.external_resources)
+		);
 
 		result.arena_folder_path = path.parent_path();
 	}
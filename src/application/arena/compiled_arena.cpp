@@ -0,0 +1,278 @@
+#include <thread>
+#include "augs/misc/pool/pool_io.hpp"
+#include "application/intercosm.h"
+#include "application/arena/compiled_arena.h"
+
+#include "game/cosmos/change_common_significant.hpp"
+#include "game/cosmos/change_solvable_significant.h"
+#include "game/organization/all_component_includes.h"
+
+#include "augs/log.h"
+#include "augs/filesystem/file.h"
+#include "augs/filesystem/directory.h"
+#include "augs/filesystem/mapped_file.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/readwrite/to_bytes.h"
+#include "augs/readwrite/memory_stream.h"
+#include "hypersomnia_version.h"
+#include "all_paths.h"
+
+#define COMPILED_ARENAS_DIR (CACHE_DIR / "compiled_arenas")
+
+constexpr uint32_t compiled_arena_magic_v = 0x4e524341;
+
+/* Bump whenever the build starts to produce something else for the same inputs. */
+constexpr uint32_t compiled_arena_version_v = 1;
+
+static std::string get_compiled_arenas_build_folder() {
+	const auto version = hypersomnia_version();
+
+	if (version.commit_number == 0 || !version.working_tree_changes.empty()) {
+		return {};
+	}
+
+	return version.commit_hash;
+}
+
+augs::path_type get_compiled_arena_path(const compiled_arena_key& key) {
+	const auto build_folder = get_compiled_arenas_build_folder();
+
+	if (build_folder.empty()) {
+		return {};
+	}
+
+	const auto hashed_inputs =
+		std::string(augs::to_hex_format(key.project_json_hash)) + '\n'
+		+ std::string(key.override_game_mode) + '\n'
+		+ key.project_dir.string() + '\n'
+		+ std::to_string(key.settings.strict) + '\n'
+		+ std::to_string(key.settings.read_inactive_nodes)
+	;
+
+	return COMPILED_ARENAS_DIR / build_folder / (std::string(augs::to_hex_format(augs::secure_hash(hashed_inputs))) + ".bin");
+}
+
+bool load_compiled_arena(const augs::path_type& path, intercosm& scene, all_rulesets_variant& ruleset) {
+	if (path.empty() || !augs::exists(path)) {
+		return false;
+	}
+
+	try {
+		const auto file = augs::mapped_file(path);
+		auto in = augs::make_ptr_read_stream(file.data(), file.size());
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+
+		augs::read_bytes(in, magic);
+		augs::read_bytes(in, version);
+
+		if (magic != compiled_arena_magic_v || version != compiled_arena_version_v) {
+			return false;
+		}
+
+		augs::read_bytes(in, ruleset);
+
+		scene.clear();
+		augs::read_bytes(in, scene.viewables);
+
+		scene.world.change_common_significant([&](cosmos_common_significant& common) {
+			augs::read_bytes(in, common);
+			return changer_callback_result::DONT_REFRESH;
+		});
+
+		cosmic::change_solvable_significant(scene.world, [&](cosmos_solvable_significant& significant) {
+			augs::read_bytes(in, significant);
+			return changer_callback_result::DONT_REFRESH;
+		});
+
+		if (in.get_read_pos() != file.size()) {
+			LOG("Compiled arena %x has trailing bytes. Ignoring it.", path);
+			return false;
+		}
+
+		scene.post_load_state_correction();
+		return true;
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to load the compiled arena %x: %x", path, err.what());
+	}
+
+	return false;
+}
+
+void save_compiled_arena(const augs::path_type& path, const intercosm& scene, const all_rulesets_variant& ruleset) {
+	if (path.empty()) {
+		return;
+	}
+
+	std::vector<std::byte> bytes;
+
+	{
+		auto out = augs::ref_memory_stream(bytes);
+
+		augs::write_bytes(out, compiled_arena_magic_v);
+		augs::write_bytes(out, compiled_arena_version_v);
+
+		augs::write_bytes(out, ruleset);
+		augs::write_bytes(out, scene.viewables);
+		augs::write_bytes(out, scene.world.get_common_significant());
+		augs::write_bytes(out, scene.world.get_solvable().significant);
+	}
+
+	/* Other server instances might be compiling the same arena, so publish it atomically. */
+
+	const auto thread_suffix = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	const auto temporary_path = augs::path_type(path).replace_extension(thread_suffix + ".tmp");
+
+	try {
+		augs::create_directories_for(path);
+		augs::bytes_to_file(bytes, temporary_path);
+
+		std::filesystem::rename(temporary_path, path);
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to save the compiled arena %x: %x", path, err.what());
+		augs::remove_file(temporary_path);
+	}
+}
+
+std::size_t remove_stale_compiled_arenas() {
+	const auto build_folder = get_compiled_arenas_build_folder();
+
+	std::size_t num_removed = 0;
+
+	try {
+		if (!augs::exists(COMPILED_ARENAS_DIR)) {
+			return 0;
+		}
+
+		std::vector<augs::path_type> stale;
+
+		augs::for_each_directory_in_directory(
+			COMPILED_ARENAS_DIR,
+			[&](const auto& p) {
+				if (p.filename().string() != build_folder) {
+					stale.push_back(p);
+				}
+
+				return callback_result::CONTINUE;
+			}
+		);
+
+		for (const auto& p : stale) {
+			augs::remove_directory(p);
+			++num_removed;
+		}
+	}
+	catch (const std::exception& err) {
+		LOG("Failed to remove stale compiled arenas: %x", err.what());
+	}
+
+	return num_removed;
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("CompiledArena KeyCoversReadingSettings") {
+	if (::get_compiled_arena_path({}).empty()) {
+		return;
+	}
+
+	auto lenient = compiled_arena_key();
+	lenient.settings.strict = false;
+
+	auto without_inactive = compiled_arena_key();
+	without_inactive.settings.read_inactive_nodes = false;
+
+	const auto default_path = ::get_compiled_arena_path({});
+
+	REQUIRE(::get_compiled_arena_path(lenient) != default_path);
+	REQUIRE(::get_compiled_arena_path(without_inactive) != default_path);
+	REQUIRE(::get_compiled_arena_path(lenient) != ::get_compiled_arena_path(without_inactive));
+}
+#endif
+
+#if BUILD_UNIT_TESTS && BUILD_TEST_SCENES
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/filesystem/temporary_directory.h"
+#include "test_scenes/test_scene_settings.h"
+
+TEST_CASE("CompiledArena Roundtrip") {
+	const auto dir = augs::temporary_directory("compiled_arena");
+	const auto path = dir / "unit_test.bin";
+
+	auto compiled = std::make_unique<intercosm>();
+	compiled->make_test_scene(test_scene_settings());
+
+	const auto compiled_ruleset = all_rulesets_variant(test_mode_ruleset());
+	::save_compiled_arena(path, *compiled, compiled_ruleset);
+
+	auto loaded = std::make_unique<intercosm>();
+	auto loaded_ruleset = all_rulesets_variant();
+
+	REQUIRE(::load_compiled_arena(path, *loaded, loaded_ruleset));
+
+	REQUIRE(loaded_ruleset.index() == compiled_ruleset.index());
+	REQUIRE(augs::to_bytes(loaded->viewables) == augs::to_bytes(compiled->viewables));
+	REQUIRE(augs::to_bytes(loaded->world.get_common_significant()) == augs::to_bytes(compiled->world.get_common_significant()));
+	REQUIRE(augs::to_bytes(loaded->world.get_solvable().significant) == augs::to_bytes(compiled->world.get_solvable().significant));
+
+	{
+		/* A truncated or otherwise corrupted artifact must never be loaded. */
+
+		auto bytes = augs::file_to_bytes(path);
+		bytes.resize(bytes.size() / 2);
+		augs::bytes_to_file(bytes, path);
+
+		REQUIRE(!::load_compiled_arena(path, *loaded, loaded_ruleset));
+	}
+}
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_TEST_SCENES
+#include "augs/internal_benchmarks.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/filesystem/temporary_directory.h"
+#include "test_scenes/test_scene_settings.h"
+
+INTERNAL_BENCHMARK("CompiledArena Load") {
+	const auto dir = augs::temporary_directory("compiled_arena_benchmark");
+	const auto path = dir / "benchmark.bin";
+
+	const int num_trials = 20;
+
+	double build_ms = 0.0;
+	double load_ms = 0.0;
+
+	auto built = std::make_unique<intercosm>();
+	auto loaded = std::make_unique<intercosm>();
+	auto loaded_ruleset = all_rulesets_variant();
+
+	for (int i = 0; i < num_trials; ++i) {
+		{
+			augs::timer t;
+			built->make_test_scene(test_scene_settings());
+			build_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		if (i == 0) {
+			::save_compiled_arena(path, *built, all_rulesets_variant(test_mode_ruleset()));
+		}
+
+		{
+			augs::timer t;
+			::load_compiled_arena(path, *loaded, loaded_ruleset);
+			load_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG(
+		"Test scene of %x entities. Built: %x ms, loaded compiled: %x ms.",
+		built->world.get_entities_count(),
+		build_ms / num_trials,
+		load_ms / num_trials
+	);
+}
+#endif
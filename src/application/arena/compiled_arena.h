@@ -0,0 +1,47 @@
+#pragma once
+#include "augs/filesystem/path.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/network/network_types.h"
+#include "game/modes/all_mode_includes.h"
+#include "application/setups/editor/project/editor_project_readwrite.h"
+
+struct intercosm;
+
+/*
+	A compiled arena lets a map change skip both reading the project json
+	and the whole build_arena_from_editor_project pipeline.
+
+	It is a binary dump of the intercosm and the ruleset exactly as the build has left them.
+	The clean round state is not stored since right after the build it equals the solvable state of the world.
+
+	Artifacts are kept in a cache folder named after the commit the game was built from,
+	in files named after a hash of everything else the build depends on.
+	An edited map or another game version simply never finds an old artifact.
+	The dumped layouts differ between builds that can't be told apart by their commit (unknown or dirty),
+	so such builds never use compiled arenas.
+*/
+
+struct compiled_arena_key {
+	augs::secure_hash_type project_json_hash = augs::secure_hash_type();
+	game_mode_name_type override_game_mode;
+	augs::path_type project_dir;
+
+	/* A lenient read might skip what a strict one would refuse, so they build different arenas. */
+	editor_project_readwrite::reading_settings settings;
+};
+
+/* Empty if this build can't use compiled arenas. */
+augs::path_type get_compiled_arena_path(const compiled_arena_key&);
+
+/*
+	Returns false if there is no valid artifact at the path.
+	The scene might then be left partially loaded.
+*/
+
+bool load_compiled_arena(const augs::path_type& path, intercosm& scene, all_rulesets_variant& ruleset);
+
+/* Failures are only logged, as the arena can always be built again. */
+void save_compiled_arena(const augs::path_type& path, const intercosm& scene, const all_rulesets_variant& ruleset);
+
+/* Removes the artifacts of all other game versions. Returns the number of removed folders. */
+std::size_t remove_stale_compiled_arenas();
@@ -152,6 +152,9 @@ struct config_json_table {
 
 	uint16_t num_ranked_servers = 0;
 	uint16_t num_casual_servers = 0;
+	uint16_t num_server_tick_workers = 0;
+	bool pin_server_tick_workers = true;
+	uint16_t num_server_solve_workers = 0;
 
 	server_vars server;
 	server_private_vars server_private;
@@ -181,6 +181,7 @@ void perform_rcon_gui(
 						}
 
 						do_command_button("Download logs", RS::DOWNLOAD_LOGS); 
+						do_command_button("Dump performance trace", RS::DUMP_PERFORMANCE_TRACE); 
 					}
 					else {
 						text_color("Nothing to maintain on an integrated server!", orange);
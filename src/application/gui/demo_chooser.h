@@ -52,7 +52,9 @@ public:
 				all_paths.clear();
 
 				auto path_adder = [this](const auto& full_path) {
-					if (full_path.extension() != ".demc") {
+					const auto ext = full_path.extension();
+
+					if (ext != ".demi" && ext != ".demc") {
 						return callback_result::CONTINUE;
 					}
 
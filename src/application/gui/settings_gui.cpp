@@ -90,6 +90,10 @@ int performance_settings::get_num_pool_workers() const {
 	return get_default_num_pool_workers();
 }
 
+int performance_settings::get_num_solve_workers() const {
+	return std::max(0, num_solve_workers);
+}
+
 #if BUILD_NATIVE_SOCKETS
 #include "augs/network/netcode_utils.h"
 #include "augs/templates/container_templates.h"
@@ -1475,6 +1479,7 @@ void settings_gui_state::perform(
 					{
 						auto& scope_cfg = config.simulation_receiver;
 						revertable_slider(SCOPE_CFG_NVP(misprediction_smoothing_multiplier), 0.f, 3.f);
+						revertable_slider(SCOPE_CFG_NVP(max_predicted_checkpoints), 0u, 128u);
 					}
 
 					{
@@ -1930,6 +1935,7 @@ void settings_gui_state::perform(
 
 					revertable_slider(SCOPE_CFG_NVP(atlas_blitting_threads), 1u, t_max);
 					revertable_slider(SCOPE_CFG_NVP(neon_regeneration_threads), 1u, t_max);
+					revertable_slider(SCOPE_CFG_NVP(sound_decoding_threads), 1u, t_max);
 				}
 #endif
 
@@ -1971,6 +1977,8 @@ void settings_gui_state::perform(
 						}
 					}
 
+					revertable_slider("Simulation solve workers", scope_cfg.num_solve_workers, 0, concurrency);
+
 					revertable_slider(SCOPE_CFG_NVP(max_particles_in_single_job), 1000, 20000);
 				}
 
@@ -107,6 +107,17 @@ void intercosm::make_test_scene(
 #endif
 }
 
+#if BUILD_TEST_SCENES
+#include "test_scenes/test_scene_fixture.h"
+
+std::unique_ptr<cosmos> make_test_scene_cosmos(const test_scene_settings settings) {
+	auto scene = std::make_unique<intercosm>();
+	scene->make_test_scene(settings);
+
+	return std::make_unique<cosmos>(scene->world);
+}
+#endif
+
 void intercosm::post_load_state_correction() {
 	world.change_common_significant([&](cosmos_common_significant& common) {
 		/*
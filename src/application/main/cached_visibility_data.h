@@ -1,8 +1,29 @@
 #pragma once
+#include <atomic>
+#include <unordered_map>
 #include "game/stateless_systems/visibility_system.h"
 
+/*
+	Visibility of a light that only static bodies were occluding.
+	It is reused for as long as the signature of the request and of the static occluders in range stays the same.
+*/
+
+struct cached_light_visibility {
+	uint64_t signature = 0;
+	bool valid = false;
+	bool used = false;
+
+	visibility_response response;
+};
+
 struct cached_visibility_data {
 	visibility_response fow_response;
-	std::vector<visibility_response> light_responses;
 	std::vector<visibility_request> light_requests;
+
+	std::unordered_map<entity_id, cached_light_visibility> per_light;
+	const cosmos* per_light_cosmos = nullptr;
+
+	/* Counted by the light jobs, so read them only once the jobs are done. */
+	std::atomic<std::size_t> num_reused_lights = 0;
+	std::atomic<std::size_t> num_recalculated_lights = 0;
 };
@@ -0,0 +1,414 @@
+#pragma once
+
+/*
+	Headless load generator for dedicated servers.
+
+	Runs many client_setups in one process, without a window, rendering or audio,
+	against a server given by --connect. Every client walks, aims and shoots at random.
+	The randomness of each step is seeded with the client index and the step number,
+	so that the input does not depend on the frame rate and runs are reproducible.
+
+	Without --connect, the swarm hosts the server itself, on its own thread,
+	so that the step timings can be read from the server's own profiler.
+
+	Periodically reports how many clients made it into the game,
+	the server step timings (or, for a remote server, how fast it steps as observed by the clients),
+	the total bandwidth and the average repredictions.
+*/
+
+struct client_swarm_input {
+	const packaged_official_content& official;
+	client_connect_string connect_string;
+	client_vars vars;
+
+	simulation_receiver_settings simulation_receiver;
+	lag_compensation_settings lag_compensation;
+
+	uint32_t num_clients = 0;
+	double duration_secs = 0.0;
+	double report_once_every_secs = 5.0;
+
+	/* Null if the server is remote. */
+	std::unique_ptr<server_setup> local_server;
+};
+
+struct swarm_server_timings {
+	double step_ms = 0.0;
+	double solve_simulation_ms = 0.0;
+	double advance_clients_state_ms = 0.0;
+	double send_entropies_ms = 0.0;
+	double send_packets_ms = 0.0;
+	double tick_lateness_ms = 0.0;
+	double max_tick_lateness_ms = 0.0;
+	std::size_t num_steps = 0;
+};
+
+/*
+	The profiler is only ever touched by the server thread,
+	which publishes its summary for the reports.
+*/
+
+class swarm_local_server {
+	dedicated_server_worker_input in;
+	const double publish_once_every_secs;
+
+	mutable std::mutex timings_lk;
+	swarm_server_timings timings;
+
+	std::atomic<bool> quit = false;
+	std::thread thread;
+
+	void publish_timings() {
+		auto& profiler = in.server_ptr->profiler;
+		profiler.prepare_summary_info();
+
+		auto new_timings = swarm_server_timings();
+
+		new_timings.step_ms = 1000 * profiler.step.get_summary_info().value;
+		new_timings.solve_simulation_ms = 1000 * profiler.solve_simulation.get_summary_info().value;
+		new_timings.advance_clients_state_ms = 1000 * profiler.advance_clients_state.get_summary_info().value;
+		new_timings.send_entropies_ms = 1000 * profiler.send_entropies.get_summary_info().value;
+		new_timings.send_packets_ms = 1000 * profiler.send_packets.get_summary_info().value;
+		new_timings.tick_lateness_ms = 1000 * profiler.tick_lateness.get_summary_info().value;
+		new_timings.max_tick_lateness_ms = 1000 * profiler.tick_lateness.get_maximum_units();
+		new_timings.num_steps = profiler.step.get_num_measurements();
+
+		std::scoped_lock lock(timings_lk);
+		timings = new_timings;
+	}
+
+	void run() {
+		LOG_THREAD_PREFFIX() = in.instance_log_label;
+
+		dedicated_server_instance instance(in);
+		augs::timer publish_timer;
+
+		while (true) {
+			if (const auto result = instance.advance([this]() { return quit.load(); })) {
+				instance.log_quitting(*result);
+				break;
+			}
+
+			if (publish_timer.get<std::chrono::seconds>() >= publish_once_every_secs) {
+				publish_timer.reset();
+				publish_timings();
+			}
+
+			instance.get_server().sleep_until_next_tick();
+		}
+	}
+
+public:
+	swarm_local_server(std::unique_ptr<server_setup> server, const double publish_once_every_secs) :
+		publish_once_every_secs(publish_once_every_secs)
+	{
+		in.server_ptr = std::move(server);
+		in.instance_label = "swarm";
+		in.instance_log_label = "[server] ";
+
+		thread = std::thread([this]() { run(); });
+	}
+
+	~swarm_local_server() {
+		quit.store(true);
+		thread.join();
+	}
+
+	swarm_server_timings get_timings() const {
+		std::scoped_lock lock(timings_lk);
+		return timings;
+	}
+};
+
+class swarm_client {
+	const uint32_t index;
+
+	uint32_t last_input_step = 0;
+	uint32_t next_movement_change_step = 0;
+	uint32_t next_team_choice_step = 0;
+	bool shooting = false;
+	game_intents held_movement;
+
+public:
+	std::unique_ptr<client_setup> setup;
+
+	network_profiler performance;
+	network_info stats = {};
+	interpolation_system interp;
+	past_infection_system past_infection;
+
+	uint32_t last_reported_step = 0;
+
+	swarm_client(const client_swarm_input& in, const uint32_t index) : index(index) {
+		auto client_vars = in.vars;
+		client_vars.nickname = typesafe_sprintf("swarm%x", index);
+		client_vars.record_demo = false;
+		client_vars.use_account_nickname = false;
+		client_vars.use_account_avatar = false;
+
+		setup = std::make_unique<client_setup>(
+			in.official,
+			in.connect_string,
+			"",
+			client_vars,
+			nat_detection_settings(),
+			port_type(0),
+			std::nullopt,
+			""
+		);
+	}
+
+	uint32_t get_referential_step() const {
+		return setup->get_arena_handle(client_arena_type::REFERENTIAL).get_cosmos().get_total_steps_passed();
+	}
+
+	void generate_entropy() {
+		auto& client = *setup;
+
+		if (!client.is_gameplay_on()) {
+			return;
+		}
+
+		const auto& predicted = client.get_arena_handle(client_arena_type::PREDICTED).get_cosmos();
+		const auto step = predicted.get_total_steps_passed();
+
+		/* Input is chosen once per step, however many frames it takes. */
+
+		if (step == last_input_step) {
+			return;
+		}
+
+		last_input_step = step;
+
+		auto rng = randomization(augs::hash_multiple(index, step));
+
+		auto step_after_secs = [&](const double secs) {
+			return step + static_cast<uint32_t>(secs / predicted.get_fixed_delta().in_seconds<double>());
+		};
+
+		if (!client.get_controlled_character_id().is_set()) {
+			if (step >= next_team_choice_step) {
+				/* DEFAULT lets the mode auto-assign the weakest faction. */
+				client.control(mode_player_entropy(mode_commands::team_choice(faction_type::DEFAULT)));
+				next_team_choice_step = step_after_secs(2.0);
+			}
+
+			return;
+		}
+
+		game_intents new_intents;
+
+		auto set_intent = [&](const game_intent_type type, const bool pressed) {
+			game_intent i;
+			i.intent = type;
+			i.change = pressed ? intent_change::PRESSED : intent_change::RELEASED;
+			new_intents.push_back(i);
+		};
+
+		if (step >= next_movement_change_step) {
+			for (const auto& h : held_movement) {
+				set_intent(h.intent, false);
+			}
+
+			held_movement.clear();
+
+			const game_intent_type directions[] = {
+				game_intent_type::MOVE_FORWARD,
+				game_intent_type::MOVE_BACKWARD,
+				game_intent_type::MOVE_LEFT,
+				game_intent_type::MOVE_RIGHT
+			};
+
+			for (const auto d : directions) {
+				if (rng.randval(0, 2) == 0) {
+					set_intent(d, true);
+					held_movement.push_back(new_intents.back());
+				}
+			}
+
+			next_movement_change_step = step_after_secs(rng.randval(0.3f, 2.0f));
+		}
+
+		if (rng.randval(0, 30) == 0) {
+			shooting = !shooting;
+			set_intent(game_intent_type::SHOOT, shooting);
+		}
+
+		if (!new_intents.empty()) {
+			client.control(new_intents);
+		}
+
+		raw_game_motion motion;
+		motion.motion = game_motion_type::MOVE_CROSSHAIR;
+		motion.offset = basic_vec2<short>(
+			static_cast<short>(rng.randval(-20, 20)),
+			static_cast<short>(rng.randval(-20, 20))
+		);
+
+		client.control(raw_game_motion_vector { motion });
+	}
+};
+
+inline work_result client_swarm_worker(
+	client_swarm_input&& in,
+	std::function<bool()> should_interrupt
+) {
+	std::optional<swarm_local_server> local_server;
+
+	if (in.local_server != nullptr) {
+		LOG("Hosting the server for the swarm at: %x", in.connect_string);
+		local_server.emplace(std::move(in.local_server), in.report_once_every_secs);
+	}
+
+	LOG("Starting a swarm of %x headless clients connecting to: %x", in.num_clients, in.connect_string);
+
+	std::vector<std::unique_ptr<swarm_client>> clients;
+	clients.reserve(in.num_clients);
+
+	for (uint32_t i = 0; i < in.num_clients; ++i) {
+		clients.emplace_back(std::make_unique<swarm_client>(in, i));
+	}
+
+	const auto screen_size = vec2i(1920, 1080);
+	const auto zoom = 1.f;
+
+	augs::timer total_timer;
+	augs::timer report_timer;
+	augs::timer frame_timer;
+
+	auto report = [&]() {
+		const auto report_secs = std::max(report_timer.extract<std::chrono::seconds>(), 0.001);
+
+		std::size_t num_connected = 0;
+		std::size_t num_in_game = 0;
+
+		double total_sent_kbps = 0.0;
+		double total_received_kbps = 0.0;
+		double total_rtt_ms = 0.0;
+		double total_repredicted = 0.0;
+
+		double min_steps_per_sec = std::numeric_limits<double>::max();
+		double total_steps_per_sec = 0.0;
+
+		for (auto& c : clients) {
+			auto& client = *c->setup;
+
+			if (!client.is_connected()) {
+				continue;
+			}
+
+			++num_connected;
+
+			client.update_stats(c->stats);
+
+			total_sent_kbps += c->stats.sent_kbps;
+			total_received_kbps += c->stats.received_kbps;
+			total_rtt_ms += c->stats.rtt_ms;
+
+			if (!client.is_gameplay_on()) {
+				continue;
+			}
+
+			++num_in_game;
+
+			total_repredicted += c->performance.repredicted_steps_per_second.get_average_units();
+
+			const auto step = c->get_referential_step();
+			const auto steps_per_sec = (step - std::min(step, c->last_reported_step)) / report_secs;
+			c->last_reported_step = step;
+
+			min_steps_per_sec = std::min(min_steps_per_sec, steps_per_sec);
+			total_steps_per_sec += steps_per_sec;
+		}
+
+		const auto avg_connected = std::max(num_connected, std::size_t(1));
+		const auto avg_in_game = std::max(num_in_game, std::size_t(1));
+
+		if (num_in_game == 0) {
+			min_steps_per_sec = 0.0;
+		}
+
+		const auto server_timings = [&]() {
+			if (local_server) {
+				const auto t = local_server->get_timings();
+
+				return typesafe_sprintf(
+					"Server (own profiler, %x steps): step %f3 ms (solve %f3, clients %f3, entropies %f3, packets %f3), tick lateness %f3 ms (max %f3)",
+					t.num_steps,
+					t.step_ms,
+					t.solve_simulation_ms,
+					t.advance_clients_state_ms,
+					t.send_entropies_ms,
+					t.send_packets_ms,
+					t.tick_lateness_ms,
+					t.max_tick_lateness_ms
+				);
+			}
+
+			return std::string("Server timings are only in the log of the remote server (log_performance_once_every_secs).");
+		}();
+
+		LOG(
+			"Swarm: %x/%x connected, %x in game.\n"
+			"%x\n"
+			"Server steps/s seen by clients: avg %f2, min %f2\n"
+			"Bandwidth total: sent %f2 kbps, received %f2 kbps\n"
+			"Avg RTT: %f2 ms, avg repredicted steps/s: %f2",
+			num_connected, clients.size(), num_in_game,
+			server_timings,
+			total_steps_per_sec / avg_in_game, min_steps_per_sec,
+			total_sent_kbps, total_received_kbps,
+			total_rtt_ms / avg_connected, total_repredicted / avg_in_game
+		);
+	};
+
+	while (true) {
+		if (should_interrupt()) {
+			LOG("Interrupt was requested.");
+			break;
+		}
+
+		const auto elapsed = total_timer.get<std::chrono::seconds>();
+
+		if (in.duration_secs > 0.0 && elapsed >= in.duration_secs) {
+			LOG("Swarm finished after %x seconds.", in.duration_secs);
+			break;
+		}
+
+		const auto frame_delta = frame_timer.extract_delta();
+
+		for (auto& c : clients) {
+			c->generate_entropy();
+
+			c->setup->advance(
+				{
+					frame_delta,
+					screen_size,
+					input_settings(),
+					zoom,
+					in.simulation_receiver,
+					in.lag_compensation,
+					c->performance,
+					c->stats,
+					c->interp,
+					c->past_infection
+				},
+				solver_callbacks()
+			);
+		}
+
+		if (report_timer.get<std::chrono::seconds>() >= in.report_once_every_secs) {
+			report();
+		}
+
+		augs::sleep(default_inv_tickrate / 4);
+	}
+
+	report();
+
+	for (auto& c : clients) {
+		c->setup->disconnect();
+	}
+
+	return work_result::SUCCESS;
+}
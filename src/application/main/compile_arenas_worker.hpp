@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+	Compiles every arena that a dedicated server might switch to,
+	so that even the first change to each of them only loads the compiled arena.
+
+	These are the arena and game mode from the server vars,
+	along with the cycle list or all arenas on disk if the server cycles through them.
+	Compiled arenas of other game versions are removed first.
+*/
+
+struct compile_arenas_input {
+	const packaged_official_content& official;
+	server_vars vars;
+};
+
+inline work_result compile_arenas_worker(
+	const compile_arenas_input& in,
+	std::function<bool()> should_interrupt
+) {
+	if (::get_compiled_arena_path({}).empty()) {
+		LOG("This build has an unknown or dirty commit, so it can't use compiled arenas. Nothing to compile.");
+		return work_result::FAILURE;
+	}
+
+	if (const auto num_removed = ::remove_stale_compiled_arenas()) {
+		LOG("Removed compiled arenas of %x other game versions.", num_removed);
+	}
+
+	const auto& vars = in.vars;
+
+	std::vector<std::pair<arena_identifier, game_mode_name_type>> rotation;
+
+	auto add = [&](const arena_identifier& arena, const game_mode_name_type& game_mode) {
+		const auto entry = std::make_pair(arena, game_mode);
+
+		if (!arena.empty() && !found_in(rotation, entry)) {
+			rotation.push_back(entry);
+		}
+	};
+
+	auto add_cycled = [&](const arena_identifier& arena, const game_mode_name_type& game_mode) {
+		add(arena, vars.cycle_always_game_mode.empty() ? game_mode : vars.cycle_always_game_mode);
+	};
+
+	add(vars.arena, vars.game_mode);
+
+	if (vars.cycle == arena_cycle_type::LIST) {
+		for (const auto& entry : vars.cycle_list) {
+			add_cycled(::get_first_word(entry), ::get_second_word(entry));
+		}
+	}
+	else if (vars.cycle == arena_cycle_type::ALL_ON_DISK) {
+		for (const auto& root : { OFFICIAL_ARENAS_DIR, DOWNLOADED_ARENAS_DIR, EDITOR_PROJECTS_DIR }) {
+			try {
+				augs::for_each_directory_in_directory(
+					root,
+					[&](const auto& p) {
+						add_cycled(p.filename().string(), game_mode_name_type());
+						return callback_result::CONTINUE;
+					}
+				);
+			}
+			catch (...) {
+
+			}
+		}
+	}
+
+	LOG("Compiling %x arenas.", rotation.size());
+
+	auto scene = std::make_unique<intercosm>();
+	auto clean_round_state = std::make_unique<cosmos_solvable_significant>();
+	all_rulesets_variant ruleset;
+	all_modes_variant current_mode_state;
+	synced_dynamic_vars dynamic_vars;
+
+	auto handle = online_arena_handle<false> {
+		current_mode_state,
+		*scene,
+		scene->world,
+		ruleset,
+		*clean_round_state,
+		dynamic_vars
+	};
+
+	std::size_t num_failed = 0;
+
+	for (const auto& [arena, game_mode] : rotation) {
+		if (should_interrupt()) {
+			LOG("Interrupt was requested.");
+			return work_result::SUCCESS;
+		}
+
+		try {
+			const auto result = ::choose_arena_server({
+				editor_project_readwrite::reading_settings(),
+				handle,
+				in.official,
+				arena,
+				game_mode,
+				*clean_round_state,
+				std::nullopt,
+				nullptr,
+				nullptr
+			});
+
+			if (result.arena_folder_path.empty()) {
+				LOG("Arena not found: %x", arena);
+				++num_failed;
+				continue;
+			}
+
+			LOG("%x %x is ready.", arena, game_mode);
+		}
+		catch (const std::exception& err) {
+			LOG("Failed to compile %x: %x", arena, err.what());
+			++num_failed;
+		}
+	}
+
+	if (num_failed > 0) {
+		LOG("Failed to compile %x of %x arenas.", num_failed, rotation.size());
+		return work_result::FAILURE;
+	}
+
+	return work_result::SUCCESS;
+}
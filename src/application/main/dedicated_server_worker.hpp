@@ -7,94 +7,139 @@ struct dedicated_server_worker_input {
 	std::function<void(server_vars)> write_vars_to_disk;
 	std::string instance_label;
 	std::string instance_log_label;
+	uint16_t num_solve_workers = 0;
 };
 
-inline work_result dedicated_server_worker(
-	const dedicated_server_worker_input& in,
-	std::function<bool()> should_interrupt
-) {
-	auto& server = *in.server_ptr;
+/*
+	A dedicated server instance advanced one batch of due steps at a time,
+	either by its own thread or by the shared server_tick_scheduler.
+*/
 
-	const auto run_result = [&]() {
-		std::future<self_update_result> availability_check;
+class dedicated_server_instance {
+	const dedicated_server_worker_input& in;
 
-		server_network_info server_stats;
-		network_profiler network_performance;
+	std::future<self_update_result> availability_check;
 
-		while (server.is_running()) {
-			const auto zoom = 1.f;
+	server_network_info server_stats;
+	network_profiler network_performance;
 
-			if (should_interrupt()) {
-				LOG("Interrupt was requested.");
-				return work_result::SUCCESS;
-			}
+	std::unique_ptr<augs::thread_pool> solve_pool;
 
-			server.advance(
-				{
-					vec2i(),
-					input_settings(),
-					zoom,
-					nat_detection_result(),
-					network_performance,
-					server_stats
-				},
-				solver_callbacks()
-			);
+public:
+	dedicated_server_instance(const dedicated_server_worker_input& in) : in(in) {
+		if (in.num_solve_workers > 0) {
+			solve_pool = std::make_unique<augs::thread_pool>(in.num_solve_workers);
+		}
+	}
 
-			if (server.should_write_vars_to_disk_once()) {
-				if (in.write_vars_to_disk != nullptr) {
-					in.write_vars_to_disk(server.get_current_vars());
-				}
-			}
+	server_setup& get_server() const {
+		return *in.server_ptr;
+	}
 
-			if (server.should_check_for_updates_once()) {
-				LOG("Launching an async check for updates.");
+	const auto& get_input() const {
+		return in;
+	}
 
-				auto settings = in.self_update;
+	/* Returns the result once the instance should quit. */
+	std::optional<work_result> advance(const std::function<bool()>& should_interrupt) {
+		auto& server = get_server();
 
-				/* Give it a little longer, it's async anyway. */
-				settings.update_connection_timeout_secs = 10;
-				auto appimage_path = in.appimage_path;
+		if (!server.is_running()) {
+			if (server.server_restart_requested()) {
+				return work_result::RELAUNCH_DEDICATED_SERVER;
+			}
+
+			return work_result::SUCCESS;
+		}
 
-				availability_check = launch_async(
-					[appimage_path, settings]() {
-						const bool only_check_update_availability_and_quit = true;
+		const auto zoom = 1.f;
+
+		if (should_interrupt()) {
+			LOG("Interrupt was requested.");
+			return work_result::SUCCESS;
+		}
 
-						return check_and_apply_updates(
-							appimage_path,
-							only_check_update_availability_and_quit,
-							settings
-						);
-					}
-				);
+		server.advance(
+			{
+				vec2i(),
+				input_settings(),
+				zoom,
+				nat_detection_result(),
+				network_performance,
+				server_stats,
+				solve_pool.get()
+			},
+			solver_callbacks()
+		);
+
+		if (server.should_write_vars_to_disk_once()) {
+			if (in.write_vars_to_disk != nullptr) {
+				in.write_vars_to_disk(server.get_current_vars());
 			}
+		}
 
-			if (valid_and_is_ready(availability_check)) {
-				LOG("Finished the async check for updates.");
+		if (server.should_check_for_updates_once()) {
+			LOG("Launching an async check for updates.");
 
-				using update_result = self_update_result_type;
+			auto settings = in.self_update;
 
-				const auto result = availability_check.get();
+			/* Give it a little longer, it's async anyway. */
+			settings.update_connection_timeout_secs = 10;
+			auto appimage_path = in.appimage_path;
 
-				if (result.type == update_result::UPDATE_AVAILABLE) {
-					return work_result::RELAUNCH_AND_UPDATE_DEDICATED_SERVER;
-				}
-				else {
-					LOG("The dedicated server is up to date.");
-				}
-			}
+			availability_check = launch_async(
+				[appimage_path, settings]() {
+					const bool only_check_update_availability_and_quit = true;
 
-			server.sleep_until_next_tick();
+					return check_and_apply_updates(
+						appimage_path,
+						only_check_update_availability_and_quit,
+						settings
+					);
+				}
+			);
 		}
 
-		if (server.server_restart_requested()) {
-			return work_result::RELAUNCH_DEDICATED_SERVER;
+		if (valid_and_is_ready(availability_check)) {
+			LOG("Finished the async check for updates.");
+
+			using update_result = self_update_result_type;
+
+			const auto result = availability_check.get();
+
+			if (result.type == update_result::UPDATE_AVAILABLE) {
+				return work_result::RELAUNCH_AND_UPDATE_DEDICATED_SERVER;
+			}
+			else {
+				LOG("The dedicated server is up to date.");
+			}
 		}
 
-		return work_result::SUCCESS;
+		return std::nullopt;
+	}
+
+	void log_quitting(const work_result result) const {
+		LOG("Quitting %x server instance with: %x", in.instance_label, ::describe_work_result(result));
+	}
+};
+
+inline work_result dedicated_server_worker(
+	const dedicated_server_worker_input& in,
+	std::function<bool()> should_interrupt
+) {
+	dedicated_server_instance instance(in);
+
+	const auto run_result = [&]() {
+		while (true) {
+			if (const auto result = instance.advance(should_interrupt)) {
+				return *result;
+			}
+
+			instance.get_server().sleep_until_next_tick();
+		}
 	}();
 
-	LOG("Quitting %x server instance with: %x", in.instance_label, ::describe_work_result(run_result));
+	instance.log_quitting(run_result);
 
 	return run_result;
 }
@@ -57,6 +57,28 @@ void debug_details_summaries::acquire(
 			make_readable(server_stats.sent_kbps),
 			make_readable(server_stats.received_kbps)
 		);
+
+		if (server_stats.num_direct_downloaders > 0) {
+			this->server_stats += typesafe_sprintf(
+				"Downloaders: %x" "\n"
+				"Chunks/s each: %f2" "\n"
+				"CPU each: %f2 ms/s" "\n",
+				server_stats.num_direct_downloaders,
+				server_stats.file_chunks_per_second_per_downloader,
+				server_stats.file_transfer_cpu_ms_per_downloader
+			);
+		}
+
+		if (server_stats.num_stored_arena_files > 0) {
+			this->server_stats += typesafe_sprintf(
+				"Stored files: %x" "\n"
+				"Uncompressed: %x" "\n"
+				"Compressed: %x" "\n",
+				server_stats.num_stored_arena_files,
+				readable_bytesize(server_stats.stored_arena_files_uncompressed_bytes),
+				readable_bytesize(server_stats.stored_arena_files_compressed_bytes)
+			);
+		}
 	}
 
 	if (network_stats.are_set()) {
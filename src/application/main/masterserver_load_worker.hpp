@@ -0,0 +1,207 @@
+#pragma once
+
+/*
+	Local load generator for the masterserver.
+
+	Simulates many community servers in one process, each heartbeating from its own UDP socket
+	exactly like a server_setup would, with heartbeats spread evenly over the interval.
+	A given fraction of heartbeats changes the player count, so that the list keeps being republished.
+
+	Periodically fetches the JSON server list over HTTP and reports how long it takes
+	to get the full list, a 304 for an unchanged ETag and a delta since the previous report.
+*/
+
+struct masterserver_load_input {
+	netcode_address_t masterserver_address;
+	std::string server_list_url;
+
+	uint32_t num_servers = 0;
+	double duration_secs = 0.0;
+
+	double heartbeat_interval_secs = 10.0;
+	float change_chance = 0.2f;
+	double report_once_every_secs = 5.0;
+};
+
+inline work_result masterserver_load_worker(
+	const masterserver_load_input& in,
+	std::function<bool()> should_interrupt
+) {
+	LOG(
+		"Simulating %x servers heartbeating every %x s to the masterserver at %x. Server list: %x",
+		in.num_servers,
+		in.heartbeat_interval_secs,
+		::ToString(in.masterserver_address),
+		in.server_list_url
+	);
+
+	struct simulated_server {
+		netcode_socket_t socket;
+		server_heartbeat heartbeat;
+		double when_next_heartbeat = 0.0;
+	};
+
+	std::vector<simulated_server> servers;
+	servers.reserve(in.num_servers);
+
+	auto destroy_sockets = augs::scope_guard([&servers]() {
+		for (auto& s : servers) {
+			netcode_socket_destroy(&s.socket);
+		}
+	});
+
+	/* netcode_socket_raii would log every single socket. */
+
+	netcode_address_t bind_address;
+
+	if (netcode_parse_address("0.0.0.0", &bind_address) != NETCODE_OK) {
+		return work_result::FAILURE;
+	}
+
+	const auto start = augs::steady_secs();
+	auto rng = randomization(1);
+
+	for (uint32_t i = 0; i < in.num_servers; ++i) {
+		simulated_server next;
+
+		const auto buf_size = 64 * 1024;
+
+		if (const auto result = netcode_socket_create(&next.socket, &bind_address, buf_size, buf_size); result != NETCODE_SOCKET_ERROR_NONE) {
+			LOG("Could only open %x sockets (error: %x). Raise the limit of open files to simulate more servers.", i, result);
+			break;
+		}
+
+		auto& h = next.heartbeat;
+
+		h.server_name = typesafe_sprintf("Load test %x", i);
+		h.current_arena = "de_cyberaqua";
+		h.game_mode = "bomb_defusal";
+		h.max_online = 10;
+		h.num_online = static_cast<uint8_t>(rng.randval(0, 10));
+		h.suppress_new_community_server_webhook = true;
+		h.server_version = hypersomnia_version().get_version_string();
+
+		next.when_next_heartbeat = start + in.heartbeat_interval_secs * i / in.num_servers;
+
+		servers.emplace_back(std::move(next));
+	}
+
+	if (servers.empty()) {
+		return work_result::FAILURE;
+	}
+
+	auto masterserver_address = in.masterserver_address;
+	auto http = httplib_utils::make_client(in.server_list_url);
+
+	uint64_t num_heartbeats = 0;
+	uint64_t num_changed_heartbeats = 0;
+
+	std::string last_version;
+	auto when_next_report = start + in.report_once_every_secs;
+
+	auto report = [&](const double secs_passed) {
+		const auto heartbeats_per_sec = num_heartbeats / secs_passed;
+		const auto changed_per_sec = num_changed_heartbeats / secs_passed;
+
+		num_heartbeats = 0;
+		num_changed_heartbeats = 0;
+
+		auto timed_get = [&](const std::string& path, const httplib::Headers& headers, double& ms) {
+			augs::timer t;
+			auto result = http->Get(path.c_str(), headers);
+			ms = t.get<std::chrono::milliseconds>();
+			return result;
+		};
+
+		double full_ms = 0.0;
+		double unchanged_ms = 0.0;
+		double delta_ms = 0.0;
+
+		const auto full = timed_get("/server_list_json", {}, full_ms);
+
+		if (!full || full->status != 200) {
+			LOG("Heartbeats: %f2/s (%f2/s changed). Could not fetch the server list.", heartbeats_per_sec, changed_per_sec);
+			return;
+		}
+
+		const auto etag = full->get_header_value("ETag");
+
+		const auto unchanged = timed_get("/server_list_json", { { "If-None-Match", etag } }, unchanged_ms);
+		const auto unchanged_status = unchanged ? unchanged->status : -1;
+
+		std::size_t delta_bytes = 0;
+
+		if (!last_version.empty()) {
+			if (const auto delta = timed_get("/server_list_json?since=" + last_version, {}, delta_ms)) {
+				delta_bytes = delta->body.size();
+			}
+		}
+
+		last_version = etag;
+		erase_if(last_version, [](const char c) { return c == '"'; });
+
+		LOG(
+			"Heartbeats: %f2/s (%f2/s changed). Full list (version %x): %x KB in %f2 ms. Unchanged: %x in %f2 ms. Delta: %x KB in %f2 ms.",
+			heartbeats_per_sec,
+			changed_per_sec,
+			last_version,
+			full->body.size() / 1024,
+			full_ms,
+			unchanged_status,
+			unchanged_ms,
+			delta_bytes / 1024,
+			delta_ms
+		);
+	};
+
+	auto when_last_report = start;
+	const bool timed = in.duration_secs > 0.0;
+
+	while (true) {
+		if (should_interrupt()) {
+			LOG("Interrupt was requested.");
+			break;
+		}
+
+		const auto now = augs::steady_secs();
+
+		if (timed && now - start >= in.duration_secs) {
+			break;
+		}
+
+		for (auto& s : servers) {
+			if (now < s.when_next_heartbeat) {
+				continue;
+			}
+
+			auto& h = s.heartbeat;
+
+			if (rng.randval(0.f, 1.f) < in.change_chance) {
+				h.num_online = static_cast<uint8_t>((h.num_online + 1) % (h.max_online + 1));
+				++num_changed_heartbeats;
+			}
+
+			::netcode_send_to_masterserver(s.socket, masterserver_address, h);
+
+			s.when_next_heartbeat += in.heartbeat_interval_secs;
+			++num_heartbeats;
+		}
+
+		if (now >= when_next_report) {
+			report(now - when_last_report);
+
+			when_last_report = now;
+			when_next_report = now + in.report_once_every_secs;
+		}
+
+		augs::sleep(0.001);
+	}
+
+	LOG("Saying goodbye from %x simulated servers.", servers.size());
+
+	for (auto& s : servers) {
+		::netcode_send_to_masterserver(s.socket, masterserver_address, masterserver_in::goodbye());
+	}
+
+	return work_result::SUCCESS;
+}
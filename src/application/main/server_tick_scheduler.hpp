@@ -0,0 +1,238 @@
+#pragma once
+#include <deque>
+#include <cmath>
+#include <array>
+#include <thread>
+#include <condition_variable>
+
+#if PLATFORM_LINUX
+#include <pthread.h>
+#endif
+
+/*
+	Drives many dedicated server instances from a fixed pool of workers,
+	instead of a separate thread per instance that sleeps on its own.
+
+	A single timer wheel with 1 ms slots wakes up every instance exactly when its next step is due.
+	Ticks of the instances are spread evenly over the tick interval,
+	so that they do not all wake up at once and compete for the same cores.
+
+	How late each step has begun is measured by every server_setup in profiler.tick_lateness.
+*/
+
+struct server_tick_scheduler_input {
+	uint16_t num_workers = 0;
+	bool pin_workers = true;
+};
+
+class server_tick_scheduler {
+	static constexpr double slot_secs = 0.001;
+	static constexpr std::size_t num_slots = 256;
+
+	struct wheel_entry {
+		std::size_t instance_index = 0;
+		uint64_t due_slot = 0;
+	};
+
+	const server_tick_scheduler_input in;
+
+	std::vector<std::unique_ptr<dedicated_server_instance>> instances;
+	std::function<bool()> should_interrupt;
+	std::function<void(work_result)> on_instance_exit;
+
+	std::mutex lk;
+	std::condition_variable ready_cv;
+
+	std::array<std::vector<wheel_entry>, num_slots> wheel;
+	std::deque<std::size_t> ready;
+
+	uint64_t turned_to_slot = 0;
+	std::size_t num_running = 0;
+	bool quit = false;
+
+	static uint64_t slot_of(const net_time_t t) {
+		return static_cast<uint64_t>(std::max(0.0, t) / slot_secs);
+	}
+
+	/* Has to be called under the lock. */
+	void schedule(const std::size_t instance_index, const net_time_t when) {
+		/* Round up so that an instance is never woken before its step is due. */
+		const auto due_slot = static_cast<uint64_t>(std::ceil(std::max(0.0, when) / slot_secs));
+
+		if (due_slot <= turned_to_slot) {
+			ready.push_back(instance_index);
+			ready_cv.notify_one();
+			return;
+		}
+
+		wheel[due_slot % num_slots].push_back({ instance_index, due_slot });
+	}
+
+	/* Has to be called under the lock. */
+	void turn_wheel_to(const uint64_t now_slot) {
+		/* After a long stall, every slot has to be visited only once. */
+		const auto first_slot = std::max(turned_to_slot + 1, now_slot >= num_slots ? now_slot - num_slots + 1 : 0);
+
+		for (auto s = first_slot; s <= now_slot; ++s) {
+			auto& entries = wheel[s % num_slots];
+
+			erase_if(entries, [&](const wheel_entry& e) {
+				if (e.due_slot <= now_slot) {
+					ready.push_back(e.instance_index);
+					return true;
+				}
+
+				return false;
+			});
+		}
+
+		turned_to_slot = std::max(turned_to_slot, now_slot);
+	}
+
+	static void pin_this_thread_to(const unsigned cpu_index) {
+#if PLATFORM_LINUX
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu_index, &cpus);
+
+		if (const auto err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+			LOG("Failed to pin a server tick worker to CPU %x: error %x", cpu_index, err);
+		}
+#else
+		(void)cpu_index;
+#endif
+	}
+
+	void work(const unsigned worker_index) {
+		if (in.pin_workers) {
+			const auto num_cpus = std::max(1u, std::thread::hardware_concurrency());
+			pin_this_thread_to(worker_index % num_cpus);
+		}
+
+		while (true) {
+			std::size_t instance_index = 0;
+
+			{
+				std::unique_lock<std::mutex> lock(lk);
+				ready_cv.wait(lock, [this]() { return quit || !ready.empty(); });
+
+				if (ready.empty()) {
+					return;
+				}
+
+				instance_index = ready.front();
+				ready.pop_front();
+			}
+
+			auto& instance = *instances[instance_index];
+			LOG_THREAD_PREFFIX() = instance.get_input().instance_log_label;
+
+			const auto result = instance.advance(should_interrupt);
+
+			if (result) {
+				instance.log_quitting(*result);
+				on_instance_exit(*result);
+			}
+
+			LOG_THREAD_PREFFIX().clear();
+
+			std::scoped_lock lock(lk);
+
+			if (result) {
+				--num_running;
+			}
+			else {
+				schedule(instance_index, instance.get_server().get_next_tick_time());
+			}
+		}
+	}
+
+public:
+	server_tick_scheduler(
+		const server_tick_scheduler_input& in,
+		std::function<bool()> should_interrupt,
+		std::function<void(work_result)> on_instance_exit
+	) :
+		in(in),
+		should_interrupt(std::move(should_interrupt)),
+		on_instance_exit(std::move(on_instance_exit))
+	{}
+
+	void add(const dedicated_server_worker_input& instance_in) {
+		instances.emplace_back(std::make_unique<dedicated_server_instance>(instance_in));
+	}
+
+	/* Returns once all instances have quit. */
+	void run() {
+		const auto num_instances = instances.size();
+
+		if (num_instances == 0) {
+			return;
+		}
+
+		const auto num_workers = std::clamp(static_cast<std::size_t>(in.num_workers), std::size_t(1), num_instances);
+
+		LOG("Driving %x server instances with %x tick workers%x.", num_instances, num_workers, in.pin_workers ? " pinned to CPUs" : "");
+
+		{
+			std::scoped_lock lock(lk);
+
+			turned_to_slot = slot_of(augs::high_precision_secs());
+			num_running = num_instances;
+
+			for (std::size_t i = 0; i < num_instances; ++i) {
+				auto& server = instances[i]->get_server();
+
+				const auto phase = server.get_inv_tickrate() * i / num_instances;
+				server.delay_next_tick_by(phase);
+
+				schedule(i, server.get_next_tick_time());
+			}
+		}
+
+		std::vector<std::thread> workers;
+		workers.reserve(num_workers);
+
+		for (std::size_t w = 0; w < num_workers; ++w) {
+			workers.emplace_back([this, w]() { work(static_cast<unsigned>(w)); });
+		}
+
+		while (true) {
+			{
+				std::scoped_lock lock(lk);
+
+				if (num_running == 0) {
+					quit = true;
+					break;
+				}
+			}
+
+			const auto next_slot_at = (turned_to_slot + 1) * slot_secs;
+			const auto to_sleep = next_slot_at - augs::high_precision_secs();
+
+			if (to_sleep > 0.0) {
+				augs::sleep(to_sleep);
+			}
+
+			std::scoped_lock lock(lk);
+
+			const auto num_ready_before = ready.size();
+			turn_wheel_to(slot_of(augs::high_precision_secs()));
+
+			const auto num_woken = ready.size() - num_ready_before;
+
+			if (num_woken == 1) {
+				ready_cv.notify_one();
+			}
+			else if (num_woken > 1) {
+				ready_cv.notify_all();
+			}
+		}
+
+		ready_cv.notify_all();
+
+		for (auto& w : workers) {
+			w.join();
+		}
+	}
+};
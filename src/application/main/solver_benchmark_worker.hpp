@@ -0,0 +1,235 @@
+#pragma once
+#include <map>
+#include "application/setups/client/headless_demo_replayer.h"
+#include "3rdparty/rapidjson/include/rapidjson/prettywriter.h"
+
+/*
+	Benchmark of the solver, available in headless builds as well.
+
+	Replays a recorded demo through a headless_demo_replayer as fast as possible.
+	Only the referential cosmos is stepped, exactly like the server did it.
+
+	Writes the steps per second and per-system timings of cosmic_profiler as JSON,
+	along with the hash of the final state so that runs can also be checked for determinism.
+*/
+
+struct solver_benchmark_input {
+	const packaged_official_content& official;
+	augs::path_type demo_path;
+	augs::path_type report_path;
+	lag_compensation_settings lag_compensation;
+};
+
+struct solver_benchmark_measurement {
+	double total = 0.0;
+	double maximum = 0.0;
+	std::size_t num_measurements = 0;
+
+	std::size_t last_seen_count = 0;
+	double last_seen_total = 0.0;
+
+	template <class M>
+	void gather(const M& m) {
+		const auto count = m.get_num_measurements();
+		const auto new_total = static_cast<double>(m.get_total_units());
+
+		/* The cosmos is reassigned whenever the demo loads another arena. */
+
+		if (count > last_seen_count) {
+			total += new_total - last_seen_total;
+			num_measurements += count - last_seen_count;
+			maximum = std::max(maximum, static_cast<double>(m.get_last_measurement_units()));
+		}
+
+		last_seen_count = count;
+		last_seen_total = new_total;
+	}
+
+	double get_average() const {
+		return num_measurements > 0 ? total / num_measurements : 0.0;
+	}
+};
+
+inline work_result solver_benchmark_worker(
+	const solver_benchmark_input& in,
+	std::function<bool()> should_interrupt
+) {
+	LOG("Benchmarking the solver with demo: %x", in.demo_path);
+
+	std::unique_ptr<headless_demo_replayer> replayer;
+
+	try {
+		replayer = std::make_unique<headless_demo_replayer>(in.official, in.demo_path);
+	}
+	catch (const std::exception& err) {
+		LOG("Could not open the demo: %x", err.what());
+		return work_result::FAILURE;
+	}
+
+	const auto total_demo_steps = replayer->get_total_steps();
+
+	std::map<std::string, solver_benchmark_measurement> times;
+	std::map<std::string, solver_benchmark_measurement> amounts;
+
+	uint32_t num_solved_steps = 0;
+
+	auto gather_measurements = [&](const const_logic_step step) {
+		++num_solved_steps;
+
+		step.get_cosmos().profiler.for_each_measurement(
+			[&](const auto& label, const auto& m) {
+				using T = remove_cref<decltype(m)>;
+
+				if constexpr(std::is_same_v<T, augs::time_measurements>) {
+					times[label].gather(m);
+				}
+				else {
+					amounts[label].gather(m);
+				}
+			}
+		);
+	};
+
+	const auto callbacks = solver_callbacks(
+		default_solver_callback(),
+		gather_measurements,
+		default_solver_callback()
+	);
+
+	solve_settings settings;
+	settings.effect_prediction = in.lag_compensation.effect_prediction;
+
+	augs::timer wall_timer;
+
+	while (!replayer->has_finished()) {
+		if (should_interrupt()) {
+			LOG("Interrupt was requested.");
+			return work_result::FAILURE;
+		}
+
+		replayer->advance(callbacks, settings);
+	}
+
+	const auto wall_secs = wall_timer.get<std::chrono::seconds>();
+
+	if (replayer->has_failed()) {
+		LOG("The replay has failed: %x", replayer->get_failure_reason());
+		return work_result::FAILURE;
+	}
+
+	const auto final_state_hash = replayer->get_cosmos().calculate_solvable_signi_hash<uint32_t>();
+	const auto num_desyncs = replayer->get_num_desyncs();
+
+	const auto solver_secs = times["logic"].total;
+
+	auto per_second = [](const double n, const double secs) {
+		return secs > 0.0 ? n / secs : 0.0;
+	};
+
+	rapidjson::StringBuffer s;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+
+	writer.StartObject();
+
+	writer.Key("demo");
+	writer.String(in.demo_path.string().c_str());
+
+	writer.Key("demo_steps");
+	writer.Uint64(total_demo_steps);
+
+	writer.Key("solved_steps");
+	writer.Uint(num_solved_steps);
+
+	writer.Key("wall_secs");
+	writer.Double(wall_secs);
+
+	writer.Key("wall_steps_per_second");
+	writer.Double(per_second(num_solved_steps, wall_secs));
+
+	writer.Key("solver_secs");
+	writer.Double(solver_secs);
+
+	writer.Key("solver_steps_per_second");
+	writer.Double(per_second(num_solved_steps, solver_secs));
+
+	writer.Key("final_state_hash");
+	writer.Uint(final_state_hash);
+
+	writer.Key("desyncs");
+	writer.Uint64(num_desyncs);
+
+	writer.Key("systems");
+	writer.StartObject();
+
+	for (const auto& t : times) {
+		if (t.second.num_measurements == 0) {
+			continue;
+		}
+
+		writer.Key(t.first.c_str());
+		writer.StartObject();
+
+		writer.Key("total_ms");
+		writer.Double(t.second.total * 1000);
+
+		writer.Key("avg_ms");
+		writer.Double(t.second.get_average() * 1000);
+
+		writer.Key("max_ms");
+		writer.Double(t.second.maximum * 1000);
+
+		writer.Key("measurements");
+		writer.Uint64(t.second.num_measurements);
+
+		writer.EndObject();
+	}
+
+	writer.EndObject();
+
+	writer.Key("amounts");
+	writer.StartObject();
+
+	for (const auto& a : amounts) {
+		if (a.second.num_measurements == 0) {
+			continue;
+		}
+
+		writer.Key(a.first.c_str());
+		writer.StartObject();
+
+		writer.Key("avg");
+		writer.Double(a.second.get_average());
+
+		writer.Key("max");
+		writer.Double(a.second.maximum);
+
+		writer.EndObject();
+	}
+
+	writer.EndObject();
+
+	writer.EndObject();
+
+	const auto report = std::string(s.GetString());
+
+	LOG(
+		"Solved %x steps in %f2 s (%f2 steps/s). Solver alone: %f2 s (%f2 steps/s). Final state hash: %x. Desyncs: %x",
+		num_solved_steps,
+		wall_secs,
+		per_second(num_solved_steps, wall_secs),
+		solver_secs,
+		per_second(num_solved_steps, solver_secs),
+		final_state_hash,
+		num_desyncs
+	);
+
+	if (in.report_path.empty()) {
+		LOG("%x", report);
+	}
+	else {
+		augs::save_as_text(in.report_path, report);
+		LOG("Wrote the benchmark report to: %x", in.report_path);
+	}
+
+	return work_result::SUCCESS;
+}
@@ -1,7 +1,6 @@
 #if PLATFORM_UNIX
 #include <csignal>
 #endif
-#include <shared_mutex>
 #include "application/masterserver/masterserver.h"
 #include "3rdparty/include_httplib.h"
 #include "augs/log.h"
@@ -24,7 +23,8 @@
 #include "application/detail_file_paths.h"
 #include "application/setups/server/webhooks.h"
 #include "application/masterserver/server_list_entry_json.h"
-#include "3rdparty/rapidjson/include/rapidjson/prettywriter.h"
+#include "application/masterserver/server_list_publisher.h"
+#include "augs/network/netcode_socket_poller.h"
 #include "augs/readwrite/json_readwrite.h"
 #include "augs/network/netcode_utils.h"
 #include "augs/misc/httplib_utils.h"
@@ -66,7 +66,8 @@ void MSR_LOG(Args&&... args) {
 static void set_cors(httplib::Response& res) {
 	res.set_header("Access-Control-Allow-Origin", "*"); // Allows any domain
 	res.set_header("Access-Control-Allow-Methods", "GET, POST, OPTIONS"); // Allowed methods
-	res.set_header("Access-Control-Allow-Headers", "Origin, X-Requested-With, Content-Type, Accept, Authorization");
+	res.set_header("Access-Control-Allow-Headers", "Origin, X-Requested-With, Content-Type, Accept, Authorization, If-None-Match");
+	res.set_header("Access-Control-Expose-Headers", "ETag");
 };
 
 using ip_to_host = std::unordered_map<
@@ -251,10 +252,12 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 
 	std::unordered_map<netcode_address_t, masterserver_client> server_list;
 
-	std::vector<std::byte> serialized_list;
-	std::string serialized_list_json = "[]";
+	auto list = server_list_publisher(
+		static_cast<uint64_t>(augs::date_time::secs_since_epoch()) * 1000,
+		settings.server_list_kept_removals
+	);
 
-	std::shared_mutex serialized_list_mutex;
+	augs::timer since_last_publish;
 
 	std::unique_ptr<httplib::Server> http_ptr;
 	std::unique_ptr<httplib::Server> fallback_http_ptr;
@@ -282,135 +285,118 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 
 	const auto masterserver_dump_path = USER_DIR / "masterserver.dump";
 
-	auto reserialize_list = [&]() {
-		// MSR_LOG("Reserializing the server list.");
-
-		const auto peer_map = signalling.get_new_peers_map();
-
-		std::lock_guard<std::shared_mutex> lock(serialized_list_mutex);
-
-		serialized_list.clear();
-
-		auto ss = augs::ref_memory_stream(serialized_list);
-
-		for (auto& server : server_list) {
-			const auto address = server.first;
-
-			if (!server.second.last_heartbeat.show_on_server_list) {
-				continue;
-			}
-
-			augs::write_bytes(ss, address);
-			augs::write_bytes(ss, server.second.meta);
-			augs::write_bytes(ss, server.second.last_heartbeat);
+	auto make_json_entry = [&](
+		const server_heartbeat& data,
+		const masterserver_entry_meta meta,
+		const double time_last_heartbeat,
+		const netcode_address_t& ip
+	) -> std::string {
+		server_list_entry_json next;
+
+		next.server_version = data.server_version;
+
+		next.official_url = meta.official_url;
+		next.is_ranked = meta.is_official_server() && data.is_ranked_server();
+		next.is_web_server = meta.type == server_type::WEB;
+		next.name = data.server_name;
+		next.ip = ::ToString(ip);
+		next.webrtc_id = meta.webrtc_id;
+
+		if (!next.webrtc_id.empty()) {
+			next.browser_connect_string = next.webrtc_id;
+		}
+		else {
+			next.browser_connect_string = next.ip;
 		}
 
-		for (auto& server : peer_map) {
-			if (!server.second.is_server()) {
-				continue;
-			}
+		next.time_hosted = meta.time_hosted;
+		next.time_last_heartbeat = time_last_heartbeat;
+		next.arena = data.current_arena;
+		next.game_mode = data.game_mode;
 
-			if (!server.second.last_heartbeat.show_on_server_list) {
-				continue;
-			}
+		next.num_spectating = data.get_num_spectators();
+		next.num_playing = data.num_online - next.num_spectating;
 
-			const auto ip_address = server.second.ip_informational;
+		next.slots = data.max_online;
 
-			masterserver_entry_meta meta;
-			meta.time_hosted = server.second.time_hosted;
-			meta.type = server_type::WEB;
-			meta.webrtc_id = webrtc_id_type(server.first);
+		next.nat = data.nat.type;
 
-			augs::write_bytes(ss, ip_address);
-			augs::write_bytes(ss, meta);
-			augs::write_bytes(ss, server.second.last_heartbeat);
+		if (data.internal_network_address.has_value()) {
+			next.internal_network_address = ::ToString(*data.internal_network_address);
 		}
 
-		rapidjson::StringBuffer s;
-		rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
-
-		writer.StartArray();
-
-		auto write_json_entry = [&](
-			const server_heartbeat& data,
-			const masterserver_entry_meta meta,
-			const double time_last_heartbeat,
-			const netcode_address_t& ip
-		) {
-			server_list_entry_json next;
+		if (data.is_editor_playtesting_server) {
+			next.is_editor_playtesting_server = data.is_editor_playtesting_server;
+		}
 
-			next.server_version = data.server_version;
+		next.score_resistance = data.score_resistance;
+		next.score_metropolis = data.score_metropolis;
 
-			next.official_url = meta.official_url;
-			next.is_ranked = meta.is_official_server() && data.is_ranked_server();
-			next.is_web_server = meta.type == server_type::WEB;
-			next.name = data.server_name;
-			next.ip = ::ToString(ip);
-			next.webrtc_id = meta.webrtc_id;
+		next.players_resistance = data.players_resistance;
+		next.players_metropolis = data.players_metropolis;
+		next.players_spectating = data.players_spectating;
 
-			if (!next.webrtc_id.empty()) {
-				next.browser_connect_string = next.webrtc_id;
+		next.site_displayed_address = [&next]() {
+			if (!next.official_url.empty()) {
+				return next.official_url;
 			}
-			else {
-				next.browser_connect_string = next.ip;
+
+			if (next.is_web_server) {
+				return next.webrtc_id;
 			}
 
-			next.time_hosted = meta.time_hosted;
-			next.time_last_heartbeat = time_last_heartbeat;
-			next.arena = data.current_arena;
-			next.game_mode = data.game_mode;
+			return next.ip;
+		}();
 
-			next.num_spectating = data.get_num_spectators();
-			next.num_playing = data.num_online - next.num_spectating;
+		rapidjson::StringBuffer s;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(s);
 
-			next.slots = data.max_online;
+		augs::write_json(writer, next);
 
-			next.nat = data.nat.type;
+		return s.GetString();
+	};
 
-			if (data.internal_network_address.has_value()) {
-				next.internal_network_address = ::ToString(*data.internal_network_address);
-			}
+	auto make_binary_entry = [](
+		const netcode_address_t& address,
+		const masterserver_entry_meta& meta,
+		const server_heartbeat& heartbeat
+	) {
+		std::vector<std::byte> bytes;
+		auto ss = augs::ref_memory_stream(bytes);
 
-			if (data.is_editor_playtesting_server) {
-				next.is_editor_playtesting_server = data.is_editor_playtesting_server;
-			}
+		augs::write_bytes(ss, address);
+		augs::write_bytes(ss, meta);
+		augs::write_bytes(ss, heartbeat);
 
-			next.score_resistance = data.score_resistance;
-			next.score_metropolis = data.score_metropolis;
+		return bytes;
+	};
 
-			next.players_resistance = data.players_resistance;
-			next.players_metropolis = data.players_metropolis;
-			next.players_spectating = data.players_spectating;
+	/* Only the changed server is serialized again. */
 
-			next.site_displayed_address = [&next]() {
-				if (!next.official_url.empty()) {
-					return next.official_url;
-				}
+	auto publish_server = [&](const netcode_address_t& address) {
+		const auto key = ::ToString(address);
+		const auto entry = mapped_or_nullptr(server_list, address);
 
-				if (next.is_web_server) {
-					return next.webrtc_id;
-				}
+		if (entry == nullptr || !entry->last_heartbeat.show_on_server_list) {
+			list.remove(key);
+			return;
+		}
 
-				return next.ip;
-			}();
+		list.set(
+			key,
+			make_binary_entry(address, entry->meta, entry->last_heartbeat),
+			make_json_entry(entry->last_heartbeat, entry->meta, entry->time_last_heartbeat, address)
+		);
+	};
 
-			augs::write_json(writer, next);
-		};
+	std::unordered_set<std::string> published_web_servers;
 
-		for (const auto& server : server_list) {
-			if (!server.second.last_heartbeat.show_on_server_list) {
-				continue;
-			}
+	auto publish_web_servers = [&]() {
+		const auto peer_map = signalling.get_new_peers_map();
 
-			write_json_entry(
-				server.second.last_heartbeat,
-				server.second.meta,
-				server.second.time_last_heartbeat,
-				server.first
-			);
-		}
+		std::unordered_set<std::string> now_published;
 
-		for (const auto& server : peer_map) {
+		for (auto& server : peer_map) {
 			if (!server.second.is_server()) {
 				continue;
 			}
@@ -419,28 +405,51 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 				continue;
 			}
 
+			const auto ip_address = server.second.ip_informational;
+
 			masterserver_entry_meta meta;
 			meta.time_hosted = server.second.time_hosted;
 			meta.type = server_type::WEB;
 			meta.webrtc_id = webrtc_id_type(server.first);
-			
-			write_json_entry(
-				server.second.last_heartbeat,
-				meta,
-				server.second.time_last_heartbeat,
-				server.second.ip_informational
+
+			const auto key = std::string(meta.webrtc_id);
+
+			list.set(
+				key,
+				make_binary_entry(ip_address, meta, server.second.last_heartbeat),
+				make_json_entry(server.second.last_heartbeat, meta, server.second.time_last_heartbeat, ip_address)
 			);
+
+			now_published.insert(key);
 		}
 
-		writer.EndArray();
+		for (const auto& key : published_web_servers) {
+			if (!found_in(now_published, key)) {
+				list.remove(key);
+			}
+		}
+
+		published_web_servers = std::move(now_published);
+	};
+
+	auto publish_list_if_its_time = [&]() {
+		if (since_last_publish.get<std::chrono::milliseconds>() < settings.server_list_publish_interval_ms) {
+			return;
+		}
 
-		serialized_list_json = s.GetString();
+		if (list.publish_if_changed()) {
+			since_last_publish.reset();
+		}
 	};
 
 	auto dump_server_list_to_file = [&]() {
-		if (!serialized_list.empty()) {
+		list.publish_if_changed();
+
+		const auto snapshot = list.get_snapshot();
+
+		if (!snapshot->binary.empty()) {
 			LOG("Saving servers to %x", masterserver_dump_path);
-			augs::bytes_to_file(std::as_const(serialized_list), masterserver_dump_path);
+			augs::bytes_to_file(snapshot->binary, masterserver_dump_path);
 		}
 		else {
 			LOG("The server list is empty: deleting the dump file.");
@@ -471,7 +480,11 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 				server_list.try_emplace(address, std::move(entry));
 			}
 
-			reserialize_list();
+			for (const auto& server : server_list) {
+				publish_server(server.first);
+			}
+
+			list.publish_if_changed();
 		}
 		catch (const augs::file_open_error& err) {
 			LOG("Could not load the server list file: %x.\nStarting from an empty server list. Details:\n%x", masterserver_dump_path, err.what());
@@ -487,21 +500,9 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 
 	load_server_list_from_file();
 
-	auto make_list_streamer_lambda = [&]() {
-		return [data=serialized_list](uint64_t offset, uint64_t length, DataSink& sink) {
-			return sink.write(reinterpret_cast<const char*>(&data[offset]), length);
-		};
-	};
-
-	auto make_json_list_streamer_lambda = [&]() {
-		return [data=serialized_list_json](uint64_t offset, uint64_t length, DataSink& sink) {
-			return sink.write(reinterpret_cast<const char*>(&data[offset]), length);
-		};
-	};
-
 	auto remove_from_list = [&](const auto& by_external_addr) {
 		server_list.erase(by_external_addr);
-		reserialize_list();
+		publish_server(by_external_addr);
 	};
 
 	struct webhook_job {
@@ -642,37 +643,62 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 		}
 	};
 
-	auto define_http_server = [&](auto& server) {
-		server.Get("/server_list_binary", [&](const Request&, Response& res) {
-			std::shared_lock<std::shared_mutex> lock(serialized_list_mutex);
+	/*
+		Requests only hold the lock for as long as it takes to copy the pointer to the current snapshot.
+		The response streams straight from the snapshot, which stays alive until it is sent.
+	*/
 
-			set_cors(res);
+	auto serve_list = [&list](const Request& req, Response& res, const bool as_json) {
+		const auto snapshot = list.get_snapshot();
 
-			if (serialized_list.size() > 0) {
-				// MSR_LOG("List request arrived. Sending list of size: %x", serialized_list.size());
+		set_cors(res);
+		res.set_header("ETag", snapshot->etag);
 
-				res.set_content_provider(
-					serialized_list.size(),
-					"application/octet-stream",
-					make_list_streamer_lambda()
-				);
+		if (snapshot->matches_etag(req.get_header_value("If-None-Match"))) {
+			res.status = 304;
+			return;
+		}
+
+		if (as_json && req.has_param("since")) {
+			const auto since = std::strtoull(req.get_param_value("since").c_str(), nullptr, 10);
+
+			if (snapshot->can_make_delta_since(since)) {
+				res.set_content(snapshot->make_delta_json(since), "application/json");
+				return;
 			}
-		});
+		}
 
-		server.Get("/server_list_json", [&](const Request&, Response& res) {
-			std::shared_lock<std::shared_mutex> lock(serialized_list_mutex);
+		auto stream = [&](const auto& content, const char* const content_type) {
+			if (content.empty()) {
+				return;
+			}
 
-			set_cors(res);
+			const auto data = reinterpret_cast<const char*>(content.data());
 
-			if (serialized_list_json.size() > 0) {
-				// MSR_LOG("JSON list request arrived. Sending list of size: %x", serialized_list_json.size());
+			res.set_content_provider(
+				content.size(),
+				content_type,
+				[snapshot, data](uint64_t offset, uint64_t length, DataSink& sink) {
+					return sink.write(data + offset, length);
+				}
+			);
+		};
 
-				res.set_content_provider(
-					serialized_list_json.size(),
-					"application/json",
-					make_json_list_streamer_lambda()
-				);
-			}
+		if (as_json) {
+			stream(snapshot->json, "application/json");
+		}
+		else {
+			stream(snapshot->binary, "application/octet-stream");
+		}
+	};
+
+	auto define_http_server = [&](auto& server) {
+		server.Get("/server_list_binary", [&](const Request& req, Response& res) {
+			serve_list(req, res, false);
+		});
+
+		server.Get("/server_list_json", [&](const Request& req, Response& res) {
+			serve_list(req, res, true);
 		});
 
 		server.Options("/server_list_binary", [](const httplib::Request&, httplib::Response& res) {
@@ -716,6 +742,17 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 
 	std::optional<work_result> ms_work_result;
 
+	netcode_socket_poller poller;
+
+	for (const auto& s : udp_command_sockets) {
+		poller.add(s.socket);
+	}
+
+	/* Packets wake the loop at any rate, so housekeeping keeps its own schedule. */
+
+	const auto housekeeping_interval_secs = settings.sleep_ms / 1000.0;
+	auto when_last_housekeeping = 0.0;
+
 	while (true) {
 #if PLATFORM_UNIX
 		if (signal_status != 0) {
@@ -838,7 +875,7 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 							// MSR_LOG("Packet (%x bytes) from %x. New: %x. Heartbeat changed: %x.", packet_bytes, ::ToString(from), is_new_server, heartbeats_mismatch);
 
 							if (is_new_server || heartbeats_mismatch) {
-								reserialize_list();
+								publish_server(from);
 							}
 						}
 						else {
@@ -954,6 +991,7 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 
 			if (timed_out) {
 				LOG("The server at %x (%x) has timed out.", ::ToString(server_entry.first), server_entry.second.last_heartbeat.server_name);
+				list.remove(::ToString(server_entry.first));
 			}
 			else {
 				process_entry_logic(server_entry);
@@ -962,22 +1000,23 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 			return timed_out;
 		};
 
-		const auto previous_size = server_list.size();
-		erase_if(server_list, erase_if_dead);
+		if (current_time - when_last_housekeeping >= housekeeping_interval_secs) {
+			when_last_housekeeping = current_time;
 
-		if (previous_size != server_list.size()) {
-			reserialize_list();
-		}
+			erase_if(server_list, erase_if_dead);
 
-		keep_official_hosts_up_to_date();
+			keep_official_hosts_up_to_date();
+		}
 
 		signalling.send_signalling_packets(send_to_gameserver);
 		signalling.process_timeouts_if_its_time();
 
 		if (signalling.should_reserialize()) {
-			reserialize_list();
+			publish_web_servers();
 		}
 
+		publish_list_if_its_time();
+
 		if (track_rtc_errors) {
 			std::scoped_lock lk(rtc_errors_lk);
 
@@ -993,7 +1032,10 @@ work_result perform_masterserver(const config_json_table& cfg) try {
 			}
 		}
 
-		augs::sleep(settings.sleep_ms / 1000);
+		/* Wakes up as soon as a packet arrives, otherwise when the housekeeping is due. */
+
+		const auto until_housekeeping = when_last_housekeeping + housekeeping_interval_secs - augs::date_time::secs_since_epoch();
+		poller.wait(std::clamp(until_housekeeping, 0.0, housekeeping_interval_secs));
 	}
 
 	LOG("Stopping the HTTP masterserver.");
@@ -24,6 +24,8 @@ struct masterserver_settings {
 	augs::path_type key_pem_path;
 
 	float sleep_ms = 8;
+	unsigned server_list_publish_interval_ms = 100;
+	unsigned server_list_kept_removals = 1024;
 
 	bool report_rtc_errors_to_webhook = false;
 
@@ -0,0 +1,180 @@
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "application/masterserver/server_list_publisher.h"
+
+static std::vector<std::byte> bytes_of(const std::string& s) {
+	std::vector<std::byte> out;
+
+	for (const auto c : s) {
+		out.push_back(static_cast<std::byte>(c));
+	}
+
+	return out;
+}
+
+static bool set_entry(server_list_publisher& list, const std::string& key, const std::string& json) {
+	return list.set(key, bytes_of(json), std::string(json));
+}
+
+TEST_CASE("ServerListPublisher UnchangedListKeepsETag") {
+	auto list = server_list_publisher(1000, 4);
+
+	const auto initial = list.get_snapshot();
+
+	REQUIRE(initial->version == 1000);
+	REQUIRE(initial->json == "[]");
+	REQUIRE(initial->matches_etag("\"1000\""));
+
+	REQUIRE(set_entry(list, "a", "{\"a\":1}"));
+	REQUIRE(list.publish_if_changed());
+
+	const auto first = list.get_snapshot();
+
+	REQUIRE(first->version == 1001);
+	REQUIRE(first->json == "[{\"a\":1}]");
+	REQUIRE(first->binary == bytes_of("{\"a\":1}"));
+	REQUIRE_FALSE(first->matches_etag(initial->etag));
+	REQUIRE(first->matches_etag(first->etag));
+
+	/* Heartbeats that change nothing must not publish, so that polling clients keep getting 304. */
+
+	REQUIRE_FALSE(set_entry(list, "a", "{\"a\":1}"));
+	REQUIRE_FALSE(list.publish_if_changed());
+
+	REQUIRE(list.get_snapshot() == first);
+	REQUIRE(list.get_snapshot()->matches_etag(first->etag));
+
+	/* The ETag is quoted, so neither the bare version nor an empty header matches. */
+
+	REQUIRE_FALSE(first->matches_etag("1001"));
+	REQUIRE_FALSE(first->matches_etag(""));
+}
+
+TEST_CASE("ServerListPublisher DeltaContents") {
+	auto list = server_list_publisher(1000, 4);
+
+	set_entry(list, "a", "{\"a\":1}");
+	set_entry(list, "b", "{\"b\":1}");
+	list.publish_if_changed();
+
+	set_entry(list, "a", "{\"a\":2}");
+	list.publish_if_changed();
+
+	list.remove("b");
+	list.publish_if_changed();
+
+	const auto s = list.get_snapshot();
+
+	REQUIRE(s->version == 1003);
+	REQUIRE(s->json == "[{\"a\":2}]");
+
+	REQUIRE(s->make_delta_json(1000) == "{\"version\":1003,\"updated\":[{\"a\":2}],\"removed\":[\"b\"]}");
+	REQUIRE(s->make_delta_json(1001) == "{\"version\":1003,\"updated\":[{\"a\":2}],\"removed\":[\"b\"]}");
+	REQUIRE(s->make_delta_json(1002) == "{\"version\":1003,\"updated\":[],\"removed\":[\"b\"]}");
+	REQUIRE(s->make_delta_json(1003) == "{\"version\":1003,\"updated\":[],\"removed\":[]}");
+
+	/* Removing what is not there changes nothing. */
+
+	list.remove("b");
+	list.remove("never_added");
+	REQUIRE_FALSE(list.publish_if_changed());
+}
+
+TEST_CASE("ServerListPublisher CanMakeDeltaSince") {
+	auto list = server_list_publisher(1000, 4);
+
+	{
+		const auto s = list.get_snapshot();
+
+		REQUIRE(s->can_make_delta_since(1000));
+		REQUIRE_FALSE(s->can_make_delta_since(999));
+		REQUIRE_FALSE(s->can_make_delta_since(1001));
+		REQUIRE_FALSE(s->can_make_delta_since(0));
+	}
+
+	set_entry(list, "a", "{\"a\":1}");
+	list.publish_if_changed();
+
+	const auto s = list.get_snapshot();
+
+	REQUIRE(s->can_make_delta_since(1000));
+	REQUIRE(s->can_make_delta_since(1001));
+
+	/* A version from the future, e.g. of a restarted masterserver that starts lower. */
+	REQUIRE_FALSE(s->can_make_delta_since(1002));
+}
+
+TEST_CASE("ServerListPublisher TrimmedRemovals") {
+	const std::size_t max_kept_removals = 2;
+	auto list = server_list_publisher(1000, max_kept_removals);
+
+	for (const auto key : { "a", "b", "c", "d" }) {
+		set_entry(list, key, std::string("{\"") + key + "\":1}");
+	}
+
+	list.publish_if_changed();
+
+	list.remove("a");
+	list.publish_if_changed();
+
+	list.remove("b");
+	list.publish_if_changed();
+
+	{
+		const auto s = list.get_snapshot();
+
+		REQUIRE(s->version == 1003);
+		REQUIRE(s->oldest_delta_version == 1000);
+		REQUIRE(s->removals.size() == max_kept_removals);
+		REQUIRE(s->can_make_delta_since(1000));
+		REQUIRE(s->make_delta_json(1000) == "{\"version\":1003,\"updated\":[{\"c\":1},{\"d\":1}],\"removed\":[\"a\",\"b\"]}");
+	}
+
+	/* One removal too many: the removal of "a" is forgotten, so only clients that have already seen it can get a delta. */
+
+	list.remove("c");
+	list.publish_if_changed();
+
+	const auto s = list.get_snapshot();
+
+	REQUIRE(s->version == 1004);
+	REQUIRE(s->removals.size() == max_kept_removals);
+	REQUIRE(s->oldest_delta_version == 1002);
+
+	REQUIRE_FALSE(s->can_make_delta_since(1000));
+	REQUIRE_FALSE(s->can_make_delta_since(1001));
+	REQUIRE(s->can_make_delta_since(1002));
+	REQUIRE(s->can_make_delta_since(1004));
+
+	REQUIRE(s->make_delta_json(1002) == "{\"version\":1004,\"updated\":[],\"removed\":[\"b\",\"c\"]}");
+	REQUIRE(s->make_delta_json(1003) == "{\"version\":1004,\"updated\":[],\"removed\":[\"c\"]}");
+}
+
+TEST_CASE("ServerListPublisher ReaddedKey") {
+	auto list = server_list_publisher(1000, 4);
+
+	set_entry(list, "a", "{\"a\":1}");
+	list.publish_if_changed();
+
+	list.remove("a");
+	list.publish_if_changed();
+
+	REQUIRE_FALSE(list.has("a"));
+	REQUIRE(list.get_snapshot()->make_delta_json(1001) == "{\"version\":1002,\"updated\":[],\"removed\":[\"a\"]}");
+
+	/* A server that comes back must not be reported as both updated and removed. */
+
+	REQUIRE(set_entry(list, "a", "{\"a\":2}"));
+	list.publish_if_changed();
+
+	REQUIRE(list.has("a"));
+	REQUIRE(list.size() == 1);
+
+	const auto s = list.get_snapshot();
+
+	REQUIRE(s->removals.empty());
+	REQUIRE(s->json == "[{\"a\":2}]");
+	REQUIRE(s->make_delta_json(1001) == "{\"version\":1003,\"updated\":[{\"a\":2}],\"removed\":[]}");
+	REQUIRE(s->make_delta_json(1002) == "{\"version\":1003,\"updated\":[{\"a\":2}],\"removed\":[]}");
+}
+#endif
@@ -0,0 +1,231 @@
+#pragma once
+#include <map>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "augs/templates/container_templates.h"
+#include "3rdparty/rapidjson/include/rapidjson/writer.h"
+#include "3rdparty/rapidjson/include/rapidjson/stringbuffer.h"
+
+/*
+	The server list as served over HTTP, updated incrementally.
+
+	Every entry is serialized once, only when the server it describes changes.
+	The complete lists are just concatenated from these pieces,
+	at most once per publish interval no matter how many heartbeats have arrived.
+
+	Every published list has a version which is also its ETag,
+	so a client polling an unchanged list gets an empty 304 response.
+	A client that knows some version can also ask for a delta:
+
+		{ "version": 123, "updated": [ ...entries... ], "removed": [ ...keys... ] }
+
+	Removed entries are identified by the ip of native servers and by the webrtc_id of web servers.
+	If the version is too old to know all removals since, the full list is sent instead.
+*/
+
+struct server_list_snapshot {
+	struct entry {
+		std::string key;
+		uint64_t version = 0;
+		std::shared_ptr<const std::string> json;
+	};
+
+	struct removal {
+		std::string key;
+		uint64_t version = 0;
+	};
+
+	uint64_t version = 0;
+	uint64_t oldest_delta_version = 0;
+
+	std::string etag = "\"0\"";
+
+	std::vector<std::byte> binary;
+	std::string json = "[]";
+
+	std::vector<entry> entries;
+	std::vector<removal> removals;
+
+	/* True if a client sending this If-None-Match already has this very list and should get a 304. */
+	bool matches_etag(const std::string& if_none_match) const {
+		return if_none_match == etag;
+	}
+
+	bool can_make_delta_since(const uint64_t since) const {
+		return since >= oldest_delta_version && since <= version;
+	}
+
+	std::string make_delta_json(const uint64_t since) const {
+		std::string out = "{\"version\":" + std::to_string(version) + ",\"updated\":[";
+
+		bool first = true;
+
+		for (const auto& e : entries) {
+			if (e.version > since) {
+				if (!first) {
+					out += ',';
+				}
+
+				out += *e.json;
+				first = false;
+			}
+		}
+
+		out += "],\"removed\":";
+
+		rapidjson::StringBuffer s;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+		writer.StartArray();
+
+		for (const auto& r : removals) {
+			if (r.version > since) {
+				writer.String(r.key.c_str());
+			}
+		}
+
+		writer.EndArray();
+
+		out += s.GetString();
+		out += '}';
+
+		return out;
+	}
+};
+
+class server_list_publisher {
+	struct published_entry {
+		std::vector<std::byte> binary;
+		std::shared_ptr<const std::string> json;
+		uint64_t version = 0;
+	};
+
+	std::map<std::string, published_entry> entries;
+	std::deque<server_list_snapshot::removal> removals;
+
+	const std::size_t max_kept_removals;
+
+	uint64_t version = 0;
+	uint64_t oldest_delta_version = 0;
+	bool changed = false;
+
+	mutable std::mutex snapshot_lk;
+	std::shared_ptr<const server_list_snapshot> snapshot;
+
+	uint64_t get_pending_version() const {
+		return version + 1;
+	}
+
+public:
+	/*
+		Versions continue from first_version,
+		so that ETags of a restarted masterserver don't collide with the ones clients have cached.
+	*/
+
+	server_list_publisher(const uint64_t first_version, const std::size_t max_kept_removals) :
+		max_kept_removals(max_kept_removals),
+		version(first_version),
+		oldest_delta_version(first_version)
+	{
+		auto initial = std::make_shared<server_list_snapshot>();
+		initial->version = version;
+		initial->oldest_delta_version = oldest_delta_version;
+		initial->etag = "\"" + std::to_string(version) + "\"";
+
+		snapshot = std::move(initial);
+	}
+
+	/* Returns true if the entry was new or has changed. */
+	bool set(const std::string& key, std::vector<std::byte>&& binary, std::string&& json) {
+		auto& e = entries[key];
+
+		if (e.json != nullptr && e.binary == binary && *e.json == json) {
+			return false;
+		}
+
+		if (e.json == nullptr) {
+			erase_if(removals, [&](const auto& r) { return r.key == key; });
+		}
+
+		e.binary = std::move(binary);
+		e.json = std::make_shared<const std::string>(std::move(json));
+		e.version = get_pending_version();
+
+		changed = true;
+		return true;
+	}
+
+	void remove(const std::string& key) {
+		if (entries.erase(key) == 0) {
+			return;
+		}
+
+		removals.push_back({ key, get_pending_version() });
+
+		if (removals.size() > max_kept_removals) {
+			oldest_delta_version = std::max(oldest_delta_version, removals.front().version);
+			removals.pop_front();
+		}
+
+		changed = true;
+	}
+
+	bool has(const std::string& key) const {
+		return entries.find(key) != entries.end();
+	}
+
+	/* Returns true if a new version was published. */
+	bool publish_if_changed() {
+		if (!changed) {
+			return false;
+		}
+
+		changed = false;
+		++version;
+
+		auto next = std::make_shared<server_list_snapshot>();
+
+		next->version = version;
+		next->oldest_delta_version = oldest_delta_version;
+		next->etag = "\"" + std::to_string(version) + "\"";
+
+		next->entries.reserve(entries.size());
+		next->json.clear();
+		next->json += '[';
+
+		for (const auto& [key, e] : entries) {
+			if (!next->entries.empty()) {
+				next->json += ',';
+			}
+
+			next->json += *e.json;
+			next->binary.insert(next->binary.end(), e.binary.begin(), e.binary.end());
+			next->entries.push_back({ key, e.version, e.json });
+		}
+
+		next->json += ']';
+		next->removals.assign(removals.begin(), removals.end());
+
+		std::scoped_lock lock(snapshot_lk);
+		snapshot = std::move(next);
+
+		return true;
+	}
+
+	/* Safe to call from any thread. */
+	std::shared_ptr<const server_list_snapshot> get_snapshot() const {
+		std::scoped_lock lock(snapshot_lk);
+		return snapshot;
+	}
+
+	std::size_t size() const {
+		return entries.size();
+	}
+};
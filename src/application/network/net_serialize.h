@@ -133,6 +133,7 @@ namespace net_messages {
 	template <class Stream>
 	bool serialize(Stream& s, ::file_download_payload& c) {
 		serialize_int(s, c.num_file_bytes, 0, max_direct_download_file_size_v);
+		serialize_int(s, c.num_compressed_bytes, 0, max_direct_download_file_size_v);
 
 		return true;
 	}
@@ -350,6 +351,17 @@ namespace net_messages {
 
 	template <typename Stream>
 	bool serialize(Stream& stream, ::requested_client_settings& payload) {
+		serialize_bits(stream, payload.protocol_version, 32);
+
+		if (Stream::IsReading && payload.protocol_version != game_protocol_version_v) {
+			/* 
+				The rest might be laid out differently.
+				Leave it default so that the server can explain why it rejects the client.
+			*/
+
+			return true;
+		}
+
 		{
 			if (!serialize_fixed_size_str(stream, payload.chosen_nickname)) {
 				return false;
@@ -569,14 +581,12 @@ namespace net_messages {
 	}
 
 	template <class Stream>
-	bool serialize(Stream& s, ::networked_server_step_entropy& total_networked) {
+	bool serialize_shared_step_entropy(Stream& s, ::networked_server_step_entropy& total_networked) {
+		/* Everything except the prestep_client_context, which is the only per-client part. */
+
 		auto& i = total_networked.payload;
 		auto& g = i.general;
 
-		if (!serialize(s, total_networked.context)) {
-			return false;
-		}
-
 		auto& state_hash = total_networked.meta.state_hash;
 		bool has_state_hash = logically_set(state_hash);
 
@@ -592,6 +602,7 @@ namespace net_messages {
 		serialize_bool(s, has_special_command);
 
 		serialize_bool(s, total_networked.meta.reinference_necessary);
+		serialize_bool(s, total_networked.meta.wide_state_hash);
 
 		serialize_align(s);
 
@@ -647,4 +658,13 @@ namespace net_messages {
 
 		return true;
 	}
+
+	template <class Stream>
+	bool serialize(Stream& s, ::networked_server_step_entropy& total_networked) {
+		if (!serialize(s, total_networked.context)) {
+			return false;
+		}
+
+		return serialize_shared_step_entropy(s, total_networked);
+	}
 }
@@ -1,4 +1,7 @@
 #pragma once
+#include "augs/readwrite/delta_compression.h"
+#include "augs/readwrite/stream_read_error.h"
+#include "augs/templates/transform_types.h"
 
 template <class V>
 constexpr bool never_changes_in_game = is_one_of_v<V,
@@ -17,6 +20,26 @@ using physics_bodies_vector = typename physics_bodies::object_pool_type;
 using dynamic_decorations = make_entity_pool<dynamic_decoration>;
 using dynamic_decorations_vector = typename dynamic_decorations::object_pool_type;
 
+template <class E>
+using make_entity_objects_vector = typename make_entity_pool<E>::object_pool_type;
+
+template <class V>
+constexpr bool is_entity_objects_vector_v = is_one_of_list_v<
+	V, 
+	transform_types_in_list_t<all_entity_types, make_entity_objects_vector>
+>;
+
+/*
+	Every entity is written in one of the following ways,
+	depending on how it differs from its correspondent in the clean round state.
+*/
+
+enum class net_entity_encoding : uint8_t {
+	UNCHANGED,
+	FULL,
+	DELTA
+};
+
 struct net_solvable_stream_ref : augs::ref_memory_stream {
 	using base = augs::ref_memory_stream;
 
@@ -45,6 +68,9 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 	template <class V, class NeverChanges>
 	void special_write_if_changed(const V& storage, NeverChanges never_changes_pred) {
 		using E = entity_type_of<typename V::value_type>;
+		using object_type = typename V::value_type;
+
+		static_assert(std::is_trivially_copyable_v<object_type>);
 
 		const auto& body_flavours = flavours.template get_for<E>();
 		const auto& initial_pool = initial_signi.entity_pools.get_for<E>();
@@ -53,37 +79,56 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 		augs::write_bytes(*this, static_cast<uint32_t>(storage.size()));
 
 		for (const auto& s : storage) {
-			const bool never_changes_at_all = never_changes_pred(body_flavours[s.flavour_id]);
 			const auto this_idx = index_in(storage, s);
 			const auto this_id = current_pool.find_nth_id(this_idx);
 
-			const auto has_changed_byte = [&]() -> uint8_t {
-				if (never_changes_at_all) {
-					return 0;
-				}
+			auto write_unchanged = [&]() {
+				augs::write_bytes(*this, net_entity_encoding::UNCHANGED);
+				augs::write_bytes(*this, this_id.to_unversioned());
+			};
 
-				static_assert(std::is_trivially_copyable_v<remove_cref<decltype(s)>>);
+			const auto correspondent_initial = initial_pool.find(this_id);
 
-				if (const auto correspondent_initial = initial_pool.find(this_id)) {
-					if (!std::memcmp(std::addressof(s), correspondent_initial, sizeof(*correspondent_initial))) {
-						return 0;
-					}
-				}
-
-				return 1;
-			}();
-			 
-			augs::write_bytes(*this, has_changed_byte);
-			
-			if (has_changed_byte != 0) {
+			if (correspondent_initial == nullptr) {
+				augs::write_bytes(*this, net_entity_encoding::FULL);
 				augs::write_bytes(*this, s);
+				continue;
 			}
-			else {
-				augs::write_bytes(*this, this_id.to_unversioned());
+
+			const bool unchanged = 
+				never_changes_pred(body_flavours[s.flavour_id])
+				|| !std::memcmp(std::addressof(s), correspondent_initial, sizeof(object_type))
+			;
+
+			if (unchanged) {
+				write_unchanged();
+				continue;
 			}
+
+			/* 
+				Most of the entity usually stays as it was at the beginning of the round,
+				so only send the bytes that differ.
+			*/
+
+			const auto delta = augs::object_delta<object_type>(*correspondent_initial, s);
+
+			if (delta.get_encoded_size() >= sizeof(object_type)) {
+				augs::write_bytes(*this, net_entity_encoding::FULL);
+				augs::write_bytes(*this, s);
+				continue;
+			}
+
+			augs::write_bytes(*this, net_entity_encoding::DELTA);
+			augs::write_bytes(*this, this_id.to_unversioned());
+			delta.write(*this);
 		}
 	}
 
+	template <class V, std::enable_if_t<is_entity_objects_vector_v<V>, int> = 0>
+	void special_write(const V& storage) {
+		special_write_if_changed(storage, [](const auto&) { return false; });
+	}
+
 	void special_write(const physics_bodies_vector& storage) {
 		auto never_changes_pred = [&](const auto& flav) {
 			return 
@@ -102,6 +147,50 @@ struct net_solvable_stream_ref : augs::ref_memory_stream {
 
 		special_write_if_changed(storage, never_changes_pred);
 	}
+
+	/*
+		Split components are encoded per entity as well, against their column in the clean round state.
+		The reader already knows the ids from the slots, so they aren't written again.
+	*/
+
+	template <class P, class C>
+	void special_write_column(const P& pool, const C& column) {
+		using E = entity_type_of<typename P::mapped_type>;
+		using value_type = typename C::value_type;
+
+		static_assert(std::is_trivially_copyable_v<value_type>);
+
+		const auto& initial_pool = initial_signi.entity_pools.get_for<E>();
+
+		for (std::size_t i = 0; i < column.size(); ++i) {
+			const auto& v = column[i];
+			const auto correspondent_initial = initial_pool.find(pool.find_nth_id(static_cast<typename P::used_size_type>(i)));
+
+			if (correspondent_initial == nullptr) {
+				augs::write_bytes(*this, net_entity_encoding::FULL);
+				augs::write_bytes(*this, v);
+				continue;
+			}
+
+			const auto& initial_v = initial_pool.template get_corresponding<value_type>(*correspondent_initial);
+
+			if (!std::memcmp(std::addressof(v), std::addressof(initial_v), sizeof(value_type))) {
+				augs::write_bytes(*this, net_entity_encoding::UNCHANGED);
+				continue;
+			}
+
+			const auto delta = augs::object_delta<value_type>(initial_v, v);
+
+			if (delta.get_encoded_size() >= sizeof(value_type)) {
+				augs::write_bytes(*this, net_entity_encoding::FULL);
+				augs::write_bytes(*this, v);
+				continue;
+			}
+
+			augs::write_bytes(*this, net_entity_encoding::DELTA);
+			delta.write(*this);
+		}
+	}
 };
 
 struct net_solvable_stream_cref : augs::cref_memory_stream {
@@ -126,6 +215,8 @@ struct net_solvable_stream_cref : augs::cref_memory_stream {
 	template <class V>
 	void special_read_static_or_not(V& storage) {
 		using E = entity_type_of<typename V::value_type>;
+		using object_type = typename V::value_type;
+
 		const auto& initial_bodies = initial_signi.entity_pools.get_for<E>();
 
 		using size_type = uint32_t;
@@ -137,22 +228,51 @@ struct net_solvable_stream_cref : augs::cref_memory_stream {
 
 		using unversioned_id_type = typename remove_cref<decltype(initial_bodies)>::unversioned_id_type;
 
+		auto read_initial_into = [&](object_type& into) {
+			unversioned_id_type id;
+			augs::read_bytes(*this, id);
+
+			const auto* const initial = initial_bodies.find(initial_bodies.find_versioned(id));
+
+			if (initial == nullptr) {
+				throw augs::stream_read_error("Entity %x does not exist in the clean round state.", id.indirection_index);
+			}
+
+			into = *initial;
+		};
+
 		for (size_type i = 0; i < n; ++i) {
-			uint8_t has_changed_byte;
-			augs::read_bytes(*this, has_changed_byte);
+			net_entity_encoding encoding;
+			augs::read_bytes(*this, encoding);
 
-			if (has_changed_byte != 0) {
+			if (encoding == net_entity_encoding::FULL) {
 				augs::read_bytes(*this, storage[i]);
 			}
-			else {
-				unversioned_id_type id;
-				augs::read_bytes(*this, id);
+			else if (encoding == net_entity_encoding::UNCHANGED) {
+				read_initial_into(storage[i]);
+			}
+			else if (encoding == net_entity_encoding::DELTA) {
+				read_initial_into(storage[i]);
+
+				const auto delta = augs::object_delta<object_type>(*this);
 
-				storage[i] = initial_bodies[initial_bodies.get_versioned(id)];
+				if (!delta.fits_in_object()) {
+					throw augs::stream_read_error("Entity delta exceeds the entity size.");
+				}
+
+				delta.decode_into(storage[i]);
+			}
+			else {
+				throw augs::stream_read_error("Invalid entity encoding: %x.", static_cast<int>(encoding));
 			}
 		}
 	}
 
+	template <class V, std::enable_if_t<is_entity_objects_vector_v<V>, int> = 0>
+	void special_read(V& storage) {
+		special_read_static_or_not(storage);
+	}
+
 	void special_read(physics_bodies_vector& storage) {
 		special_read_static_or_not(storage);
 	}
@@ -160,6 +280,60 @@ struct net_solvable_stream_cref : augs::cref_memory_stream {
 	void special_read(dynamic_decorations_vector& storage) {
 		special_read_static_or_not(storage);
 	}
+
+	template <class P, class C>
+	void special_read_column(const P& pool, C& column) {
+		using E = entity_type_of<typename P::mapped_type>;
+		using value_type = typename C::value_type;
+
+		const auto& initial_pool = initial_signi.entity_pools.get_for<E>();
+		const auto n = static_cast<std::size_t>(pool.size());
+
+		column.resize(n);
+
+		for (std::size_t i = 0; i < n; ++i) {
+			auto read_initial_into = [&](value_type& into) {
+				const auto id = pool.find_nth_id(static_cast<typename P::used_size_type>(i));
+				const auto* const initial = initial_pool.find(id);
+
+				if (initial == nullptr) {
+					throw augs::stream_read_error("Entity %x does not exist in the clean round state.", id.indirection_index);
+				}
+
+				into = initial_pool.template get_corresponding<value_type>(*initial);
+			};
+
+			net_entity_encoding encoding;
+			augs::read_bytes(*this, encoding);
+
+			if (encoding == net_entity_encoding::FULL) {
+				augs::read_bytes(*this, column[i]);
+			}
+			else if (encoding == net_entity_encoding::UNCHANGED) {
+				read_initial_into(column[i]);
+			}
+			else if (encoding == net_entity_encoding::DELTA) {
+				read_initial_into(column[i]);
+
+				const auto delta = augs::object_delta<value_type>(*this);
+
+				if (!delta.fits_in_object()) {
+					throw augs::stream_read_error("Component delta exceeds the component size.");
+				}
+
+				delta.decode_into(column[i]);
+			}
+			else {
+				throw augs::stream_read_error("Invalid component encoding: %x.", static_cast<int>(encoding));
+			}
+		}
+	}
 };
 
 static_assert(augs::has_special_read_v<net_solvable_stream_cref, dynamic_decorations_vector>);
+static_assert(augs::has_special_read_v<net_solvable_stream_cref, make_entity_objects_vector<controlled_character>>);
+
+using character_rigid_body_column = remove_cref<decltype(std::declval<const make_entity_pool<controlled_character>&>().get_corresponding_array<augs::pool_column<components::rigid_body>>())>;
+
+static_assert(augs::has_special_column_read_v<net_solvable_stream_cref, make_entity_pool<controlled_character>, character_rigid_body_column>);
+static_assert(augs::has_special_column_write_v<net_solvable_stream_ref, make_entity_pool<controlled_character>, character_rigid_body_column>);
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include "3rdparty/yojimbo/include/yojimbo.h"
 #undef write_bytes
 #undef read_bytes
@@ -173,9 +174,108 @@ namespace net_messages {
 
 	//struct initial_steps_correction : only_block_message {};
 
-	struct server_step_entropy : net_message_with_payload<networked_server_step_entropy> {
+	/*
+		Only the prestep_client_context differs between the clients,
+		so the rest of the step is serialized once per step
+		and the same buffer is shared by all outgoing messages.
+	*/
+
+	using preserialized_step_entropy = std::vector<uint8_t>;
+	using shared_step_entropy = std::shared_ptr<const preserialized_step_entropy>;
+
+	inline shared_step_entropy preserialize_step_entropy(const networked_server_step_entropy& entropy) {
+		thread_local std::vector<uint8_t> buffer;
+		buffer.resize(max_message_size_v);
+
+		auto serialized = entropy;
+		auto stream = yojimbo::WriteStream(buffer.data(), static_cast<int>(buffer.size()));
+
+		if (!net_messages::serialize_shared_step_entropy(stream, serialized)) {
+			return nullptr;
+		}
+
+		stream.Flush();
+
+		const auto bytes = buffer.data();
+		const auto num_bytes = static_cast<std::size_t>(stream.GetBytesProcessed());
+
+		return std::make_shared<const preserialized_step_entropy>(bytes, bytes + num_bytes);
+	}
+
+	struct server_step_entropy : yojimbo::Message {
 		static constexpr bool server_to_client = true;
 		static constexpr bool client_to_server = false;
+
+		networked_server_step_entropy payload;
+		shared_step_entropy preserialized;
+
+		template <typename Stream>
+		bool Serialize(Stream& stream) {
+			if (!net_messages::serialize(stream, payload.context)) {
+				return false;
+			}
+
+			if (Stream::IsWriting && preserialized == nullptr) {
+				/* E.g. when recording a demo out of a received message. */
+				preserialized = preserialize_step_entropy(payload);
+
+				if (preserialized == nullptr) {
+					return false;
+				}
+			}
+
+			int length = 0;
+
+			if (Stream::IsWriting) {
+				length = static_cast<int>(preserialized->size());
+			}
+
+			serialize_int(stream, length, 0, static_cast<int>(max_message_size_v));
+
+			if (Stream::IsWriting) {
+				serialize_bytes(stream, const_cast<uint8_t*>(preserialized->data()), length);
+				return true;
+			}
+
+			/* ReadStream requires the buffer size to be a multiple of 4. */
+			thread_local std::vector<uint8_t> buffer;
+			buffer.assign(((length + 3) / 4) * 4, 0);
+
+			serialize_bytes(stream, buffer.data(), length);
+
+			auto shared_stream = yojimbo::ReadStream(buffer.data(), static_cast<int>(buffer.size()));
+			return net_messages::serialize_shared_step_entropy(shared_stream, payload);
+		}
+
+		inline bool read_payload(
+			networked_server_step_entropy& output
+		) {
+			output = std::move(payload);
+			return true;
+		}
+
+		inline bool write_payload(
+			const networked_server_step_entropy& input
+		) {
+			payload = input;
+			preserialized = nullptr;
+			return true;
+		}
+
+		inline bool write_payload(
+			const prestep_client_context& context,
+			const shared_step_entropy& shared
+		) {
+			if (shared == nullptr) {
+				return false;
+			}
+
+			payload.context = context;
+			preserialized = shared;
+			return true;
+		}
+
+		YOJIMBO_MESSAGE_BOILERPLATE();
 	};
 
 	struct client_entropy : net_message_with_payload<total_client_entropy> {
@@ -37,6 +37,9 @@ struct requested_client_settings {
 	uint8_t welcome_type = 0;
 	// END GEN INTROSPECTOR
 
+	/* Not a setting - always the version this build speaks. */
+	uint32_t protocol_version = game_protocol_version_v;
+
 	client_welcome_type get_welcome_type() const {
 		return static_cast<client_welcome_type>(welcome_type);
 	}
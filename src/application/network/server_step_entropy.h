@@ -88,10 +88,15 @@ struct server_step_entropy_meta {
 	// GEN INTROSPECTOR struct server_step_entropy_meta
 	std::optional<uint32_t> state_hash;
 	bool reinference_necessary = false;
+	bool wide_state_hash = false;
 	// END GEN INTROSPECTOR
 
 	bool operator==(const server_step_entropy_meta& b) const {
-		return state_hash == b.state_hash && reinference_necessary == b.reinference_necessary;
+		return 
+			state_hash == b.state_hash 
+			&& reinference_necessary == b.reinference_necessary
+			&& wide_state_hash == b.wide_state_hash
+		;
 	}
 };
 
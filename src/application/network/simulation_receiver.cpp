@@ -1,3 +1,4 @@
+#include "augs/misc/pool/pool_io.hpp"
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/entity_handle.h"
 
@@ -144,3 +145,71 @@ void simulation_receiver::drag_mispredictions_into_past(
 		);
 	}
 }
+
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_TEST_SCENES
+#include "augs/internal_benchmarks.h"
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/streaming_hasher.h"
+#include "augs/misc/readable_bytesize.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/byte_readwrite.h"
+#include "test_scenes/test_scene_fixture.h"
+
+INTERNAL_BENCHMARK("SimulationReceiver PredictedCheckpoints") {
+	/*
+		Per predicted step, the client saves a checkpoint of the predicted state.
+		Compares a checkpoint of the old kind (a serialized copy of the state) with a digest,
+		and both with the cost of re-simulating the step that a reused checkpoint spares.
+	*/
+
+	const auto scene = make_test_scene_cosmos();
+
+	auto& cosm = *scene;
+
+	const int num_steps = 300;
+
+	double copy_ms = 0.0;
+	double digest_ms = 0.0;
+	double step_ms = 0.0;
+
+	std::vector<std::byte> copied_state;
+
+	for (int i = 0; i < num_steps; ++i) {
+		{
+			augs::timer t;
+			advance_test_scene(cosm, 1);
+			step_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+
+			copied_state.clear();
+			auto s = augs::ref_memory_stream(copied_state);
+			augs::write_bytes(s, cosm.get_solvable().significant);
+
+			copy_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+
+			augs::streaming_hasher hasher;
+			augs::write_bytes(hasher, cosm.get_solvable().significant);
+			(void)hasher.finalize<augs::secure_hash_type>();
+
+			digest_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG(
+		"Predicted checkpoint of %x entities (%x). Copy: %x ms, digest: %x ms, re-simulated step: %x ms (avg. per step).",
+		cosm.get_entities_count(),
+		readable_bytesize(copied_state.size()),
+		copy_ms / num_steps,
+		digest_ms / num_steps,
+		step_ms / num_steps
+	);
+}
+#endif
@@ -5,6 +5,9 @@
 
 #include "augs/network/jitter_buffer.h"
 #include "augs/templates/logically_empty.h"
+#include "augs/readwrite/byte_readwrite.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/misc/streaming_hasher.h"
 #include "game/cosmos/cosmic_functions.h"
 
 #include "view/audiovisual_state/systems/interpolation_system.h"
@@ -29,6 +32,55 @@ struct steps_unpacking_result {
 	bool malicious_server = false;
 	bool desync = false;
 	std::size_t total_accepted = static_cast<std::size_t>(-1);
+
+	std::size_t num_repredicted_steps = 0;
+	std::size_t num_reused_predicted_steps = 0;
+};
+
+/* Resolves the players of a received entropy with the referential arena and the synced player settings. */
+
+template <class A, class M>
+server_step_entropy unpack_server_entropy(
+	const A& referential_arena,
+	const M& player_metas,
+	const compact_server_step_entropy& entropy
+) {
+	auto mode_id_to_entity_id = [&](const mode_player_id& mode_id) {
+		return referential_arena.on_mode(
+			[&](const auto& typed_mode) {
+				return typed_mode.lookup(mode_id);
+			}
+		);
+	};
+
+	auto get_settings_for = [&](const mode_player_id& mode_id) {
+		return player_metas[mode_id.value].synced.public_settings.character_input;
+	};
+
+	return entropy.unpack(mode_id_to_entity_id, get_settings_for);
+}
+
+struct referential_step_result {
+	server_step_entropy entropy;
+	bool reinferred = false;
+	bool desync = false;
+};
+
+/*
+	Digest of the predicted arena's state (solvable and mode) right after the given step.
+
+	If the referential arena later arrives at a state of the same digest at the same step,
+	every predicted step after the checkpoint is still valid and needs no re-simulation.
+
+	The state is streamed straight into the hasher,
+	so a checkpoint is never a copy of the state and saving one allocates nothing.
+*/
+
+struct predicted_checkpoint {
+	using step_type = decltype(augs::stepped_timestamp::step);
+
+	step_type step = static_cast<step_type>(-1);
+	augs::secure_hash_type digest = {};
 };
 
 class simulation_receiver {
@@ -69,6 +121,53 @@ private:
 		const cosmos& predicted_arena
 	);
 
+	std::vector<predicted_checkpoint> predicted_checkpoints;
+	std::size_t next_checkpoint_index = 0;
+
+	template <class A>
+	static auto calc_checkpoint_digest(const A& arena) {
+		augs::streaming_hasher hasher;
+
+		augs::write_bytes(hasher, arena.get_cosmos().get_solvable().significant);
+		augs::write_bytes(hasher, arena.current_mode_state);
+
+		return hasher.template finalize<augs::secure_hash_type>();
+	}
+
+	const predicted_checkpoint* find_predicted_checkpoint(const predicted_checkpoint::step_type step) const {
+		for (const auto& c : predicted_checkpoints) {
+			if (c.step == step) {
+				return std::addressof(c);
+			}
+		}
+
+		return nullptr;
+	}
+
+	template <class A>
+	bool predicted_timeline_still_valid(const A& referential_arena, const A& predicted_arena) {
+		const auto& referential_cosmos = referential_arena.get_cosmos();
+		const auto& predicted_cosmos = predicted_arena.get_cosmos();
+
+		const auto referential_step = referential_cosmos.get_total_steps_passed();
+		const auto predicted_step = predicted_cosmos.get_total_steps_passed();
+
+		/* 
+			If the server accepted a different number of commands than we have sent,
+			the predicted steps no longer line up with the referential ones.
+		*/
+
+		if (predicted_step != referential_step + predicted_entropies.size()) {
+			return false;
+		}
+
+		if (const auto checkpoint = find_predicted_checkpoint(referential_step)) {
+			return calc_checkpoint_digest(referential_arena) == checkpoint->digest;
+		}
+
+		return false;
+	}
+
 public:
 
 	struct incoming_entropy_entry {
@@ -95,6 +194,36 @@ public:
 	void clear() {
 		clear_incoming();
 		predicted_entropies.clear();
+		clear_predicted_checkpoints();
+	}
+
+	void clear_predicted_checkpoints() {
+		predicted_checkpoints.clear();
+		next_checkpoint_index = 0;
+	}
+
+	template <class A>
+	void save_predicted_checkpoint(
+		const simulation_receiver_settings& settings,
+		const A& predicted_arena
+	) {
+		const auto max_checkpoints = static_cast<std::size_t>(settings.max_predicted_checkpoints);
+
+		if (max_checkpoints == 0) {
+			clear_predicted_checkpoints();
+			return;
+		}
+
+		if (predicted_checkpoints.size() != max_checkpoints) {
+			predicted_checkpoints.resize(max_checkpoints);
+			next_checkpoint_index = 0;
+		}
+
+		auto& checkpoint = predicted_checkpoints[next_checkpoint_index];
+		checkpoint.step = predicted_arena.get_cosmos().get_total_steps_passed();
+		checkpoint.digest = calc_checkpoint_digest(predicted_arena);
+
+		next_checkpoint_index = (next_checkpoint_index + 1) % max_checkpoints;
 	}
 
 	void acquire_next_dynamic_vars(
@@ -121,6 +250,143 @@ public:
 		}
 	}
 
+	/*
+		Steps the referential arena with a single entropy received from the server,
+		exactly as the server has stepped its own arena.
+		Used both when playing online and when replaying demos without any prediction.
+	*/
+
+	template <class F, class A, class S>
+	referential_step_result advance_referential_by(
+		const incoming_entropy_entry& actual_server_step,
+		const entity_id locally_controlled_entity,
+		synced_dynamic_vars& sv_dynamic_vars,
+		F&& unpack_entropy,
+		A& referential_arena,
+		S&& advance_referential
+	) const {
+		referential_step_result result;
+
+		const auto& referential_cosmos = referential_arena.get_cosmos();
+		const auto& meta = actual_server_step.meta;
+
+		if (const auto received_hash = meta.state_hash) {
+#if TEST_DESYNC_DETECTION
+			auto total = referential_cosmos.get_total_steps_passed();
+			bool simulate_desync = false;
+
+			for (auto i = total; i < total + 1; ++i) {
+				if (i % (128 * 6) == 0) {
+					simulate_desync = true;
+				}
+			}
+
+			if (simulate_desync) {
+				const auto it = referential_arena.get_cosmos()[locally_controlled_entity];
+
+				if (it) {
+					LOG("Altering the state for a test.");
+					auto& s = it.template get<components::sentience>();
+					s.template get<health_meter_instance>().maximum += 1.f;
+				}
+				else {
+					LOG("Looks like controlled entity is dead!");
+				}
+			}
+#endif
+
+			const auto client_state_hash = 
+				referential_cosmos.template calculate_solvable_signi_hash<uint32_t>(meta.wide_state_hash)
+			;
+
+			const auto step_number = referential_cosmos.get_total_steps_passed();
+
+			if (*received_hash != client_state_hash) {
+				LOG(
+					"Client desynchronized at step: %x. Hashes differ.\nExpected: %x\nActual: %x\n",
+					step_number,
+					*received_hash,
+					client_state_hash
+				);
+
+				result.desync = true;
+			}
+		}
+
+		/* If a new player was added, always reinfer. */
+		result.reinferred = meta.reinference_necessary || logically_set(actual_server_step.payload.general.added_player);
+
+		if (result.reinferred) {
+			LOG("Added player in the next entropy. Will reinfer to sync.");
+			cosmic::reinfer_solvable(referential_arena.get_cosmos());
+		}
+
+		result.entropy = unpack_entropy(actual_server_step.payload);
+
+		if (const auto& new_dynamic_vars = actual_server_step.new_dynamic_vars) {
+			sv_dynamic_vars = *new_dynamic_vars;
+
+			LOG(
+				"New synced_dynamic_vars. Step: %x, Run ranked logic: %x, FF: %x; preassigned teams: %x %x", 
+				referential_arena.get_cosmos().get_total_steps_passed(),
+				sv_dynamic_vars.is_ranked_server(),
+				sv_dynamic_vars.friendly_fire,
+				sv_dynamic_vars.preassigned_factions,
+				sv_dynamic_vars.all_assigned_present
+			);
+		}
+
+		advance_referential(result.entropy);
+
+		(void)locally_controlled_entity;
+
+		return result;
+	}
+
+	/* Steps the referential arena with everything received so far, with no predicted arena to correct. */
+
+	template <class F, class A, class S>
+	steps_unpacking_result unpack_referential_steps(
+		synced_dynamic_vars& sv_dynamic_vars,
+		F&& unpack_entropy,
+		A& referential_arena,
+		S&& advance_referential
+	) {
+		steps_unpacking_result result;
+
+		auto& contexts = incoming_contexts;
+		auto& entropies = incoming_entropies;
+
+		ensure_geq(contexts.size(), entropies.size());
+
+		if (contexts.size() - entropies.size() >= 2) {
+			result.malicious_server = true;
+			return result;
+		}
+
+		for (const auto& actual_server_step : entropies) {
+			const auto stepped = advance_referential_by(
+				actual_server_step,
+				entity_id(),
+				sv_dynamic_vars,
+				unpack_entropy,
+				referential_arena,
+				advance_referential
+			);
+
+			if (stepped.desync) {
+				result.desync = true;
+			}
+		}
+
+		result.total_accepted = entropies.size();
+
+		erase_first_n(contexts, entropies.size());
+		entropies.clear();
+
+		return result;
+	}
+
 	template <class F, class A, class S1, class S2>
 	steps_unpacking_result unpack_deterministic_steps(
 		const simulation_receiver_settings& settings,
@@ -166,108 +432,37 @@ public:
 			auto num_total_accepted_entropies = static_cast<std::size_t>(0);
 
 			for (std::size_t i = 0; i < entropies.size(); ++i) {
-				/* If a new player was added, always reinfer. */
 				const auto& actual_server_step = entropies[i];
 
-				const auto& referential_cosmos = referential_arena.get_cosmos();
-
-				const auto& meta = actual_server_step.meta;
-
-				{
-					const auto received_hash = meta.state_hash;
-
-					if (received_hash.has_value()) {
-#if TEST_DESYNC_DETECTION
-						auto total = referential_cosmos.get_total_steps_passed();
-						bool simulate_desync = false;
-
-						for (auto i = total; i < total + 1; ++i) {
-							if (i % (128 * 6) == 0) {
-								simulate_desync = true;
-							}
-						}
-
-						if (simulate_desync) {
-							const auto it = referential_arena.get_cosmos()[locally_controlled_entity];
-
-							if (it) {
-								LOG("Altering the state for a test.");
-								auto& s = it.template get<components::sentience>();
-								s.template get<health_meter_instance>().maximum += 1.f;
-							}
-							else {
-								LOG("Looks like controlled entity is dead!");
-							}
-						}
-#endif
-
-						const auto client_state_hash = 
-							referential_cosmos.template calculate_solvable_signi_hash<uint32_t>()
-						;
-
-						const auto step_number = referential_cosmos.get_total_steps_passed();
-
-						if (*received_hash != client_state_hash) {
-							LOG(
-								"Client desynchronized at step: %x. Hashes differ.\nExpected: %x\nActual: %x\n",
-								step_number,
-							   	*received_hash,
-							   	client_state_hash
-							);
+				const auto stepped = advance_referential_by(
+					actual_server_step,
+					locally_controlled_entity,
+					sv_dynamic_vars,
+					unpack_entropy,
+					referential_arena,
+					advance_referential
+				);
 
-							result.desync = true;
-						}
-					}
+				if (stepped.desync) {
+					result.desync = true;
 				}
 
-				{
-					const bool shall_reinfer = meta.reinference_necessary || logically_set(actual_server_step.payload.general.added_player);
-
-					if (shall_reinfer) {
-						LOG("Added player in the next entropy. Will reinfer to sync.");
-						cosmic::reinfer_solvable(referential_arena.get_cosmos());
-					}
+				const bool already_found_reason_to_repredict = repredict;
 
+				if (!already_found_reason_to_repredict) {
+					if (num_total_accepted_entropies < predicted_entropies.size())
 					{
-						const auto& actual_server_entropy = unpack_entropy(actual_server_step.payload);
-
-						{
-							const auto& new_dynamic_vars = actual_server_step.new_dynamic_vars;
-
-							if (new_dynamic_vars.has_value()) {
-								sv_dynamic_vars = *new_dynamic_vars;
-
-								LOG(
-									"New synced_dynamic_vars. Step: %x, Run ranked logic: %x, FF: %x; preassigned teams: %x %x", 
-									referential_arena.get_cosmos().get_total_steps_passed(),
-									sv_dynamic_vars.is_ranked_server(),
-									sv_dynamic_vars.friendly_fire,
-									sv_dynamic_vars.preassigned_factions,
-									sv_dynamic_vars.all_assigned_present
-								);
-							}
-						}
-
-						advance_referential(actual_server_entropy);
-
-						const bool already_found_reason_to_repredict = repredict;
+						const auto& predicted_server_entropy = predicted_entropies[num_total_accepted_entropies];
 
-						if (!already_found_reason_to_repredict) {
-							if (num_total_accepted_entropies < predicted_entropies.size())
-							{
-								const auto& predicted_server_entropy = predicted_entropies[num_total_accepted_entropies];
-
-								if (shall_reinfer || !(actual_server_entropy == predicted_server_entropy)) {
-									repredict = true;
-								}
-							}
-							else
-							{
-								LOG("The client has fallen back behind the server. Repredicting the world just in case.");
-								repredict = true;
-							}
+						if (stepped.reinferred || !(stepped.entropy == predicted_server_entropy)) {
+							repredict = true;
 						}
 					}
+					else
+					{
+						LOG("The client has fallen back behind the server. Repredicting the world just in case.");
+						repredict = true;
+					}
 				}
 
 				{
@@ -303,6 +498,16 @@ public:
 		}
 
 #if USE_CLIENT_PREDICTION
+		if (repredict && predicted_timeline_still_valid(referential_arena, predicted_arena)) {
+			/*
+				The referential arena has arrived at exactly the state we have predicted,
+				so the predicted arena is already the result of re-simulating all predicted entropies.
+			*/
+
+			repredict = false;
+			result.num_reused_predicted_steps = predicted_entropies.size();
+		}
+
 		if (repredict) {
 			auto& predicted_cosmos = predicted_arena.get_cosmos();
 
@@ -315,7 +520,21 @@ public:
 
 			predicted_arena.transfer_all_solvables(referential_arena);
 
-			for (auto& predicted_step_entropy : predicted_entropies) {
+			/* Checkpoints of the previous timeline are no longer valid. */
+			clear_predicted_checkpoints();
+
+			/*
+				The ring only ever holds the newest checkpoints,
+				so don't hash the steps whose checkpoints would be overwritten before the loop ends.
+			*/
+
+			const auto num_predicted = predicted_entropies.size();
+			const auto max_checkpoints = static_cast<std::size_t>(settings.max_predicted_checkpoints);
+			const auto first_checkpointed = num_predicted > max_checkpoints ? num_predicted - max_checkpoints : 0;
+
+			for (std::size_t i = 0; i < num_predicted; ++i) {
+				auto& predicted_step_entropy = predicted_entropies[i];
+
 				predict_intents_of_remote_entities(
 					predicted_step_entropy,
 					locally_controlled_entity, 
@@ -323,8 +542,14 @@ public:
 				);
 
 				advance_predicted(predicted_step_entropy);
+
+				if (i >= first_checkpointed) {
+					save_predicted_checkpoint(settings, predicted_arena);
+				}
 			}
 
+			result.num_repredicted_steps = predicted_entropies.size();
+
 			::restore_interpolations(transfer_caches, predicted_cosmos);
 
 			drag_mispredictions_into_past(
@@ -16,6 +16,7 @@ struct performance_settings {
 	special_effects_settings special_effects;
 	int max_particles_in_single_job = 2500;
 	augs::maybe<int> custom_num_pool_workers = augs::maybe<int>(0, false);
+	int num_solve_workers = 1;
 	accuracy_type wall_light_drawing_precision = accuracy_type::EXACT;
 	swap_buffers_moment swap_window_buffers_when = swap_buffers_moment::AFTER_HELPING_LOGIC_THREAD;
 	// END GEN INTROSPECTOR
@@ -24,4 +25,6 @@ struct performance_settings {
 
 	int get_num_pool_workers() const;
 	static int get_default_num_pool_workers();
+
+	int get_num_solve_workers() const;
 };
@@ -21,9 +21,12 @@ struct network_profiler : public augs::profiler_mixin<network_profiler> {
 	// GEN INTROSPECTOR struct network_profiler
 	augs::amount_measurements<std::size_t> predicted_steps = 1;
 	augs::amount_measurements<std::size_t> accepted_commands = 1;
+	augs::amount_measurements<std::size_t> repredicted_steps_per_second = 1;
+	augs::amount_measurements<std::size_t> reused_predicted_steps_per_second = 1;
 
 	augs::time_measurements unpacking_remote_steps;
 	augs::time_measurements stepping_forward;
+	augs::time_measurements saving_predicted_checkpoints;
 	augs::time_measurements sending_messages;
 	augs::time_measurements sending_packets;
 	augs::time_measurements receiving_messages;
@@ -1,7 +1,44 @@
 #pragma once
+#include <map>
 #include "application/gui/client/demo_player_gui.h"
+#include "application/setups/client/client_vars.h"
+#include "application/setups/client/indexed_demo.h"
 #include "augs/misc/timing/fixed_delta_timer.h"
 
+/*
+	Compressed client state after the first N demo steps.
+	Seeking restores the nearest earlier keyframe
+	and only replays the steps that remain.
+
+	A keyframe holds everything the replayed server messages can change
+	and later steps depend on: the server vars, the referential solvable and mode state,
+	the client id, the synced player metas, the resync flag
+	and what the simulation receiver still has to apply.
+
+	Everything else is left out on purpose, because it is either derived or only ever shown:
+	- the arena itself, i.e. the viewables, flavours, ruleset and the clean round state,
+	  which only change when an arena is loaded, so they are reloaded according to the saved server vars;
+	- the predicted cosmos, which is transferred from the referential one and then repredicted
+	  from the saved predicted entropies;
+	- interpolation and other audiovisual state, which is snapped to the restored cosmos;
+	- chat, rcon, avatars and network statistics, which never affect the simulation.
+
+	Server entropies are always consumed in the step they arrive in,
+	so a keyframe is only taken when none are buffered.
+*/
+
+struct demo_keyframe {
+	double secs = 0.0;
+	std::size_t uncompressed_size = 0;
+	std::vector<std::byte> compressed;
+};
+
+enum class keyframe_load_result {
+	NONE,
+	LOADED,
+	FAILED
+};
+
 struct client_demo_player {
 	int additional_steps = 0;
 	std::string replay_failed_reason;
@@ -12,7 +49,10 @@ struct client_demo_player {
 	demo_step default_step;
 
 	std::optional<demo_step_num_type> requested_seek;
+
+	/* Legacy .demc demos are decompressed as a whole, indexed ones are streamed chunk by chunk. */
 	std::vector<demo_step> demo_steps;
+	indexed_demo_reader indexed;
 	demo_step_num_type current_step = 0;
 
 	double speed = 1.0;
@@ -20,6 +60,11 @@ struct client_demo_player {
 
 	augs::fixed_delta_timer timer = { 30, augs::lag_spike_handling_type::CATCH_UP };
 
+	demo_keyframe_settings keyframe_settings;
+	std::map<demo_step_num_type, demo_keyframe> keyframes;
+	std::size_t keyframes_memory = 0;
+	demo_step_num_type keyframe_spacing_multiplier = 1;
+
 	bool control(const handle_input_before_game_input in);
 
 	void pause() {
@@ -38,10 +83,22 @@ struct client_demo_player {
 		return current_step;
 	}
 
-	auto get_total_steps() const {
+	std::size_t get_total_steps() const {
+		if (indexed.is_open()) {
+			return indexed.get_num_steps();
+		}
+
 		return demo_steps.size();
 	}
 
+	const demo_step& get_demo_step(const demo_step_num_type n) {
+		if (indexed.is_open()) {
+			return indexed.get_step(n);
+		}
+
+		return demo_steps[n];
+	}
+
 	auto get_current_secs() const {
 		return current_secs;
 	}
@@ -68,12 +125,86 @@ struct client_demo_player {
 		requested_seek = n;
 	}
 
-	template <class StepState>
-	void advance_player(StepState advance_state) {
-		if (current_step < demo_steps.size()) {
-			current_secs += advance_state(demo_steps[current_step]);
+	auto get_keyframes_memory() const {
+		return keyframes_memory;
+	}
+
+	auto get_num_keyframes() const {
+		return keyframes.size();
+	}
+
+	void clear_keyframes() {
+		keyframes.clear();
+		keyframes_memory = 0;
+		keyframe_spacing_multiplier = 1;
+	}
+
+	/*
+		When the keyframes exceed the memory budget,
+		every second one is dropped and the spacing between new ones is doubled,
+		so that they keep covering the whole demo evenly.
+	*/
+
+	void enforce_keyframes_budget() {
+		const auto budget = static_cast<std::size_t>(keyframe_settings.max_memory_mb) * 1024 * 1024;
+
+		while (keyframes_memory > budget) {
+			if (keyframes.size() < 2) {
+				clear_keyframes();
+				return;
+			}
+
+			bool drop = false;
+
+			for (auto it = keyframes.begin(); it != keyframes.end();) {
+				if (drop) {
+					keyframes_memory -= it->second.compressed.size();
+					it = keyframes.erase(it);
+				}
+				else {
+					++it;
+				}
+
+				drop = !drop;
+			}
+
+			keyframe_spacing_multiplier *= 2;
+		}
+	}
+
+	template <class SaveKeyframe>
+	void record_keyframe_if_due(SaveKeyframe save_keyframe) {
+		const auto spacing = keyframe_settings.keyframe_once_every_steps * keyframe_spacing_multiplier;
+
+		if (spacing == 0 || keyframe_settings.max_memory_mb == 0) {
+			return;
+		}
+
+		if (current_step % spacing != 0 || keyframes.find(current_step) != keyframes.end()) {
+			return;
+		}
+
+		demo_keyframe keyframe;
+		keyframe.secs = current_secs;
+
+		if (!save_keyframe(keyframe)) {
+			return;
+		}
+
+		keyframes_memory += keyframe.compressed.size();
+		keyframes.emplace(current_step, std::move(keyframe));
+
+		enforce_keyframes_budget();
+	}
+
+	template <class StepState, class SaveKeyframe>
+	void advance_player(StepState advance_state, SaveKeyframe save_keyframe) {
+		if (current_step < get_total_steps()) {
+			current_secs += advance_state(get_demo_step(current_step));
 
 			++current_step;
+
+			record_keyframe_if_due(save_keyframe);
 		}
 		else {
 			current_secs += advance_state(default_step);
@@ -87,23 +218,62 @@ struct client_demo_player {
 		current_secs = 0;
 	}
 
-	template <class StepState, class SeekingStepState, class RewindState>
+	template <class LoadKeyframe>
+	keyframe_load_result try_load_keyframe_before(const demo_step_num_type target_step, LoadKeyframe load_keyframe) {
+		auto it = keyframes.upper_bound(target_step);
+
+		if (it == keyframes.begin()) {
+			return keyframe_load_result::NONE;
+		}
+
+		--it;
+
+		const bool backward = target_step < current_step;
+		const bool skips_ahead = it->first > current_step;
+
+		if (!backward && !skips_ahead) {
+			return keyframe_load_result::NONE;
+		}
+
+		if (!load_keyframe(it->second)) {
+			keyframes_memory -= it->second.compressed.size();
+			keyframes.erase(it);
+
+			return keyframe_load_result::FAILED;
+		}
+
+		current_step = it->first;
+		current_secs = it->second.secs;
+
+		return keyframe_load_result::LOADED;
+	}
+
+	template <class StepState, class SeekingStepState, class RewindState, class SaveKeyframe, class LoadKeyframe>
 	void advance(
 		augs::delta frame_delta,
 		StepState step_state, 
 		SeekingStepState seeking_step_state, 
 		RewindState rewind_state,
+		SaveKeyframe save_keyframe,
+		LoadKeyframe load_keyframe,
 		const double inv_tickrate
 	) {
 		if (requested_seek.has_value()) {
 			const auto target_step = *requested_seek;
 
-			if (target_step < current_step) {
+			const auto result = try_load_keyframe_before(target_step, load_keyframe);
+
+			/* 
+				A keyframe that failed to load might have left the state half-restored,
+				so even a forward seek has to start over in that case.
+			*/
+
+			if (result == keyframe_load_result::FAILED || (result == keyframe_load_result::NONE && target_step < current_step)) {
 				rewind_player(rewind_state);
 			}
 
 			while (current_step < target_step) {
-				advance_player(seeking_step_state);
+				advance_player(seeking_step_state, save_keyframe);
 			}
 
 			requested_seek = std::nullopt;
@@ -120,9 +290,9 @@ struct client_demo_player {
 		}
 
 		while (steps--) {
-			advance_player(step_state);
+			advance_player(step_state, save_keyframe);
 
-			if (current_step == demo_steps.size()) {
+			if (current_step == get_total_steps()) {
 				pause();
 			}
 		}
@@ -130,4 +300,3 @@ struct client_demo_player {
 		additional_steps = 0;
 	}
 };
-
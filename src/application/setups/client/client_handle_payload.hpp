@@ -94,7 +94,11 @@ message_handler_result client_setup::handle_payload(
 			return continue_v;
 		}
 
-		direct_downloader = direct_file_download(*last_requested_direct_file_hash, payload.num_file_bytes);
+		direct_downloader = direct_file_download(
+			*last_requested_direct_file_hash,
+			payload.num_file_bytes,
+			payload.num_compressed_bytes
+		);
 
 		for (const auto& buffered_chunk : buffered_chunk_packets) {
 			if (direct_downloader.has_value()) {
@@ -289,6 +293,7 @@ message_handler_result client_setup::handle_payload(
 		}
 
 		predicted.transfer_all_solvables(referential);
+		receiver.clear_predicted_checkpoints();
 
 		if (was_resyncing) {
 			::restore_interpolations(receiver.transfer_caches, predicted_cosmos);
@@ -32,6 +32,7 @@
 #include "application/arena/arena_handle.hpp"
 #include "application/setups/client/demo_paths.h"
 #include "augs/misc/date_time.h"
+#include "augs/log_path_getters.h"
 #include "application/network/net_serialize.h"
 #include "augs/readwrite/byte_file.h"
 #include "application/gui/client/demo_player_gui.hpp"
@@ -391,19 +392,34 @@ struct webrtc_client_detail {
 void client_demo_player::play_demo_from(const augs::path_type& p) {
 	source_path = p;
 
+	demo_steps.clear();
+	indexed.close();
+	clear_keyframes();
+
+	if (source_path.extension() == ".demi") {
+		indexed.open(source_path);
+		meta = indexed.get_meta();
+
+		gui.open();
+		return;
+	}
+
 	auto source_bytes = augs::file_to_bytes(source_path);
 	auto source = augs::make_ptr_read_stream(source_bytes);
 	augs::read_bytes(source, meta);
+	::ensure_demo_replayable(meta, source_path);
 
 	const auto pos = source.get_read_pos();
 
 	if (pos < source_bytes.size()) {
+		const auto compressed_size = source_bytes.size() - pos;
+
 		std::vector<std::byte> decompressed;
-		decompressed.resize(meta.uncompressed_size);
+		decompressed.resize(::get_checked_uncompressed_demo_size(meta, compressed_size, source_path));
 
 		augs::decompress(
 			source_bytes.data() + pos,
-			source_bytes.size() - pos,
+			compressed_size,
 			decompressed
 		);
 
@@ -421,7 +437,6 @@ void client_demo_player::play_demo_from(const augs::path_type& p) {
 		}
 	}
 
-
 	gui.open();
 }
 
@@ -598,7 +613,21 @@ void client_setup::handle_received(const file_chunk_packet& chunk) {
 
 	uint32_t data_received = 0;
 
-	if (const auto complete_file = direct_downloader->advance(chunk, data_received); complete_file.has_value()) {
+	std::optional<std::vector<std::byte>> complete_file;
+
+	try {
+		complete_file = direct_downloader->advance(chunk, data_received);
+	}
+	catch (const augs::decompression_error& err) {
+		direct_downloader = std::nullopt;
+		last_requested_direct_file_hash = std::nullopt;
+
+		set_disconnect_reason(typesafe_sprintf("Failed to decompress a file downloaded from the server:\n%x", err.what()));
+		schedule_disconnect = true;
+		return;
+	}
+
+	if (complete_file.has_value()) {
 		direct_downloader = std::nullopt;
 		last_requested_direct_file_hash = std::nullopt;
 
@@ -741,6 +770,8 @@ client_setup::client_setup(
 
 	(void)nat_detection;
 
+	enable_trace_according_to_vars();
+
 	const auto input_demo_path = ::find_demo_path(connect_string);
 	const bool is_opening_demo = input_demo_path.has_value();
 
@@ -1049,6 +1080,115 @@ bool client_setup::finalize_arena_download() {
 	return try_load_arena_according_to(sv_public_vars, false);
 }
 
+bool client_setup::save_demo_keyframe(demo_keyframe& into) {
+	if (state != client_state_type::IN_GAME || pause_solvable_stream) {
+		return false;
+	}
+
+	if (!receiver.incoming_entropies.empty()) {
+		return false;
+	}
+
+	auto s = buffers.make_serialization_stream();
+
+	augs::write_bytes(s, sv_public_vars);
+	augs::write_bytes(s, sv_dynamic_vars);
+	augs::write_bytes(s, client_player_id);
+	augs::write_bytes(s, now_resyncing);
+
+	augs::write_bytes(s, scene.world.get_solvable().significant);
+	augs::write_bytes(s, current_mode_state);
+
+	augs::write_bytes(s, receiver.incoming_contexts);
+	augs::write_bytes(s, receiver.predicted_entropies);
+	augs::write_bytes(s, receiver.next_dynamic_vars);
+
+	for (const auto& meta : player_metas) {
+		augs::write_bytes(s, meta.synced.public_settings);
+		augs::write_bytes(s, meta.synced.is_web_client);
+	}
+
+	into.uncompressed_size = buffers.serialization.size();
+	augs::compress(buffers.compression_state, buffers.serialization, into.compressed);
+	into.compressed.shrink_to_fit();
+
+	return true;
+}
+
+bool client_setup::load_demo_keyframe(const demo_keyframe& from) {
+	auto& bytes = buffers.serialization;
+	bytes.resize(from.uncompressed_size);
+
+	try {
+		augs::decompress(from.compressed.data(), from.compressed.size(), bytes);
+
+		auto s = augs::make_ptr_read_stream(bytes);
+
+		server_public_vars keyframe_vars;
+		augs::read_bytes(s, keyframe_vars);
+
+		const bool same_arena = 
+			keyframe_vars.arena == sv_public_vars.arena
+			&& keyframe_vars.game_mode == sv_public_vars.game_mode
+			&& keyframe_vars.required_arena_hash == sv_public_vars.required_arena_hash
+		;
+
+		if (!same_arena) {
+			LOG("Keyframe was recorded on a different arena: %x. Reloading.", keyframe_vars.arena);
+
+			if (!try_load_arena_according_to(keyframe_vars, false)) {
+				return false;
+			}
+		}
+
+		sv_public_vars = keyframe_vars;
+
+		augs::read_bytes(s, sv_dynamic_vars);
+		augs::read_bytes(s, client_player_id);
+		augs::read_bytes(s, now_resyncing);
+
+		cosmic::change_solvable_significant(
+			scene.world, 
+			[&](cosmos_solvable_significant& signi) {
+				augs::read_bytes(s, signi);
+				augs::read_bytes(s, current_mode_state);
+
+				return changer_callback_result::REFRESH;
+			}
+		);
+
+		receiver.clear();
+
+		augs::read_bytes(s, receiver.incoming_contexts);
+		augs::read_bytes(s, receiver.predicted_entropies);
+		augs::read_bytes(s, receiver.next_dynamic_vars);
+
+		for (auto& meta : player_metas) {
+			augs::read_bytes(s, meta.synced.public_settings);
+			augs::read_bytes(s, meta.synced.is_web_client);
+		}
+	}
+	catch (const augs::stream_read_error& err) {
+		LOG("Failed to load a demo keyframe: %x", err.what());
+		return false;
+	}
+	catch (const augs::decompression_error& err) {
+		LOG("Failed to decompress a demo keyframe: %x", err.what());
+		return false;
+	}
+
+	state = client_state_type::IN_GAME;
+	rebuild_player_meta_viewables = true;
+
+	auto predicted = get_arena_handle(client_arena_type::PREDICTED);
+	const auto referential = get_arena_handle(client_arena_type::REFERENTIAL);
+
+	predicted.transfer_all_solvables(referential);
+	receiver.schedule_reprediction = true;
+
+	return true;
+}
+
 bool client_setup::try_load_arena_according_to(const server_public_vars& new_vars, bool allow_download) {
 	const auto& new_arena = new_vars.arena;
 
@@ -2022,6 +2162,7 @@ static uint8_t get_client_welcome_type(const bool suppress) {
 
 void client_setup::apply(const config_json_table& cfg) {
 	vars = cfg.client;
+	enable_trace_according_to_vars();
 
 	if (is_replaying()) {
 		return;
@@ -2037,6 +2178,53 @@ void client_setup::apply(const config_json_table& cfg) {
 	adapter->set(vars.network_simulator);
 }
 
+void client_setup::enable_trace_according_to_vars() {
+	trace.set_enabled(vars.record_performance_trace || vars.dump_performance_trace_if_step_exceeds_ms > 0.f);
+}
+
+void client_setup::dump_performance_trace(const std::string& reason) {
+	if (!trace.is_enabled()) {
+		LOG("Performance trace requested (%x), but recording is disabled. Set record_performance_trace first.", reason);
+		return;
+	}
+
+	if (trace_dump_job.valid() && !is_ready(trace_dump_job)) {
+		LOG("Performance trace requested (%x), but the previous one is still being written.", reason);
+		return;
+	}
+
+	const auto path = augs::path_type(get_path_in_log_files(augs::trace_recorder::make_dump_file_name("client")));
+
+	trace_dump_job = launch_async(
+		[snapshot = trace.take_snapshot(), path, reason]() {
+			try {
+				const auto num_events = augs::trace_recorder::write_chrome_trace(snapshot, path);
+				LOG("Dumped %x trace events due to %x: %x", num_events, reason, path);
+			}
+			catch (const augs::file_open_error& err) {
+				LOG("Failed to dump the performance trace: %x", err.what());
+			}
+		}
+	);
+}
+
+void client_setup::dump_performance_trace_if_step_was_long(const double step_ms) {
+	const auto threshold_ms = vars.dump_performance_trace_if_step_exceeds_ms;
+
+	if (threshold_ms <= 0.f || step_ms <= threshold_ms) {
+		return;
+	}
+
+	const auto min_secs_between_dumps = 10.0;
+
+	if (last_dumped_trace_at != 0 && client_time - last_dumped_trace_at < min_secs_between_dumps) {
+		return;
+	}
+
+	last_dumped_trace_at = client_time;
+	dump_performance_trace(typesafe_sprintf("a client step of %2f ms", step_ms));
+}
+
 void client_setup::apply_nonzoomedout_visible_world_area(vec2 area) {
 	auto& r = requested_settings;
 	r.public_settings.nonzoomedout_visible_world_area = area;
@@ -2399,3 +2587,72 @@ void client_setup::detect_our_victory(const messages::match_summary_message& msg
 		}
 	}
 }
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("ClientDemoPlayer KeyframeSeeking") {
+	client_demo_player player;
+
+	player.demo_steps.resize(1000);
+	player.keyframe_settings.keyframe_once_every_steps = 100;
+
+	uint64_t state = 0;
+	std::size_t replayed_steps = 0;
+	std::size_t rewinds = 0;
+
+	auto step_state = [&](const demo_step&) {
+		state = state * 31 + 7;
+		++replayed_steps;
+		return 1.0;
+	};
+
+	auto rewind_state = [&]() {
+		state = 0;
+		++rewinds;
+	};
+
+	auto save_keyframe = [&](demo_keyframe& k) {
+		k.uncompressed_size = sizeof(state);
+		k.compressed.resize(sizeof(state));
+		std::memcpy(k.compressed.data(), &state, sizeof(state));
+		return true;
+	};
+
+	auto load_keyframe = [&](const demo_keyframe& k) {
+		std::memcpy(&state, k.compressed.data(), sizeof(state));
+		return true;
+	};
+
+	auto seek = [&](const demo_step_num_type n) {
+		player.seek_to(n);
+		player.advance(augs::delta::zero, step_state, step_state, rewind_state, save_keyframe, load_keyframe, 1 / 60.0);
+	};
+
+	seek(950);
+	const auto state_at_950 = state;
+
+	REQUIRE(player.get_num_keyframes() == 9);
+
+	replayed_steps = 0;
+	seek(420);
+	REQUIRE(replayed_steps == 20);
+	REQUIRE(player.get_current_secs() == 420.0);
+
+	replayed_steps = 0;
+	seek(950);
+	REQUIRE(replayed_steps == 50);
+	REQUIRE(state == state_at_950);
+	REQUIRE(rewinds == 0);
+
+	seek(50);
+	REQUIRE(rewinds == 1);
+
+	/* Not even a single keyframe fits in a zero-megabyte budget. */
+
+	player.keyframe_settings.max_memory_mb = 0;
+	player.enforce_keyframes_budget();
+	REQUIRE(player.get_num_keyframes() == 0);
+	REQUIRE(player.get_keyframes_memory() == 0);
+}
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include "augs/misc/future.h"
+#include "augs/misc/trace_recorder.h"
 #include "augs/math/camera_cone.h"
 #include "game/detail/render_layer_filter.h"
 #include "application/setups/client/client_connect_string.h"
@@ -20,6 +21,9 @@
 
 #include "augs/readwrite/memory_stream_declaration.h"
 #include "augs/misc/serialization_buffers.h"
+#include "augs/misc/compress.h"
+#include "augs/readwrite/stream_read_error.h"
+#include "augs/filesystem/file.h"
 
 #include "view/mode_gui/arena/arena_gui_mixin.h"
 #include "view/audiovisual_state/audiovisual_post_solve_settings.h"
@@ -134,6 +138,14 @@ class client_setup :
 	net_time_t when_sent_nat_punch_request = -1;
 	net_time_t when_sent_last_keepalive = 0;
 	net_time_t when_sent_last_referential_step = 0;
+	net_time_t when_measured_repredictions = 0;
+
+	std::size_t repredicted_steps_this_second = 0;
+	std::size_t reused_predicted_steps_this_second = 0;
+
+	augs::trace_recorder trace;
+	augs::future<void> trace_dump_job;
+	net_time_t last_dumped_trace_at = 0;
 
 	std::string last_disconnect_reason;
 	bool print_only_disconnect_reason = false;
@@ -246,6 +258,9 @@ class client_setup :
 
 	void demo_replay_server_messages_from(const demo_step&);
 
+	bool save_demo_keyframe(demo_keyframe&);
+	bool load_demo_keyframe(const demo_keyframe&);
+
 	auto make_accumulator_input(const client_advance_input& in) {
 		auto accumulator_in = in.make_accumulator_input();
 		accumulator_in.settings.character = current_requested_settings.public_settings.character_input;
@@ -288,12 +303,14 @@ class client_setup :
 		const auto referential_solve_settings = [&]() {
 			solve_settings out;
 			out.effect_prediction = in.lag_compensation.effect_prediction;
+			out.pool = in.solve_pool;
 			return out;
 		}();
 
 		const auto repredicted_solve_settings = [&]() {
 			solve_settings out;
 			out.effect_prediction = in.lag_compensation.effect_prediction;
+			out.pool = in.solve_pool;
 
 			if (in.lag_compensation.confirm_local_character_death) {
 				out.disable_knockouts = get_viewed_character();
@@ -317,6 +334,7 @@ class client_setup :
 		};
 
 		auto& performance = in.network_performance;
+		const auto step_timer = augs::timer();
 
 		{
 			auto scope = measure_scope(performance.receiving_messages);
@@ -467,19 +485,7 @@ class client_setup :
 				};
 
 				auto unpack = [&](const compact_server_step_entropy& entropy) {
-					auto mode_id_to_entity_id = [&](const mode_player_id& mode_id) {
-						return get_arena_handle(client_arena_type::REFERENTIAL).on_mode(
-							[&](const auto& typed_mode) {
-								return typed_mode.lookup(mode_id);
-							}
-						);
-					};
-
-					auto get_settings_for = [&](const mode_player_id& mode_id) {
-						return player_metas[mode_id.value].synced.public_settings.character_input;
-					};
-
-					return entropy.unpack(mode_id_to_entity_id, get_settings_for);
+					return ::unpack_server_entropy(referential_arena, player_metas, entropy);
 				};
 
 				const auto result = receiver.unpack_deterministic_steps(
@@ -502,6 +508,18 @@ class client_setup :
 
 				performance.accepted_commands.measure(result.total_accepted);
 
+				repredicted_steps_this_second += result.num_repredicted_steps;
+				reused_predicted_steps_this_second += result.num_reused_predicted_steps;
+
+				if (client_time - when_measured_repredictions >= 1.0) {
+					performance.repredicted_steps_per_second.measure(repredicted_steps_this_second);
+					performance.reused_predicted_steps_per_second.measure(reused_predicted_steps_this_second);
+
+					repredicted_steps_this_second = 0;
+					reused_predicted_steps_this_second = 0;
+					when_measured_repredictions = client_time;
+				}
+
 				if (result.malicious_server) {
 					set_disconnect_reason("There was a problem unpacking steps from the server. Disconnecting.");
 					disconnect();
@@ -576,6 +594,11 @@ class client_setup :
 				);
 
 				schedule_reprediction_if_inconsistent(forward_step_result);
+
+				{
+					auto scope = measure_scope(performance.saving_predicted_checkpoints);
+					receiver.save_predicted_checkpoint(in.simulation_receiver, predicted_arena);
+				}
 #else
 				(void)predicted_solve_settings;
 				(void)predicted_callbacks;
@@ -595,9 +618,15 @@ class client_setup :
 		update_stats(in.network_stats);
 		total_collected.clear();
 
+		dump_performance_trace_if_step_was_long(step_timer.get<std::chrono::milliseconds>());
+
 		return chosen_dt;
 	}
 
+	void dump_performance_trace(const std::string& reason);
+	void dump_performance_trace_if_step_was_long(double step_ms);
+	void enable_trace_according_to_vars();
+
 	void perform_demo_player_imgui(augs::window& window);
 	void snap_interpolations();
 
@@ -696,6 +725,8 @@ public:
 		const client_advance_input& in,
 		const Callbacks& callbacks
 	) {
+		const auto tracing = augs::trace_recorder::current_scope(&trace);
+
 		if (is_replaying()) {
 			auto advance_with = [&](const demo_step& step) {
 				const auto dt = get_inv_tickrate();
@@ -739,13 +770,43 @@ public:
 				demo_player = std::move(player_backup);
 			};
 
-			demo_player.advance(
-				in.frame_delta,
-				advance_with,
-				seeking_advance,
-				rewind,
-				get_inv_tickrate()
-			);
+			auto save_keyframe = [&](demo_keyframe& keyframe) {
+				return save_demo_keyframe(keyframe);
+			};
+
+			auto load_keyframe = [&](const demo_keyframe& keyframe) {
+				needs_snap = true;
+				return load_demo_keyframe(keyframe);
+			};
+
+			demo_player.keyframe_settings = vars.demo_keyframes;
+
+			try {
+				demo_player.advance(
+					in.frame_delta,
+					advance_with,
+					seeking_advance,
+					rewind,
+					save_keyframe,
+					load_keyframe,
+					get_inv_tickrate()
+				);
+			}
+			catch (const augs::stream_read_error& err) {
+				set_demo_failed_reason(err.what());
+				disconnect();
+				return;
+			}
+			catch (const augs::decompression_error& err) {
+				set_demo_failed_reason(err.what());
+				disconnect();
+				return;
+			}
+			catch (const augs::file_open_error& err) {
+				set_demo_failed_reason(err.what());
+				disconnect();
+				return;
+			}
 
 			if (needs_snap) {
 				snap_interpolations();
@@ -881,6 +942,24 @@ public:
 	bool is_replaying() const;
 	bool is_paused() const;
 	bool is_recording() const;
+
+	auto get_demo_current_step() const {
+		return demo_player.get_current_step();
+	}
+
+	auto get_demo_total_steps() const {
+		return demo_player.get_total_steps();
+	}
+
+	/* Replays this many demo steps on the next advance, regardless of time passed. */
+	void request_demo_steps(const int n) {
+		demo_player.additional_steps += n;
+	}
+
+	const auto& get_last_disconnect_reason() const {
+		return last_disconnect_reason;
+	}
+
 	demo_step& get_currently_recorded_step();
 	void flush_demo_steps();
 	void wait_for_demo_flush();
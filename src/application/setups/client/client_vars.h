@@ -43,6 +43,15 @@ struct client_chat_settings {
 	bool operator==(const client_chat_settings& b) const = default;
 };
 
+struct demo_keyframe_settings {
+	// GEN INTROSPECTOR struct demo_keyframe_settings
+	unsigned keyframe_once_every_steps = 600;
+	unsigned max_memory_mb = 256;
+	// END GEN INTROSPECTOR
+
+	bool operator==(const demo_keyframe_settings& b) const = default;
+};
+
 struct override_holder {
 	mutable client_nickname_type nickname = "";
 	bool operator==(const override_holder&) const { return true; };
@@ -65,6 +74,7 @@ struct client_vars {
 	unsigned max_predicted_client_commands = 3000u;
 
 	unsigned flush_demo_to_disk_once_every_secs = 10u;
+	demo_keyframe_settings demo_keyframes;
 
 	client_arena_type spectated_arena_type = client_arena_type::REFERENTIAL;
 	std::string rcon_password = "";
@@ -73,6 +83,9 @@ struct client_vars {
 	bool record_demo = true;
 
 	float max_direct_file_bandwidth = 2.0f;
+
+	bool record_performance_trace = false;
+	float dump_performance_trace_if_step_exceeds_ms = 0.f;
 	// END GEN INTROSPECTOR
 
 	override_holder signed_in;
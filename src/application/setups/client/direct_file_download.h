@@ -12,6 +12,8 @@ class direct_file_download {
 	randomization rng;
 
 	uint32_t target_file_size = 0;
+	uint32_t num_transferred_bytes = 0;
+	bool compressed = false;
 
 	uint32_t num_chunks_downloaded = 0;
 	uint32_t num_chunks_total = 0;
@@ -26,7 +28,8 @@ class direct_file_download {
 public:
 	direct_file_download(
 		augs::secure_hash_type hash,
-		uint32_t num_file_bytes
+		uint32_t num_file_bytes,
+		uint32_t num_compressed_bytes
 	);
 
 	std::optional<std::vector<std::byte>> advance(const file_chunk_packet&, uint32_t& data_received);
@@ -34,7 +37,7 @@ public:
 	direct_file_chunk_meta& request_next_chunk();
 
 	std::size_t get_total_bytes() const {
-		return target_file_size;
+		return num_transferred_bytes;
 	}
 
 	std::size_t get_downloaded_bytes() const {
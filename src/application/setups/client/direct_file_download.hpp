@@ -1,16 +1,23 @@
 #pragma once
 #include "application/setups/client/direct_file_download.h"
+#include "augs/misc/compress.h"
 
 direct_file_download::direct_file_download(
 	augs::secure_hash_type hash,
-	uint32_t num_file_bytes
-) : current_hash(hash), target_file_size(num_file_bytes) {
-	ensure(num_file_bytes < max_direct_download_file_size_v);
-	ensure(num_file_bytes > 0);
-
-	num_chunks_total = num_file_bytes / file_chunk_size_v;
-
-	if (num_file_bytes % file_chunk_size_v != 0) {
+	uint32_t num_file_bytes,
+	uint32_t num_compressed_bytes
+) : 
+	current_hash(hash), 
+	target_file_size(num_file_bytes),
+	num_transferred_bytes(num_compressed_bytes != 0 ? num_compressed_bytes : num_file_bytes),
+	compressed(num_compressed_bytes != 0)
+{
+	ensure(num_transferred_bytes < max_direct_download_file_size_v);
+	ensure(num_transferred_bytes > 0);
+
+	num_chunks_total = num_transferred_bytes / file_chunk_size_v;
+
+	if (num_transferred_bytes % file_chunk_size_v != 0) {
 		++num_chunks_total;
 	}
 
@@ -80,7 +87,13 @@ std::optional<std::vector<std::byte>> direct_file_download::advance(const file_c
 	);
 
 	if (chunks.empty()) {
-		file_bytes.resize(target_file_size);
+		file_bytes.resize(num_transferred_bytes);
+
+		if (compressed) {
+			/* Throws augs::decompression_error if the server sent garbage. */
+			return augs::decompress(file_bytes, target_file_size);
+		}
+
 		return std::move(file_bytes);
 	}
 
@@ -0,0 +1,216 @@
+#include "augs/misc/pool/pool_io.hpp"
+#include "application/setups/client/headless_demo_replayer.h"
+
+#include "application/setups/server/rcon_level.h"
+#include "application/network/network_adapters.hpp"
+#include "application/network/net_message_translation.h"
+#include "application/setups/client/demo_step.h"
+#include "application/network/net_message_readwrite.h"
+#include "application/network/payload_easily_movable.h"
+
+#include "game/cosmos/change_solvable_significant.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/stream_read_error.h"
+
+#include "steam_rich_presence_pairs.h"
+#include "application/arena/arena_handle.hpp"
+#include "application/arena/choose_arena.h"
+#include "application/setups/editor/packaged_official_content.h"
+
+using initial_snapshot_payload = full_arena_snapshot_payload<false>;
+
+headless_demo_replayer::headless_demo_replayer(
+	const packaged_official_content& official,
+	const augs::path_type& demo_path
+) :
+	official(official)
+{
+	if (demo_path.extension() == ".demi") {
+		reader.open(demo_path);
+		return;
+	}
+
+	converted_demo_dir.emplace("headless_demo_replayer");
+
+	const auto converted_path = *converted_demo_dir / "replayed.demi";
+	::convert_demo_to_indexed(demo_path, converted_path);
+
+	reader.open(converted_path);
+}
+
+bool headless_demo_replayer::load_arena_according_to(const server_public_vars& new_vars) {
+	LOG("Trying to load arena: %x (game_mode: %x)", new_vars.arena, new_vars.game_mode.empty() ? "default" : new_vars.game_mode.c_str());
+
+	try {
+		editor_project* keep_loaded_project = nullptr;
+
+		const auto choice_result = ::choose_arena_client(
+			{
+				editor_project_readwrite::reading_settings(),
+				get_arena_handle(),
+				official,
+				new_vars.arena,
+				new_vars.game_mode,
+				clean_round_state,
+				new_vars.playtesting_context,
+				keep_loaded_project,
+				nullptr
+			},
+
+			new_vars.required_arena_hash
+		);
+
+		if (choice_result.was_arena_found()) {
+			return true;
+		}
+
+		if (choice_result.official_differs) {
+			fail(typesafe_sprintf("The local files of the official arena \"%x\" differ from the ones the demo was recorded with.", new_vars.arena));
+		}
+		else {
+			fail(typesafe_sprintf("The arena \"%x\" with the hash the demo was recorded with was not found.", new_vars.arena));
+		}
+	}
+	catch (const std::exception& err) {
+		fail(typesafe_sprintf("Failed to load \"%x\":\n%x.", new_vars.arena, err.what()));
+	}
+
+	return false;
+}
+
+template <class T, class F>
+message_handler_result headless_demo_replayer::handle_payload(F&& read_payload) {
+	constexpr auto abort_v = message_handler_result::ABORT_AND_DISCONNECT;
+	constexpr auto continue_v = message_handler_result::CONTINUE;
+	constexpr bool is_easy_v = payload_easily_movable_v<T>;
+
+	std::conditional_t<is_easy_v, T, std::monostate> payload;
+
+	if constexpr(is_easy_v) {
+		if (!read_payload(payload)) {
+			return abort_v;
+		}
+	}
+
+	if constexpr (std::is_same_v<T, server_public_vars>) {
+		const auto& new_vars = payload;
+
+		const bool reload_arena =
+			!received_public_vars
+			|| new_vars.arena != sv_public_vars.arena
+			|| new_vars.game_mode != sv_public_vars.game_mode
+			|| new_vars.required_arena_hash != sv_public_vars.required_arena_hash
+		;
+
+		received_public_vars = true;
+		sv_public_vars = new_vars;
+
+		if (reload_arena) {
+			if (!load_arena_according_to(new_vars)) {
+				return abort_v;
+			}
+		}
+	}
+	else if constexpr (std::is_same_v<T, special_client_request>) {
+		if (payload == special_client_request::UNPAUSE_WEB_CLIENT) {
+			now_resyncing = true;
+			receiver.clear();
+		}
+	}
+	else if constexpr (std::is_same_v<T, initial_snapshot_payload>) {
+		if (!now_resyncing && !received_public_vars) {
+			fail("The demo has the initial state before the server vars.");
+			return abort_v;
+		}
+
+		now_resyncing = false;
+
+		uint32_t read_client_id;
+		rcon_level_type read_rcon_level;
+
+		bool result = false;
+
+		cosmic::change_solvable_significant(
+			scene.world,
+			[&](cosmos_solvable_significant& signi) {
+				result = read_payload(
+					buffers,
+
+					clean_round_state,
+
+					initial_snapshot_payload {
+						signi,
+						current_mode_state,
+						read_client_id,
+						read_rcon_level
+					}
+				);
+
+				return changer_callback_result::REFRESH;
+			}
+		);
+
+		if (!result) {
+			return abort_v;
+		}
+
+		LOG("Replaying from the initial state at step: %x.", scene.world.get_timestamp().step);
+
+		in_game = true;
+		receiver.clear_incoming();
+	}
+	else if constexpr (std::is_same_v<T, networked_server_step_entropy>) {
+		if (!in_game) {
+			fail("The demo has server entropy before the initial state.");
+			return abort_v;
+		}
+
+		receiver.acquire_next_server_entropy(
+			payload.context,
+			payload.meta,
+			payload.payload
+		);
+	}
+	else if constexpr (std::is_same_v<T, synced_dynamic_vars>) {
+		receiver.acquire_next_dynamic_vars(payload);
+	}
+	else if constexpr (std::is_same_v<T, synced_meta_update>) {
+		player_metas[payload.subject_id.value].synced = payload.new_meta;
+	}
+	else {
+		/* Chat, statistics, avatars and downloads don't affect the simulation. */
+	}
+
+	return continue_v;
+}
+
+void headless_demo_replayer::replay_server_messages_from(const demo_step& step) {
+	for (std::vector<std::byte>& serialized_bytes : step.serialized_messages) {
+		auto replay_message = [this](auto& typed_msg) -> message_handler_result {
+			using net_message_type = remove_cref<decltype(typed_msg)>;
+
+			auto read_payload_into = [&](auto&&... args) {
+				return typed_msg.read_payload(
+					std::forward<decltype(args)>(args)...
+				);
+			};
+
+			using P = payload_of_t<net_message_type>;
+
+			return handle_payload<remove_cref<P>>(std::move(read_payload_into));
+		};
+
+		try {
+			const auto result = ::replay_serialized_net_message(yojimbo::GetDefaultAllocator(), serialized_bytes, replay_message);
+
+			if (result == message_handler_result::ABORT_AND_DISCONNECT) {
+				fail(typesafe_sprintf("Could not replay a message of step: %x.", current_step));
+				return;
+			}
+		}
+		catch (const augs::stream_read_error& err) {
+			fail(err.what());
+			return;
+		}
+	}
+}
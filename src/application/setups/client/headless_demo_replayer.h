@@ -0,0 +1,154 @@
+#pragma once
+#include <memory>
+#include <optional>
+
+#include "augs/misc/serialization_buffers.h"
+#include "augs/templates/logically_empty.h"
+#include "augs/filesystem/temporary_directory.h"
+#include "augs/network/network_types.h"
+#include "application/intercosm.h"
+#include "application/network/network_common.h"
+#include "application/network/simulation_receiver.h"
+#include "game/cosmos/solvers/solver_callbacks.h"
+#include "application/arena/synced_dynamic_vars.h"
+#include "application/setups/server/server_vars.h"
+#include "application/setups/client/indexed_demo.h"
+#include "application/setups/editor/packaged_official_content_declaration.h"
+#include "view/mode_gui/arena/arena_player_meta.h"
+
+/*
+	Replays the server messages of a demo without a client_setup,
+	so that it is also available in headless builds.
+
+	The received steps go through a simulation_receiver,
+	which steps only the referential arena, with the very code client_setup uses for it.
+	Nothing is predicted, interpolated, drawn or played.
+
+	Demos that aren't indexed yet are converted into a temporary directory first.
+*/
+
+class headless_demo_replayer {
+	const packaged_official_content& official;
+
+	std::optional<augs::temporary_directory> converted_demo_dir;
+	indexed_demo_reader reader;
+	demo_step_num_type current_step = 0;
+
+	intercosm scene;
+	cosmos_solvable_significant clean_round_state;
+	all_rulesets_variant ruleset;
+	all_modes_variant current_mode_state;
+
+	server_public_vars sv_public_vars;
+	synced_dynamic_vars sv_dynamic_vars;
+	arena_player_metas player_metas;
+
+	augs::serialization_buffers buffers;
+
+	simulation_receiver receiver;
+
+	bool received_public_vars = false;
+	bool in_game = false;
+	bool now_resyncing = false;
+
+	std::string failure_reason;
+	std::size_t num_desyncs = 0;
+
+	template <class T, class F>
+	message_handler_result handle_payload(F&& read_payload);
+
+	bool load_arena_according_to(const server_public_vars&);
+	void replay_server_messages_from(const demo_step&);
+
+	void fail(const std::string& reason) {
+		if (failure_reason.empty()) {
+			failure_reason = reason;
+		}
+	}
+
+public:
+	/* Throws if the demo could not be read. */
+	headless_demo_replayer(const packaged_official_content&, const augs::path_type& demo_path);
+
+	online_arena_handle<false> get_arena_handle() {
+		return {
+			current_mode_state,
+			scene,
+			scene.world,
+			ruleset,
+			clean_round_state,
+			sv_dynamic_vars
+		};
+	}
+
+	const cosmos& get_cosmos() const {
+		return scene.world;
+	}
+
+	std::size_t get_total_steps() const {
+		return reader.get_num_steps();
+	}
+
+	demo_step_num_type get_current_step() const {
+		return current_step;
+	}
+
+	bool has_finished() const {
+		return has_failed() || current_step >= get_total_steps();
+	}
+
+	bool has_failed() const {
+		return !failure_reason.empty();
+	}
+
+	const std::string& get_failure_reason() const {
+		return failure_reason;
+	}
+
+	/* Demo steps during which the state differed from the hash recorded by the server. */
+	std::size_t get_num_desyncs() const {
+		return num_desyncs;
+	}
+
+	template <class Callbacks>
+	void advance(const Callbacks& callbacks, const solve_settings& settings) {
+		replay_server_messages_from(reader.get_step(current_step));
+		++current_step;
+
+		if (has_failed() || !in_game) {
+			return;
+		}
+
+		auto referential_arena = get_arena_handle();
+
+		auto unpack = [&](const compact_server_step_entropy& entropy) {
+			return ::unpack_server_entropy(referential_arena, player_metas, entropy);
+		};
+
+		auto advance_referential = [&](const auto& entropy) {
+			referential_arena.advance(entropy, callbacks, settings);
+
+			const auto& removed = entropy.general.removed_player;
+
+			if (logically_set(removed)) {
+				player_metas[removed.value].clear();
+			}
+		};
+
+		const auto result = receiver.unpack_referential_steps(
+			sv_dynamic_vars,
+			unpack,
+			referential_arena,
+			advance_referential
+		);
+
+		if (result.malicious_server) {
+			fail(typesafe_sprintf("Could not unpack the server steps of demo step: %x.", current_step));
+		}
+
+		if (result.desync) {
+			++num_desyncs;
+			now_resyncing = true;
+		}
+	}
+};
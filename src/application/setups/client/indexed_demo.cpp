@@ -0,0 +1,552 @@
+#include <limits>
+#include <algorithm>
+#include "application/setups/client/indexed_demo.h"
+#include "augs/readwrite/memory_stream.h"
+#include "augs/readwrite/to_bytes.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/readwrite/stream_read_error.h"
+#include "augs/filesystem/file.h"
+#include "augs/misc/compress.h"
+
+indexed_demo_writer::indexed_demo_writer(
+	const demo_file_meta& meta,
+	const uint32_t steps_per_chunk
+) :
+	meta(meta),
+	compression_state(augs::make_compression_state())
+{
+	header.steps_per_chunk = std::max(steps_per_chunk, 1u);
+}
+
+void indexed_demo_writer::push(const demo_step& step) {
+	pending_offsets.push_back(static_cast<uint32_t>(pending_steps.size()));
+
+	auto s = augs::ref_memory_stream(pending_steps);
+	s.set_write_pos(pending_steps.size());
+	augs::write_bytes(s, step);
+
+	++header.num_steps;
+
+	if (pending_offsets.size() == header.steps_per_chunk) {
+		flush_chunk();
+	}
+}
+
+void indexed_demo_writer::flush_chunk() {
+	if (pending_offsets.empty()) {
+		return;
+	}
+
+	const auto offsets_size = pending_offsets.size() * sizeof(uint32_t);
+
+	pending_chunk.resize(offsets_size + pending_steps.size());
+	std::memcpy(pending_chunk.data(), pending_offsets.data(), offsets_size);
+	std::memcpy(pending_chunk.data() + offsets_size, pending_steps.data(), pending_steps.size());
+
+	indexed_demo_chunk_entry entry;
+	entry.offset = compressed_chunks.size();
+
+	augs::compress(compression_state, pending_chunk, compressed_chunks);
+
+	entry.compressed_size = static_cast<uint32_t>(compressed_chunks.size() - entry.offset);
+	entry.uncompressed_size = static_cast<uint32_t>(pending_chunk.size());
+
+	chunk_entries.push_back(entry);
+
+	meta.uncompressed_size += pending_steps.size();
+
+	pending_offsets.clear();
+	pending_steps.clear();
+}
+
+void indexed_demo_writer::save(const augs::path_type& path) {
+	flush_chunk();
+
+	header.num_chunks = static_cast<uint32_t>(chunk_entries.size());
+
+	auto out = augs::open_binary_output_stream(path);
+
+	augs::write_bytes(out, meta);
+	augs::write_bytes(out, header);
+
+	for (const auto& e : chunk_entries) {
+		augs::write_bytes(out, e);
+	}
+
+	out.write(reinterpret_cast<const char*>(compressed_chunks.data()), compressed_chunks.size());
+	out.flush();
+}
+
+void indexed_demo_reader::open(const augs::path_type& path) {
+	close();
+
+	source = augs::open_binary_input_stream(path);
+
+	augs::read_bytes(source, meta);
+	::ensure_demo_replayable(meta, path);
+
+	augs::read_bytes(source, header);
+
+	if (header.magic != indexed_demo_magic_v) {
+		throw augs::stream_read_error("%x is not an indexed demo.", path);
+	}
+
+	if (header.version != indexed_demo_version_v) {
+		throw augs::stream_read_error("Unsupported indexed demo version: %x (expected %x).", header.version, indexed_demo_version_v);
+	}
+
+	if (header.steps_per_chunk == 0) {
+		throw augs::stream_read_error("Indexed demo declares zero steps per chunk.");
+	}
+
+	const auto expected_chunks = (header.num_steps + header.steps_per_chunk - 1) / header.steps_per_chunk;
+
+	if (header.num_chunks != expected_chunks) {
+		throw augs::stream_read_error("Indexed demo has %x chunks but %x steps need %x.", header.num_chunks, header.num_steps, expected_chunks);
+	}
+
+	chunk_entries.resize(header.num_chunks);
+
+	for (auto& e : chunk_entries) {
+		augs::read_bytes(source, e);
+	}
+
+	chunks_begin = source.tellg();
+
+	/* 
+		Chunks are read on demand during playback.
+		Their reads are checked explicitly so that a truncated file is reported as a stream_read_error.
+	*/
+
+	source.exceptions(std::ios::goodbit);
+}
+
+void indexed_demo_reader::close() {
+	if (source.is_open()) {
+		source.close();
+	}
+
+	meta = {};
+	header = {};
+	chunk_entries.clear();
+
+	loaded_chunk = static_cast<uint32_t>(-1);
+	decoded_step_num = static_cast<demo_step_num_type>(-1);
+
+	compressed_chunk.clear();
+	decompressed_chunk.clear();
+}
+
+uint32_t indexed_demo_reader::get_steps_in_chunk(const uint32_t chunk_index) const {
+	const auto first_step = static_cast<uint64_t>(chunk_index) * header.steps_per_chunk;
+	return static_cast<uint32_t>(std::min<uint64_t>(header.steps_per_chunk, header.num_steps - first_step));
+}
+
+void indexed_demo_reader::load_chunk(const uint32_t chunk_index) {
+	if (loaded_chunk == chunk_index) {
+		return;
+	}
+
+	loaded_chunk = static_cast<uint32_t>(-1);
+
+	const auto& entry = chunk_entries.at(chunk_index);
+	const auto offsets_size = get_steps_in_chunk(chunk_index) * sizeof(uint32_t);
+
+	if (entry.uncompressed_size < offsets_size) {
+		throw augs::stream_read_error("Demo chunk %x is too small for its step table.", chunk_index);
+	}
+
+	compressed_chunk.resize(entry.compressed_size);
+
+	source.clear();
+	source.seekg(chunks_begin + static_cast<std::streamoff>(entry.offset));
+
+	if (!source) {
+		throw augs::stream_read_error("Failed to seek to demo chunk %x.", chunk_index);
+	}
+
+	const auto requested = static_cast<std::streamsize>(compressed_chunk.size());
+	source.read(reinterpret_cast<char*>(compressed_chunk.data()), requested);
+
+	if (!source || source.gcount() != requested) {
+		const auto num_read = source.gcount();
+		source.clear();
+
+		throw augs::stream_read_error("Demo chunk %x is truncated: read %x of %x bytes.", chunk_index, num_read, requested);
+	}
+
+	decompressed_chunk.resize(entry.uncompressed_size);
+	augs::decompress(compressed_chunk.data(), compressed_chunk.size(), decompressed_chunk);
+
+	loaded_chunk = chunk_index;
+}
+
+const demo_step& indexed_demo_reader::get_step(const demo_step_num_type n) {
+	if (n == decoded_step_num) {
+		return decoded_step;
+	}
+
+	if (n >= header.num_steps) {
+		throw augs::stream_read_error("Requested demo step %x out of %x.", n, header.num_steps);
+	}
+
+	const auto chunk_index = static_cast<uint32_t>(n / header.steps_per_chunk);
+	const auto index_in_chunk = static_cast<uint32_t>(n % header.steps_per_chunk);
+
+	load_chunk(chunk_index);
+
+	const auto num_steps_in_chunk = get_steps_in_chunk(chunk_index);
+	const auto offsets_size = num_steps_in_chunk * sizeof(uint32_t);
+	const auto steps_size = decompressed_chunk.size() - offsets_size;
+
+	uint32_t step_offset = 0;
+	std::memcpy(&step_offset, decompressed_chunk.data() + index_in_chunk * sizeof(uint32_t), sizeof(uint32_t));
+
+	if (step_offset >= steps_size) {
+		throw augs::stream_read_error("Demo step %x points outside of its chunk.", n);
+	}
+
+	auto s = augs::make_ptr_read_stream(
+		decompressed_chunk.data() + offsets_size + step_offset,
+		steps_size - step_offset
+	);
+
+	decoded_step_num = static_cast<demo_step_num_type>(-1);
+	decoded_step = {};
+	augs::read_bytes(s, decoded_step);
+	decoded_step_num = n;
+
+	return decoded_step;
+}
+
+void ensure_demo_replayable(const demo_file_meta& meta, const augs::path_type& path) {
+	if (meta.protocol_version != game_protocol_version_v) {
+		throw augs::stream_read_error(
+			"%x was recorded with network protocol version %x, but this game speaks version %x.", 
+			path, 
+			meta.protocol_version, 
+			game_protocol_version_v
+		);
+	}
+}
+
+/* Demos are compressed with LZ4, which can't take more in a single call nor expand any input more than 255 times. */
+
+constexpr std::size_t max_uncompressed_demo_size_v = 0x7E000000;
+constexpr std::size_t max_demo_compression_ratio_v = 255;
+
+std::size_t get_checked_uncompressed_demo_size(const demo_file_meta& meta, const std::size_t compressed_size, const augs::path_type& path) {
+	const auto declared = meta.uncompressed_size;
+	const auto limit = std::min(max_uncompressed_demo_size_v, compressed_size * max_demo_compression_ratio_v + 16);
+
+	if (declared < 0 || static_cast<uint64_t>(declared) > limit) {
+		throw augs::stream_read_error(
+			"%x declares %x uncompressed bytes, which can't come from %x compressed bytes.", 
+			path, 
+			declared, 
+			compressed_size
+		);
+	}
+
+	return static_cast<std::size_t>(declared);
+}
+
+std::size_t convert_demo_to_indexed(const augs::path_type& from, const augs::path_type& to) {
+	const auto contents = augs::file_to_bytes(from);
+
+	demo_file_meta meta;
+
+	auto source = augs::make_ptr_read_stream(contents);
+	augs::read_bytes(source, meta);
+	::ensure_demo_replayable(meta, from);
+
+	const auto pos = source.get_read_pos();
+
+	std::vector<std::byte> steps_bytes;
+
+	if (from.extension() == ".demc") {
+		const auto compressed_size = contents.size() - std::min(pos, contents.size());
+
+		steps_bytes.resize(::get_checked_uncompressed_demo_size(meta, compressed_size, from));
+
+		if (compressed_size > 0) {
+			augs::decompress(contents.data() + pos, compressed_size, steps_bytes);
+		}
+	}
+	else {
+		steps_bytes.assign(contents.begin() + pos, contents.end());
+	}
+
+	meta.uncompressed_size = 0;
+
+	auto writer = indexed_demo_writer(meta);
+
+	/* Ends of the serialized steps, to compare them with what is read back from the result. */
+	std::vector<std::size_t> step_ends;
+
+	auto s = augs::make_ptr_read_stream(steps_bytes);
+
+	try {
+		while (s.get_read_pos() < steps_bytes.size()) {
+			demo_step step;
+			augs::read_bytes(s, step);
+			writer.push(step);
+
+			step_ends.push_back(s.get_read_pos());
+		}
+	}
+	catch (const augs::stream_read_error&) {
+		/* The last step of a demo recorded during a crash might be truncated. */
+	}
+
+	if (step_ends.empty()) {
+		return 0;
+	}
+
+	writer.save(to);
+
+	/* Read every step back before anyone relies on the result, e.g. by removing the source. */
+
+	indexed_demo_reader written;
+	written.open(to);
+
+	if (written.get_num_steps() != step_ends.size()) {
+		throw augs::stream_read_error("%x has %x steps instead of %x.", to, written.get_num_steps(), step_ends.size());
+	}
+
+	std::vector<std::byte> step_bytes;
+	std::size_t step_begin = 0;
+
+	for (std::size_t i = 0; i < step_ends.size(); ++i) {
+		step_bytes.clear();
+
+		auto out = augs::ref_memory_stream(step_bytes);
+		augs::write_bytes(out, written.get_step(static_cast<demo_step_num_type>(i)));
+
+		const auto step_end = step_ends[i];
+
+		const bool same = 
+			step_bytes.size() == step_end - step_begin
+			&& std::equal(step_bytes.begin(), step_bytes.end(), steps_bytes.begin() + step_begin)
+		;
+
+		if (!same) {
+			throw augs::stream_read_error("Step %x of %x differs from the source.", i, to);
+		}
+
+		step_begin = step_end;
+	}
+
+	return step_ends.size();
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/filesystem/temporary_directory.h"
+
+static auto make_test_demo_steps(const std::size_t n) {
+	std::vector<demo_step> steps;
+	steps.resize(n);
+
+	for (std::size_t i = 0; i < steps.size(); ++i) {
+		for (std::size_t m = 0; m < i % 3; ++m) {
+			auto& msg = steps[i].serialized_messages.emplace_back();
+			msg.resize(4 + i % 17, static_cast<std::byte>(i + m));
+		}
+	}
+
+	return steps;
+}
+
+TEST_CASE("IndexedDemo RandomAccess") {
+	const auto dir = augs::temporary_directory("indexed_demo");
+	const auto path = dir / "test.demi";
+
+	const auto steps = make_test_demo_steps(1000);
+
+	demo_file_meta meta;
+	meta.server_name = "test";
+
+	{
+		auto writer = indexed_demo_writer(meta, 64);
+
+		for (const auto& s : steps) {
+			writer.push(s);
+		}
+
+		writer.save(path);
+	}
+
+	indexed_demo_reader reader;
+	reader.open(path);
+
+	REQUIRE(reader.get_num_steps() == steps.size());
+	REQUIRE(reader.get_meta().server_name == meta.server_name);
+
+	auto same_step = [&](const demo_step_num_type n) {
+		return reader.get_step(n).serialized_messages == steps[n].serialized_messages;
+	};
+
+	for (demo_step_num_type n = 0; n < steps.size(); ++n) {
+		REQUIRE(same_step(n));
+	}
+
+	REQUIRE(same_step(999));
+	REQUIRE(same_step(3));
+	REQUIRE(same_step(640));
+	REQUIRE(same_step(63));
+
+	REQUIRE_THROWS_AS(reader.get_step(1000), augs::stream_read_error);
+
+	reader.close();
+
+	{
+		/* Chunks at the end of a truncated file must be reported, not read past the end. */
+
+		auto bytes = augs::file_to_bytes(path);
+		bytes.resize(bytes.size() - 10);
+		augs::bytes_to_file(bytes, path);
+
+		reader.open(path);
+
+		REQUIRE(same_step(0));
+		REQUIRE_THROWS_AS(reader.get_step(999), augs::stream_read_error);
+
+		reader.close();
+	}
+}
+
+TEST_CASE("IndexedDemo ConvertRecorded") {
+	const auto dir = augs::temporary_directory("indexed_demo_convert");
+
+	demo_file_meta meta;
+	meta.server_name = "recorded";
+
+	const auto steps = make_test_demo_steps(300);
+
+	auto write_recorded = [&](const augs::path_type& path, const std::size_t num_steps, const std::size_t num_trailing_bytes) {
+		std::vector<std::byte> bytes;
+		auto out = augs::ref_memory_stream(bytes);
+
+		augs::write_bytes(out, meta);
+
+		for (std::size_t i = 0; i < num_steps; ++i) {
+			augs::write_bytes(out, steps[i]);
+		}
+
+		/* What a crash in the middle of recording a step would leave behind. */
+		bytes.resize(bytes.size() + num_trailing_bytes, std::byte(0xff));
+
+		augs::bytes_to_file(bytes, path);
+	};
+
+	{
+		const auto from = dir / "full.dem";
+		const auto to = dir / "full.demi";
+
+		write_recorded(from, steps.size(), 3);
+
+		REQUIRE(::convert_demo_to_indexed(from, to) == steps.size());
+
+		indexed_demo_reader reader;
+		reader.open(to);
+
+		REQUIRE(reader.get_meta().server_name == meta.server_name);
+		REQUIRE(reader.get_num_steps() == steps.size());
+
+		for (demo_step_num_type n = 0; n < steps.size(); ++n) {
+			REQUIRE(reader.get_step(n).serialized_messages == steps[n].serialized_messages);
+		}
+	}
+
+	{
+		/* A recording without any steps is kept as it is. */
+
+		const auto from = dir / "empty.dem";
+		const auto to = dir / "empty.demi";
+
+		write_recorded(from, 0, 0);
+
+		REQUIRE(::convert_demo_to_indexed(from, to) == 0);
+		REQUIRE(!augs::exists(to));
+	}
+
+	{
+		const auto from = dir / "broken.dem";
+		augs::bytes_to_file(std::vector<std::byte>(2, std::byte(0)), from);
+
+		REQUIRE_THROWS(::convert_demo_to_indexed(from, dir / "broken.demi"));
+	}
+
+	{
+		/* Demos of builds speaking another protocol are rejected, not misread. */
+
+		const auto from = dir / "other_protocol.dem";
+		const auto to = dir / "other_protocol.demi";
+
+		meta.protocol_version = game_protocol_version_v + 1;
+		write_recorded(from, steps.size(), 0);
+
+		REQUIRE_THROWS_AS(::convert_demo_to_indexed(from, to), augs::stream_read_error);
+		REQUIRE(!augs::exists(to));
+
+		{
+			auto writer = indexed_demo_writer(meta);
+			writer.push(steps[0]);
+			writer.save(to);
+		}
+
+		indexed_demo_reader reader;
+		REQUIRE_THROWS_AS(reader.open(to), augs::stream_read_error);
+
+		meta.protocol_version = game_protocol_version_v;
+	}
+
+	auto write_compressed = [&](const augs::path_type& path, const int64_t declared_size) {
+		std::vector<std::byte> steps_bytes;
+
+		{
+			auto out = augs::ref_memory_stream(steps_bytes);
+
+			for (const auto& s : steps) {
+				augs::write_bytes(out, s);
+			}
+		}
+
+		auto state = augs::make_compression_state();
+		const auto compressed = augs::compress(state, steps_bytes);
+
+		auto compressed_meta = meta;
+		compressed_meta.uncompressed_size = declared_size < 0 ? static_cast<int64_t>(steps_bytes.size()) : declared_size;
+
+		std::vector<std::byte> bytes;
+		auto out = augs::ref_memory_stream(bytes);
+
+		augs::write_bytes(out, compressed_meta);
+		bytes.insert(bytes.end(), compressed.begin(), compressed.end());
+
+		augs::bytes_to_file(bytes, path);
+	};
+
+	{
+		const auto from = dir / "compressed.demc";
+		const auto to = dir / "compressed.demi";
+
+		write_compressed(from, -1);
+
+		REQUIRE(::convert_demo_to_indexed(from, to) == steps.size());
+	}
+
+	{
+		/* A size no compressed stream could expand to is rejected before it is allocated. */
+
+		const auto from = dir / "oversized.demc";
+
+		write_compressed(from, std::numeric_limits<int64_t>::max());
+		REQUIRE_THROWS_AS(::convert_demo_to_indexed(from, dir / "oversized.demi"), augs::stream_read_error);
+
+		write_compressed(from, -5);
+		REQUIRE_THROWS_AS(::convert_demo_to_indexed(from, dir / "oversized.demi"), augs::stream_read_error);
+	}
+}
+#endif
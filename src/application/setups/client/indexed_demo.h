@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+#include "augs/filesystem/path_declaration.h"
+#include "application/setups/client/demo_file.h"
+#include "application/setups/client/demo_step.h"
+
+/*
+	Indexed demo container (.demi).
+
+	Steps are grouped into chunks of a fixed number of steps and every chunk is compressed separately.
+	The chunk table that precedes the chunks lets the reader jump to any step
+	by reading and decompressing a single chunk,
+	so a demo never has to reside in memory as a whole, regardless of its length.
+
+	Layout:
+		demo_file_meta
+		indexed_demo_header
+		indexed_demo_chunk_entry[num_chunks]
+		compressed chunks
+
+	A decompressed chunk begins with a table of uint32_t offsets of its steps,
+	followed by the byte-serialized steps themselves.
+*/
+
+constexpr uint32_t indexed_demo_magic_v = 0x494d4544;
+constexpr uint32_t indexed_demo_version_v = 1;
+constexpr uint32_t default_steps_per_demo_chunk_v = 256;
+
+struct indexed_demo_header {
+	uint32_t magic = indexed_demo_magic_v;
+	uint32_t version = indexed_demo_version_v;
+	uint32_t steps_per_chunk = default_steps_per_demo_chunk_v;
+	uint32_t num_chunks = 0;
+	uint64_t num_steps = 0;
+};
+
+struct indexed_demo_chunk_entry {
+	/* Relative to the beginning of the first chunk. */
+	uint64_t offset = 0;
+	uint32_t compressed_size = 0;
+	uint32_t uncompressed_size = 0;
+};
+
+class indexed_demo_writer {
+	demo_file_meta meta;
+	indexed_demo_header header;
+
+	std::vector<indexed_demo_chunk_entry> chunk_entries;
+	std::vector<std::byte> compressed_chunks;
+
+	std::vector<uint32_t> pending_offsets;
+	std::vector<std::byte> pending_steps;
+	std::vector<std::byte> pending_chunk;
+	std::vector<std::byte> compression_state;
+
+	void flush_chunk();
+
+public:
+	indexed_demo_writer(const demo_file_meta& meta, uint32_t steps_per_chunk = default_steps_per_demo_chunk_v);
+
+	void push(const demo_step&);
+	void save(const augs::path_type&);
+};
+
+class indexed_demo_reader {
+	std::ifstream source;
+	std::streamoff chunks_begin = 0;
+
+	demo_file_meta meta;
+	indexed_demo_header header;
+	std::vector<indexed_demo_chunk_entry> chunk_entries;
+
+	/* Only the most recently read chunk is kept in memory. */
+	uint32_t loaded_chunk = static_cast<uint32_t>(-1);
+	std::vector<std::byte> compressed_chunk;
+	std::vector<std::byte> decompressed_chunk;
+
+	demo_step_num_type decoded_step_num = static_cast<demo_step_num_type>(-1);
+	demo_step decoded_step;
+
+	uint32_t get_steps_in_chunk(uint32_t chunk_index) const;
+	void load_chunk(uint32_t chunk_index);
+
+public:
+	void open(const augs::path_type&);
+	void close();
+
+	bool is_open() const {
+		return source.is_open();
+	}
+
+	const demo_file_meta& get_meta() const {
+		return meta;
+	}
+
+	std::size_t get_num_steps() const {
+		return static_cast<std::size_t>(header.num_steps);
+	}
+
+	/* The returned reference stays valid until the next call. */
+	const demo_step& get_step(demo_step_num_type);
+};
+
+/*
+	Converts either a raw demo that was being recorded (.dem)
+	or a demo compressed as a whole (.demc) into the indexed format.
+
+	Every step of the result is read back and compared with the source,
+	so once this returns, the source is safe to remove.
+	Returns the number of converted steps. A demo without any steps is not written at all.
+	Throws if the source can't be read or the result doesn't match it.
+*/
+
+std::size_t convert_demo_to_indexed(const augs::path_type& from, const augs::path_type& to);
+
+/* Throws if the demo was recorded by a build speaking a different network protocol. */
+void ensure_demo_replayable(const demo_file_meta&, const augs::path_type&);
+
+/* 
+	The uncompressed size that a .demc declares, checked before anything is allocated for it.
+	Throws if no compressed stream of that many bytes could have produced it.
+*/
+
+std::size_t get_checked_uncompressed_demo_size(const demo_file_meta&, std::size_t compressed_size, const augs::path_type&);
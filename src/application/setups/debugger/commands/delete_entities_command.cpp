@@ -15,7 +15,15 @@ std::string delete_entities_command::describe() const {
 void delete_entities_command::push_entry(const const_entity_handle handle) {
 	handle.dispatch([&](const auto typed_handle) {
 		using E = entity_type_of<decltype(typed_handle)>;
-		deleted_entities.get_for<E>().push_back({ typed_handle.get(), handle.get_id(), {} });
+
+		auto& entry = deleted_entities.get_for<E>().emplace_back();
+		entry.content = typed_handle.get();
+		entry.id = handle.get_id();
+
+		for_each_through_std_get(entry.split_content, [&](auto& c) {
+			using C = remove_cref<decltype(c)>;
+			c = typed_handle.template get_raw_component<C>();
+		});
 	});
 
 	deleted_grouping.push_entry(handle.get_id());
@@ -56,7 +64,7 @@ void delete_entities_command::undo(const debugger_command_input in) {
 		*/
 
 		deleted_entities.for_each_reverse([&](const auto& e) {
-			const auto undeleted = cosmic::undo_delete_entity(cosm, e.undo_delete_input, e.content, reinference_type::NONE);
+			const auto undeleted = cosmic::undo_delete_entity(cosm, e.undo_delete_input, e.content, e.split_content, reinference_type::NONE);
 			selections.emplace(undeleted.get_id());
 		});
 	}
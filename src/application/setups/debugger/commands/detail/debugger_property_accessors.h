@@ -133,7 +133,7 @@ struct debugger_property_accessors {
 							auto specific_handle = cosm[typed_entity_id<E>(e)];
 
 							const auto result = on_field_address(
-								std::get<Component>(specific_handle.get({}).component_state),
+								specific_handle.template get_raw_component<Component>({}),
 								self.field,
 								[&](auto& resolved_field) -> callback_result {
 									return callback(resolved_field);
@@ -0,0 +1,181 @@
+#include "application/setups/server/arena_file_store.h"
+#include "augs/misc/compress.h"
+#include "augs/filesystem/file.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/templates/container_templates.h"
+#include "augs/log.h"
+
+arena_file_store& arena_file_store::get_instance() {
+	static arena_file_store instance;
+	return instance;
+}
+
+template <class B>
+static bool hashes_to(const B& file_bytes, const augs::secure_hash_type& hash) {
+	return augs::secure_hash(augs::crlf_to_lf_string(file_bytes)) == hash;
+}
+
+static bool stored_file_hashes_to(const stored_arena_file& file, const augs::secure_hash_type& hash) {
+	if (!file.is_compressed()) {
+		return hashes_to(file, hash);
+	}
+
+	try {
+		auto decompressed = std::vector<std::byte>(file.get_num_uncompressed_bytes());
+		augs::decompress(file.data(), file.size(), decompressed);
+
+		return hashes_to(decompressed, hash);
+	}
+	catch (const augs::decompression_error&) {
+		return false;
+	}
+}
+
+std::shared_ptr<const stored_arena_file> arena_file_store::open(
+	const augs::secure_hash_type& hash,
+	const augs::path_type& path,
+	const bool verify
+) {
+	std::shared_ptr<const stored_arena_file> unverified;
+
+	{
+		std::scoped_lock lock(lk);
+
+		if (const auto found = mapped_or_nullptr(files, hash)) {
+			if (auto existing = found->file.lock()) {
+				if (!verify || found->verified) {
+					return existing;
+				}
+
+				unverified = std::move(existing);
+			}
+		}
+	}
+
+	/*
+		Read, verify and compress without holding the lock,
+		so that other instances aren't stalled by a large file.
+	*/
+
+	if (unverified != nullptr) {
+		/* Verify the very bytes that are sent, rather than whatever is on disk now. */
+
+		if (stored_file_hashes_to(*unverified, hash)) {
+			std::scoped_lock lock(lk);
+
+			if (const auto found = mapped_or_nullptr(files, hash)) {
+				if (found->file.lock() == unverified) {
+					found->verified = true;
+				}
+			}
+
+			return unverified;
+		}
+	}
+
+	auto file_bytes = augs::file_to_bytes(path);
+
+	if (file_bytes.empty()) {
+		return nullptr;
+	}
+
+	if (verify && !hashes_to(file_bytes, hash)) {
+		return nullptr;
+	}
+
+	auto new_file = std::make_shared<stored_arena_file>();
+	new_file->num_uncompressed_bytes = static_cast<uint32_t>(file_bytes.size());
+
+	{
+		auto state = augs::make_compression_state();
+		auto compressed_bytes = augs::compress(state, file_bytes);
+
+		new_file->compressed = compressed_bytes.size() < file_bytes.size();
+		new_file->bytes = new_file->compressed ? std::move(compressed_bytes) : std::move(file_bytes);
+	}
+
+	new_file->bytes.shrink_to_fit();
+
+	LOG("Opened %x for direct downloads. Size: %x, sent in chunks: %x.", path, new_file->num_uncompressed_bytes, new_file->size());
+
+	std::scoped_lock lock(lk);
+
+	erase_if(files, [](const auto& entry) {
+		return entry.second.file.expired();
+	});
+
+	auto& stored = files[hash];
+
+	if (auto opened_in_the_meantime = stored.file.lock()) {
+		if (!verify || stored.verified) {
+			return opened_in_the_meantime;
+		}
+	}
+
+	/*
+		Instances that already hold a file which turned out not to match keep sending it,
+		but from now on everyone gets the verified one.
+	*/
+
+	stored.file = new_file;
+	stored.verified = verify;
+
+	return new_file;
+}
+
+arena_file_store_stats arena_file_store::get_stats() const {
+	arena_file_store_stats stats;
+
+	std::scoped_lock lock(lk);
+
+	for (const auto& entry : files) {
+		if (const auto file = entry.second.file.lock()) {
+			++stats.num_files;
+
+			if (file->is_compressed()) {
+				stats.compressed_bytes += file->size();
+			}
+			else {
+				stats.uncompressed_bytes += file->size();
+			}
+		}
+	}
+
+	return stats;
+}
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/filesystem/temporary_directory.h"
+
+TEST_CASE("ArenaFileStore VerifyOnDemand") {
+	const auto temp = augs::temporary_directory("arena_file_store");
+	const auto path = temp / "arena.json";
+
+	const auto contents = std::string("{ \"arena\": 1 }\r\n");
+	augs::save_as_text(path, contents);
+
+	const auto hash = augs::secure_hash(augs::crlf_to_lf_string(contents));
+	const auto other_hash = augs::secure_hash(std::string("other"));
+
+	auto& store = arena_file_store::get_instance();
+
+	/* Stored without verifying under a hash that the file does not have. */
+
+	const auto mismatched = store.open(other_hash, path, false);
+
+	REQUIRE(mismatched != nullptr);
+	REQUIRE(store.open(other_hash, path, false) == mismatched);
+	REQUIRE(store.open(other_hash, path, true) == nullptr);
+
+	/* Verified once, after which the file on disk is not needed anymore. */
+
+	const auto unverified = store.open(hash, path, false);
+
+	REQUIRE(store.open(hash, path, true) == unverified);
+
+	augs::remove_file(path);
+
+	REQUIRE(store.open(hash, path, true) == unverified);
+}
+#endif
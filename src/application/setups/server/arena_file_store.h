@@ -0,0 +1,96 @@
+#pragma once
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include "augs/misc/secure_hash.h"
+#include "augs/filesystem/path_declaration.h"
+
+/*
+	Arena file opened for direct downloads, exactly as it is sent in chunks.
+
+	If compression makes the file smaller, only the compressed bytes are kept.
+	Otherwise the file is kept as it was read.
+
+	The bytes are always owned rather than mapped,
+	so the file on disk may be changed or removed while it is being sent.
+*/
+
+class stored_arena_file {
+	friend class arena_file_store;
+
+	std::vector<std::byte> bytes;
+	bool compressed = false;
+	uint32_t num_uncompressed_bytes = 0;
+
+public:
+	bool is_compressed() const {
+		return compressed;
+	}
+
+	const std::byte* data() const {
+		return bytes.data();
+	}
+
+	std::size_t size() const {
+		return bytes.size();
+	}
+
+	uint32_t get_num_uncompressed_bytes() const {
+		return num_uncompressed_bytes;
+	}
+};
+
+struct arena_file_store_stats {
+	uint32_t num_files = 0;
+	std::size_t uncompressed_bytes = 0;
+	std::size_t compressed_bytes = 0;
+};
+
+/*
+	Process-wide store of the arena files that are being downloaded.
+
+	A multi-instance dedicated server runs many server_setups in one process,
+	usually on the same map rotation.
+	With this store a file is read and compressed once, however many instances serve it.
+
+	Files are keyed by their secure hash and shared by reference counting.
+	A file is dropped as soon as the last instance lets go of it.
+*/
+
+class arena_file_store {
+	struct entry {
+		std::weak_ptr<const stored_arena_file> file;
+
+		/* Whether the stored bytes were found to hash to the key. */
+		bool verified = false;
+	};
+
+	mutable std::mutex lk;
+	std::unordered_map<augs::secure_hash_type, entry> files;
+
+	arena_file_store() = default;
+
+public:
+	static arena_file_store& get_instance();
+
+	/*
+		Returns the file already stored under this hash, or opens the one at the path.
+
+		If verify is set, the returned file must hash to the requested hash (with CRLFs converted to LFs),
+		as this is how arena project files are hashed.
+		A file that another instance opened without verifying is verified now, once.
+		Returns nullptr if the file is empty or out of date.
+
+		Throws augs::file_open_error if the file could not be read.
+	*/
+
+	std::shared_ptr<const stored_arena_file> open(
+		const augs::secure_hash_type& hash,
+		const augs::path_type& path,
+		bool verify
+	);
+
+	arena_file_store_stats get_stats() const;
+};
@@ -8,6 +8,9 @@ struct file_download_link_payload {
 
 struct file_download_payload {
 	uint32_t num_file_bytes = 0;
+
+	/* If nonzero, chunks carry the file compressed down to this many bytes. */
+	uint32_t num_compressed_bytes = 0;
 };
 
 struct file_chunks_request_payload {
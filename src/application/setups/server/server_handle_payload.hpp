@@ -52,6 +52,19 @@ message_handler_result server_setup::handle_payload(
 			even outside of the PENDING_WELCOME state
 		*/
 
+		if (payload.protocol_version != game_protocol_version_v) {
+			LOG("Client speaks network protocol %x instead of %x. Kicking.", payload.protocol_version, game_protocol_version_v);
+
+			const auto reason = typesafe_sprintf(
+				"Your game speaks network protocol version %x,\nbut this server speaks version %x.\nPlease update your game or choose a different server.",
+				payload.protocol_version,
+				game_protocol_version_v
+			);
+
+			kick(client_id, reason);
+			return abort_v;
+		}
+
 		auto& new_nick = payload.chosen_nickname;
 		LOG("Received requested_client_settings from %x. Client state: %x", new_nick, c.state);
 
@@ -446,28 +459,23 @@ message_handler_result server_setup::handle_payload(
 		};
 
 		if (const auto found_file = mapped_or_nullptr(arena_files_database, payload.requested_file_hash)) {
-			auto& file_bytes = found_file->cached_file;
-
-			if (file_bytes.empty()) {
+			if (found_file->opened_file == nullptr) {
 				try {
-					file_bytes = augs::file_to_bytes(found_file->path);
-
 					const auto requested = payload.requested_file_hash;
+					const bool asking_current_arena = current_arena_hash == requested;
 
-					if (const bool asking_current_arena = current_arena_hash == requested) {
-						const auto actual = augs::secure_hash(augs::crlf_to_lf_string(file_bytes));
-
-						if (const bool current_arena_is_out_of_date = requested != actual) {
-							file_bytes.clear();
+					augs::timer cpu_timer;
+					auto opened = arena_file_store::get_instance().open(requested, found_file->path, asking_current_arena);
+					file_transfer_cpu_secs_since_measured += cpu_timer.get<std::chrono::seconds>();
 
-							broadcast_info("Files changed on the server. Reloading arena.");
-							rechoose_arena();
-							rebroadcast_server_public_vars();
-						}
+					if (opened != nullptr) {
+						found_file->opened_file = std::move(opened);
+						opened_arena_files.emplace(requested);
 					}
-
-					if (!file_bytes.empty()) {
-						opened_arena_files.emplace(payload.requested_file_hash);
+					else if (const bool current_arena_is_out_of_date = asking_current_arena) {
+						broadcast_info("Files changed on the server. Reloading arena.");
+						rechoose_arena();
+						rebroadcast_server_public_vars();
 					}
 				}
 				catch (...) {
@@ -476,7 +484,7 @@ message_handler_result server_setup::handle_payload(
 				}
 			}
 
-			if (const bool canceled = file_bytes.empty()) {
+			if (const bool canceled = found_file->opened_file == nullptr) {
 				set_client_is_downloading_files(client_id, c, downloading_type::DIRECTLY);
 
 				file_download_payload sent_file_payload;
@@ -497,8 +505,11 @@ message_handler_result server_setup::handle_payload(
 				c.now_downloading_file = payload.requested_file_hash;
 				c.direct_file_chunks_left = 0;
 
+				const auto& opened = *found_file->opened_file;
+
 				file_download_payload sent_file_payload;
-				sent_file_payload.num_file_bytes = file_bytes.size();
+				sent_file_payload.num_file_bytes = opened.get_num_uncompressed_bytes();
+				sent_file_payload.num_compressed_bytes = opened.is_compressed() ? uint32_t(opened.size()) : 0;
 
 				server->send_payload(
 					client_id, 
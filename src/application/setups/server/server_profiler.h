@@ -11,6 +11,7 @@ struct server_profiler : public augs::profiler_mixin<server_profiler> {
 	augs::time_measurements solve_simulation;
 	augs::time_measurements send_entropies;
 	augs::time_measurements send_packets;
+	augs::time_measurements tick_lateness;
 	// END GEN INTROSPECTOR
 };
 
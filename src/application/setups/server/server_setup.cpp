@@ -1,8 +1,11 @@
 #include "augs/misc/date_time.h"
+#include "augs/misc/trace_recorder.h"
+#include "augs/log_path_getters.h"
 #include "augs/misc/pool/pool_io.hpp"
 #include "augs/misc/imgui/imgui_scope_wrappers.h"
 #include "augs/misc/imgui/imgui_control_wrappers.h"
 #include "augs/misc/compress.h"
+#include "augs/misc/timing/timer.h"
 #include "augs/string/parse_url.h"
 
 #include "application/setups/server/server_setup.h"
@@ -684,7 +687,6 @@ server_setup::server_setup(
 ) : 
 	integrated_client_vars(integrated_client_vars),
 	official(official),
-	last_loaded_project(std::make_unique<editor_project>()),
 	last_start(in),
 	assigned_teams(assigned_teams),
 	dedicated(dedicated),
@@ -2390,6 +2392,14 @@ bool server_setup::apply(const server_vars& new_vars, const bool first_time) {
 		shuffled_cycle_indices.clear();
 	}
 
+	{
+		auto wants_trace = [](const server_vars& v) {
+			return v.record_performance_trace || v.dump_performance_trace_if_step_exceeds_ms > 0.f;
+		};
+
+		trace.set_enabled(wants_trace(new_vars));
+	}
+
 	bool chosen_next_area = false;
 
 	const auto previous_arena = vars.arena;
@@ -2506,22 +2516,13 @@ void server_setup::apply_nonzoomedout_visible_world_area(const vec2 area) {
 }
 
 void register_external_resources_of(
-	const editor_project& project,
+	const editor_project_readwrite::external_resource_database& external_resources,
 	const augs::path_type& arena_folder_path,
 	arena_files_database_type& database
 ) {
-	project.resources.pools.for_each_container(
-		[&]<typename P>(const P& pool) {
-			using R = typename P::mapped_type;
-
-			if constexpr(is_pathed_resource_v<R>) {
-				for (auto& resource : pool) {
-					const auto& file = resource.external_file;
-					database[augs::to_secure_hash_byte_format(file.file_hash)] = { arena_folder_path / file.path_in_project, {} };
-				}
-			}
-		}
-	);
+	for (const auto& [path_in_project, file_hash] : external_resources) {
+		database[file_hash] = { arena_folder_path / path_in_project, {} };
+	}
 }
 
 void server_setup::rechoose_arena() {
@@ -2538,7 +2539,7 @@ void server_setup::rechoose_arena() {
 			vars.game_mode,
 			clean_round_state,
 			vars.playtesting_context,
-			std::addressof(*last_loaded_project),
+			nullptr,
 			nullptr
 		});
 
@@ -2550,7 +2551,7 @@ void server_setup::rechoose_arena() {
 		LOG("Chosen arena hash: %x", current_arena_hash);
 
 		::register_external_resources_of(
-			*last_loaded_project,
+			result.external_resources,
 			current_arena_folder,
 			arena_files_database
 		);
@@ -3369,6 +3370,11 @@ message_handler_result server_setup::handle_rcon_payload(
 
 				return continue_v;
 
+			case command::DUMP_PERFORMANCE_TRACE:
+				dump_performance_trace("rcon's request");
+
+				return continue_v;
+
 			default:
 				LOG("Unsupported rcon command.");
 				return continue_v;
@@ -3554,6 +3560,7 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 	networked_server_step_entropy total;
 	total.payload = total_input;
 	total.meta.reinference_necessary = reinference_necessary;
+	total.meta.wide_state_hash = vars.wide_state_hash;
 	total.meta.state_hash = [&]() -> decltype(total.meta.state_hash) {
 		auto& ticks_remaining = ticks_until_sending_hash;
 
@@ -3561,13 +3568,16 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 			ticks_remaining = vars.state_hash_once_every_tick;
 			--ticks_remaining;
 
-			const auto calculated_hash = get_arena_handle().get_cosmos().calculate_solvable_signi_hash<uint32_t>();
+			const auto calculated_hash = get_arena_handle().get_cosmos().calculate_solvable_signi_hash<uint32_t>(vars.wide_state_hash);
 			return calculated_hash;
 		}
 
 		return std::nullopt;
 	}();
 
+	/* Everything but the per-client context is serialized only once and shared by all messages. */
+	const auto shared = net_messages::preserialize_step_entropy(total);
+
 	auto send_total_entropy = [&](const auto client_id, auto& c) {
 		if (c.should_pause_solvable_stream()) {
 			return;
@@ -3581,24 +3591,18 @@ void server_setup::send_server_step_entropies(const compact_server_step_entropy&
 			return;
 		}
 
-		{
-			{
-				auto context = prestep_client_context();
-				context.num_entropies_accepted = c.num_entropies_accepted;
+		auto context = prestep_client_context();
+		context.num_entropies_accepted = c.num_entropies_accepted;
 
-				total.context = context;
-			}
-
-			/* Reset the counter */
-			c.num_entropies_accepted = 0;
-		}
+		/* Reset the counter */
+		c.num_entropies_accepted = 0;
 
-		/* TODO PERFORMANCE: only serialize the message once and multicast the same buffer to all clients! */
 		server->send_payload(
 			client_id,
 			game_channel_type::RELIABLE_MESSAGES,
 
-			total
+			context,
+			shared
 		);
 	};
 
@@ -3645,8 +3649,12 @@ void server_setup::clean_unused_cached_files() {
 bool server_setup::send_file_chunk(const client_id_type client_id, const arena_files_database_entry& entry, const file_chunk_index_type chunk_index) {
 	const auto& c = clients[client_id];
 
-	const auto& bytes = entry.cached_file;
-	const auto bytes_n = bytes.size();
+	if (entry.opened_file == nullptr) {
+		return false;
+	}
+
+	const auto bytes = entry.opened_file->data();
+	const auto bytes_n = entry.opened_file->size();
 
 	auto num_all_chunks = bytes_n / file_chunk_size_v;
 
@@ -3675,25 +3683,83 @@ bool server_setup::send_file_chunk(const client_id_type client_id, const arena_f
 		const auto bytes_copied = bytes_end - bytes_start;
 
 		if (bytes_copied != 0) {
-			std::memcpy(packet.chunk_bytes.data(), bytes.data() + bytes_start, bytes_copied);
+			std::memcpy(packet.chunk_bytes.data(), bytes + bytes_start, bytes_copied);
 		}
 
-		if (auto s = find_underlying_socket()) {
-			auto address = to_netcode_addr(get_client_address(client_id));
+		if (find_underlying_socket() != nullptr) {
+			/* Queued until flush_file_chunks so that all chunks of a tick go out in one batch. */
+			pending_file_chunks.push_back({ to_netcode_addr(get_client_address(client_id)), packet });
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void server_setup::flush_file_chunks() {
+	if (pending_file_chunks.empty()) {
+		return;
+	}
+
+	augs::timer cpu_timer;
+
+	if (auto s = find_underlying_socket()) {
+		const auto num_packet_bytes = int(sizeof(file_chunk_packet));
 
-			const auto num_packet_bytes = sizeof(packet);
-			// LOG("sending chunk %x to %x (%x bytes). CMD: %x", chunk_index, ::ToString(address), num_packet_bytes, packet.command);
-			auto socket = *s;
+		for (auto& pending : pending_file_chunks) {
+			const auto packet_bytes = reinterpret_cast<const std::byte*>(&pending.packet);
+			// LOG("sending chunk %x to %x (%x bytes). CMD: %x", pending.packet.index, ::ToString(pending.to), num_packet_bytes, pending.packet.command);
 
-			if (!send_packet_override(address, reinterpret_cast<std::byte*>(&packet), num_packet_bytes)) {
-				netcode_socket_send_packet(&socket, &address, reinterpret_cast<void*>(&packet), num_packet_bytes);
+			if (!send_packet_override(pending.to, packet_bytes, num_packet_bytes)) {
+				file_chunks_batch.push(pending.to, packet_bytes, num_packet_bytes);
 			}
+		}
 
-			return true;
+		file_chunks_batch.send(*s);
+	}
+
+	file_chunks_sent_since_measured += static_cast<uint32_t>(pending_file_chunks.size());
+	pending_file_chunks.clear();
+
+	file_transfer_cpu_secs_since_measured += cpu_timer.get<std::chrono::seconds>();
+}
+
+void server_setup::measure_file_transfers() {
+	const auto measure_once_every_secs = 1.0;
+	const auto elapsed = server_time - when_last_measured_file_transfers;
+
+	if (elapsed < measure_once_every_secs) {
+		return;
+	}
+
+	uint32_t num_downloaders = 0;
+
+	for_each_id_and_client([&num_downloaders](const auto, auto& c){
+		if (c.downloading_status == downloading_type::DIRECTLY) {
+			++num_downloaders;
 		}
+	}, connected_and_integrated_v);
+
+	auto& stats = file_transfer_stats;
+	stats = {};
+
+	if (num_downloaders > 0 && elapsed < measure_once_every_secs * 2) {
+		const auto per_downloader_per_sec = 1.0 / (num_downloaders * elapsed);
+
+		stats.num_direct_downloaders = num_downloaders;
+		stats.file_chunks_per_second_per_downloader = float(file_chunks_sent_since_measured * per_downloader_per_sec);
+		stats.file_transfer_cpu_ms_per_downloader = float(1000 * file_transfer_cpu_secs_since_measured * per_downloader_per_sec);
 	}
 
-	return false;
+	const auto store_stats = arena_file_store::get_instance().get_stats();
+
+	stats.num_stored_arena_files = store_stats.num_files;
+	stats.stored_arena_files_uncompressed_bytes = store_stats.uncompressed_bytes;
+	stats.stored_arena_files_compressed_bytes = store_stats.compressed_bytes;
+
+	when_last_measured_file_transfers = server_time;
+	file_chunks_sent_since_measured = 0;
+	file_transfer_cpu_secs_since_measured = 0.0;
 }
 
 file_chunk_index_type server_setup::calc_num_chunks_per_tick_per_downloader() const {
@@ -3839,8 +3905,24 @@ void server_setup::sleep_until_next_tick() {
 	}
 }
 
+net_time_t server_setup::get_next_tick_time() const {
+	return server_time;
+}
+
+void server_setup::delay_next_tick_by(const net_time_t secs) {
+	server_time += secs;
+}
+
 void server_setup::update_stats(server_network_info& info) const {
 	info = server->get_server_network_info();
+
+	info.num_direct_downloaders = file_transfer_stats.num_direct_downloaders;
+	info.file_chunks_per_second_per_downloader = file_transfer_stats.file_chunks_per_second_per_downloader;
+	info.file_transfer_cpu_ms_per_downloader = file_transfer_stats.file_transfer_cpu_ms_per_downloader;
+
+	info.num_stored_arena_files = file_transfer_stats.num_stored_arena_files;
+	info.stored_arena_files_uncompressed_bytes = file_transfer_stats.stored_arena_files_uncompressed_bytes;
+	info.stored_arena_files_compressed_bytes = file_transfer_stats.stored_arena_files_compressed_bytes;
 }
 
 server_client_state* server_setup::find_client_state(const mode_player_id id) {
@@ -4374,6 +4456,68 @@ void server_setup::reset_player_meta_to_default(const mode_player_id&) {
 	rebuild_player_meta_viewables = true;
 }
 
+void server_setup::dump_performance_trace(const std::string& reason) {
+	if (!trace.is_enabled()) {
+		LOG("Performance trace requested (%x), but recording is disabled. Set record_performance_trace first.", reason);
+		return;
+	}
+
+	if (trace_dump_job.valid() && trace_dump_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		LOG("Performance trace requested (%x), but the previous one is still being written.", reason);
+		return;
+	}
+
+	const auto path = augs::path_type(get_path_in_log_files(augs::trace_recorder::make_dump_file_name(typesafe_sprintf("server_%x", last_start.port))));
+
+	/* Only copying the events has to happen here. Formatting and writing them would stall the step. */
+
+	trace_dump_job = std::async(
+		std::launch::async,
+		[snapshot = trace.take_snapshot(), path, reason]() {
+			try {
+				const auto num_events = augs::trace_recorder::write_chrome_trace(snapshot, path);
+				LOG("Dumped %x trace events due to %x: %x", num_events, reason, path);
+			}
+			catch (const augs::file_open_error& err) {
+				LOG("Failed to dump the performance trace: %x", err.what());
+			}
+		}
+	);
+}
+
+void server_setup::dump_performance_trace_if_step_was_long() {
+	const auto threshold_ms = vars.dump_performance_trace_if_step_exceeds_ms;
+
+	if (threshold_ms <= 0.f) {
+		return;
+	}
+
+	const auto num_steps = profiler.step.get_num_measurements();
+
+	if (num_steps == last_checked_step_for_trace) {
+		return;
+	}
+
+	last_checked_step_for_trace = num_steps;
+
+	const auto step_ms = 1000 * profiler.step.get_last_measurement_units();
+
+	if (step_ms <= threshold_ms) {
+		return;
+	}
+
+	/* A single hitch tends to come with a few more long steps, so don't dump each of them. */
+
+	const auto min_secs_between_dumps = 10.0;
+
+	if (last_dumped_trace_at != 0 && server_time - last_dumped_trace_at < min_secs_between_dumps) {
+		return;
+	}
+
+	last_dumped_trace_at = server_time;
+	dump_performance_trace(typesafe_sprintf("a step of %2f ms", step_ms));
+}
+
 void server_setup::log_performance() {
 	if (is_dedicated()) {
 		const auto s = vars.log_performance_once_every_secs;
@@ -4385,13 +4529,15 @@ void server_setup::log_performance() {
 				profiler.prepare_summary_info();
 
 				const auto summary = typesafe_sprintf(
-					"S: %3f, SS: %3f, AA: %3f, ACS: %3f, SE: %3f, SP: %3f",
+					"S: %3f, SS: %3f, AA: %3f, ACS: %3f, SE: %3f, SP: %3f, TL: %3f (max %3f)",
 					1000 * profiler.step.get_summary_info().value,
 					1000 * profiler.solve_simulation.get_summary_info().value,
 					1000 * profiler.advance_adapter.get_summary_info().value,
 					1000 * profiler.advance_clients_state.get_summary_info().value,
 					1000 * profiler.send_entropies.get_summary_info().value,
-					1000 * profiler.send_packets.get_summary_info().value
+					1000 * profiler.send_packets.get_summary_info().value,
+					1000 * profiler.tick_lateness.get_summary_info().value,
+					1000 * profiler.tick_lateness.get_maximum_units()
 				);
 
 				last_logged_at = server_time;
@@ -4778,6 +4924,357 @@ bool server_client_state::is_web_client() const {
 
 #include "augs/readwrite/to_bytes.h"
 
+#if BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS
+namespace {
+	struct test_step_entropy_message : net_messages::server_step_entropy {
+		~test_step_entropy_message() {
+			Release();
+		}
+	};
+
+	networked_server_step_entropy make_test_server_step_entropy() {
+		networked_server_step_entropy total;
+		total.meta.state_hash = 0xdeadbeef;
+
+		auto id = mode_player_id::first();
+
+		for (int i = 0; i < 32; ++i) {
+			total_mode_player_entropy t;
+			t.cosmic.motions[game_motion_type::MOVE_CROSSHAIR] = { -127 + i, 128 - i };
+			t.cosmic.intents.push_back({ game_intent_type::MOVE_FORWARD, intent_change::PRESSED });
+			t.cosmic.intents.push_back({ game_intent_type::INTERACT, intent_change::RELEASED });
+
+			total.payload.players.push_back({ id, t });
+			id.value++;
+		}
+
+		return total;
+	}
+
+	prestep_client_context make_test_client_context(const int client_index) {
+		auto context = prestep_client_context();
+		context.num_entropies_accepted = static_cast<uint8_t>(client_index % 3);
+		return context;
+	}
+}
+#endif
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("NetSerialization SharedServerEntropy") {
+	const auto total = make_test_server_step_entropy();
+
+	/* Covers every number of accepted entropies that a client context can take in the test. */
+	const int num_clients = 3;
+
+	std::vector<uint8_t> buffer(4096);
+
+	const auto shared = net_messages::preserialize_step_entropy(total);
+
+	for (int c = 0; c < num_clients; ++c) {
+		auto expected = total;
+		expected.context = make_test_client_context(c);
+
+		{
+			test_step_entropy_message m;
+			REQUIRE(m.write_payload(expected.context, shared));
+
+			auto stream = yojimbo::WriteStream(buffer.data(), static_cast<int>(buffer.size()));
+			REQUIRE(m.Serialize(stream));
+			stream.Flush();
+		}
+
+		test_step_entropy_message received_message;
+
+		{
+			auto stream = yojimbo::ReadStream(buffer.data(), static_cast<int>(buffer.size()));
+			REQUIRE(received_message.Serialize(stream));
+		}
+
+		networked_server_step_entropy received;
+		REQUIRE(received_message.read_payload(received));
+		REQUIRE(received == expected);
+	}
+}
+
+#include "game/cosmos/solvers/standard_solver.h"
+
+#if BUILD_TEST_SCENES
+#include "test_scenes/test_scene_settings.h"
+
+TEST_CASE("NetSerialization ArenaSnapshotDelta") {
+	auto scene = std::make_unique<intercosm>();
+	scene->make_test_scene(test_scene_settings());
+
+	auto& cosm = scene->world;
+	const auto clean_round_state = std::make_unique<cosmos_solvable_significant>(cosm.get_solvable().significant);
+
+	for (int i = 0; i < 60; ++i) {
+		auto entropy = cosmic_entropy();
+		standard_solver()({ cosm, entropy, solve_settings() }, solver_callbacks());
+	}
+
+	const auto& signi = cosm.get_solvable().significant;
+	const auto& flavours = cosm.get_common_significant().flavours;
+
+	augs::serialization_buffers buffers;
+
+	{
+		auto s = buffers.make_serialization_stream();
+		augs::write_bytes(s, signi);
+	}
+
+	const auto naive_size = buffers.serialization.size();
+
+	{
+		auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(flavours, *clean_round_state, signi);
+		augs::write_bytes(s, signi);
+	}
+
+	/* Entities left as they were in the clean round state are sent as ids only. */
+	REQUIRE(buffers.serialization.size() < naive_size);
+
+	auto received = std::make_unique<cosmos_solvable_significant>();
+
+	{
+		auto s = net_solvable_stream_cref(*clean_round_state, buffers.serialization);
+		augs::read_bytes(s, *received);
+	}
+
+	REQUIRE(
+		augs::to_bytes(received->entity_pools.get_for<controlled_character>())
+		== augs::to_bytes(signi.entity_pools.get_for<controlled_character>())
+	);
+
+	REQUIRE(
+		augs::to_bytes(received->entity_pools.get_for<shootable_weapon>())
+		== augs::to_bytes(signi.entity_pools.get_for<shootable_weapon>())
+	);
+
+	{
+		/* An entity absent from the clean round state can't be decoded. */
+
+		auto empty_round_state = std::make_unique<cosmos_solvable_significant>();
+		auto s = net_solvable_stream_cref(*empty_round_state, buffers.serialization);
+
+		REQUIRE_THROWS_AS(augs::read_bytes(s, *received), augs::stream_read_error);
+	}
+
+	{
+		/* Split components are delta-encoded per entity too, not written as whole columns. */
+
+		using column_type = augs::pool_column<components::rigid_body>;
+
+		const auto& clean_characters = clean_round_state->entity_pools.get_for<controlled_character>();
+		const auto& characters = signi.entity_pools.get_for<controlled_character>();
+
+		const auto& clean_column = clean_characters.get_corresponding_array<column_type>();
+		const auto& column = characters.get_corresponding_array<column_type>();
+
+		REQUIRE(column.size() > 0);
+
+		{
+			auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(flavours, *clean_round_state, *clean_round_state);
+			s.special_write_column(clean_characters, clean_column);
+		}
+
+		/* One encoding byte per entity. */
+		REQUIRE(buffers.serialization.size() == clean_column.size());
+
+		{
+			auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(flavours, *clean_round_state, signi);
+			s.special_write_column(characters, column);
+		}
+
+		REQUIRE(buffers.serialization.size() < column.size() * sizeof(column_type));
+
+		auto received_column = column;
+		received_column.clear();
+
+		{
+			auto s = net_solvable_stream_cref(*clean_round_state, buffers.serialization);
+			s.special_read_column(characters, received_column);
+		}
+
+		REQUIRE(augs::to_bytes(received_column) == augs::to_bytes(column));
+	}
+}
+#endif
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS
+#include "augs/internal_benchmarks.h"
+#include "augs/misc/timing/timer.h"
+#include "application/setups/editor/packaged_official_content.h"
+#include "augs/filesystem/directory.h"
+#include "game/cosmos/solvers/standard_solver.h"
+
+INTERNAL_BENCHMARK("NetSerialization SharedServerEntropy") {
+	const auto total = make_test_server_step_entropy();
+
+	const int num_clients = 64;
+	const int num_steps = 200;
+
+	std::vector<uint8_t> buffer(4096);
+
+	std::size_t total_bytes = 0;
+
+	augs::timer per_client_timer;
+
+	for (int step = 0; step < num_steps; ++step) {
+		for (int c = 0; c < num_clients; ++c) {
+			auto sent = total;
+			sent.context = make_test_client_context(c);
+
+			auto stream = yojimbo::WriteStream(buffer.data(), static_cast<int>(buffer.size()));
+			net_messages::serialize(stream, sent);
+			stream.Flush();
+
+			total_bytes += stream.GetBytesProcessed();
+		}
+	}
+
+	const auto per_client_ms = per_client_timer.get<std::chrono::milliseconds>();
+
+	std::size_t total_shared_bytes = 0;
+
+	augs::timer shared_timer;
+
+	for (int step = 0; step < num_steps; ++step) {
+		const auto shared = net_messages::preserialize_step_entropy(total);
+
+		for (int c = 0; c < num_clients; ++c) {
+			test_step_entropy_message m;
+			m.write_payload(make_test_client_context(c), shared);
+
+			auto stream = yojimbo::WriteStream(buffer.data(), static_cast<int>(buffer.size()));
+			m.Serialize(stream);
+			stream.Flush();
+
+			total_shared_bytes += stream.GetBytesProcessed();
+		}
+	}
+
+	const auto shared_ms = shared_timer.get<std::chrono::milliseconds>();
+
+	LOG(
+		"Server entropy for %x clients, %x steps. Per-client serialization: %x ms (%x bytes), shared: %x ms (%x bytes).",
+		num_clients,
+		num_steps,
+		per_client_ms,
+		total_bytes,
+		shared_ms,
+		total_shared_bytes
+	);
+}
+
+INTERNAL_BENCHMARK("NetSerialization ArenaSnapshotSizes") {
+	const auto official = std::make_unique<packaged_official_content>();
+
+	augs::serialization_buffers buffers;
+
+	auto benchmark_arena = [&](const augs::path_type& arena_folder) {
+		const auto arena_name = arena_folder.filename().string();
+
+		auto scene = std::make_unique<intercosm>();
+		auto clean_round_state = std::make_unique<cosmos_solvable_significant>();
+		all_rulesets_variant ruleset;
+		all_modes_variant current_mode_state;
+		synced_dynamic_vars dynamic_vars;
+
+		auto handle = online_arena_handle<false> {
+			current_mode_state,
+			*scene,
+			scene->world,
+			ruleset,
+			*clean_round_state,
+			dynamic_vars
+		};
+
+		::choose_arena_server({
+			editor_project_readwrite::reading_settings(),
+			handle,
+			*official,
+			arena_identifier(arena_name),
+			game_mode_name_type(),
+			*clean_round_state,
+			std::nullopt,
+			nullptr,
+			nullptr
+		});
+
+		auto& cosm = scene->world;
+
+		/* Let the round play out for a while so that the state diverges from the clean one. */
+
+		for (int i = 0; i < 300; ++i) {
+			auto entropy = cosmic_entropy();
+			standard_solver()({ cosm, entropy, solve_settings() }, solver_callbacks());
+		}
+
+		const auto& signi = cosm.get_solvable().significant;
+		const auto& flavours = cosm.get_common_significant().flavours;
+
+		auto compressed_size_of = [&](const std::vector<std::byte>& bytes) {
+			buffers.compressed.clear();
+			augs::compress(buffers.compression_state, bytes, buffers.compressed);
+			return buffers.compressed.size();
+		};
+
+		augs::timer t;
+
+		{
+			auto s = buffers.make_serialization_stream();
+			augs::write_bytes(s, signi);
+		}
+
+		const auto naive_ms = t.get<std::chrono::milliseconds>();
+		const auto naive_size = buffers.serialization.size();
+		const auto naive_compressed_size = compressed_size_of(buffers.serialization);
+
+		t.reset();
+
+		{
+			auto s = buffers.make_serialization_stream<net_solvable_stream_ref>(flavours, *clean_round_state, signi);
+			augs::write_bytes(s, signi);
+		}
+
+		const auto delta_ms = t.get<std::chrono::milliseconds>();
+		const auto delta_size = buffers.serialization.size();
+		const auto delta_compressed_size = compressed_size_of(buffers.serialization);
+
+		t.reset();
+
+		auto received = std::make_unique<cosmos_solvable_significant>();
+
+		{
+			auto s = net_solvable_stream_cref(*clean_round_state, buffers.serialization);
+			augs::read_bytes(s, *received);
+		}
+
+		const auto read_ms = t.get<std::chrono::milliseconds>();
+
+		LOG(
+			"Arena snapshot of %x (%x entities).\nNaive: %x (%x compressed), %x ms.\nDelta: %x (%x compressed), %x ms write, %x ms read.",
+			arena_name,
+			cosm.get_entities_count(),
+			readable_bytesize(naive_size),
+			readable_bytesize(naive_compressed_size),
+			naive_ms,
+			readable_bytesize(delta_size),
+			readable_bytesize(delta_compressed_size),
+			delta_ms,
+			read_ms
+		);
+
+		return callback_result::CONTINUE;
+	};
+
+	augs::for_each_directory_in_directory(OFFICIAL_ARENAS_DIR, benchmark_arena);
+}
+#endif
+
 // TODO: rewrite unit tests to use streams since we're no longer using preserialized_message 
 
 #undef BUILD_UNIT_TESTS
@@ -31,6 +31,7 @@
 
 #include "application/setups/server/chat_structs.h"
 #include "application/setups/server/server_profiler.h"
+#include "augs/misc/trace_recorder.h"
 #include "3rdparty/yojimbo/netcode/netcode.h"
 #include "application/nat/nat_type.h"
 #include "application/setups/server/server_nat_traversal.h"
@@ -38,6 +39,8 @@
 #include "application/setups/server/rcon_level.h"
 #include "game/messages/mode_notification.h"
 #include "application/setups/server/file_chunk_packet.h"
+#include "augs/network/netcode_packet_batch.h"
+#include "application/setups/server/arena_file_store.h"
 #include "application/arena/synced_dynamic_vars.h"
 #include "steam_rich_presence_pairs.h"
 
@@ -60,14 +63,15 @@ struct add_to_arena_input {
 class server_adapter;
 
 struct resolve_address_result;
-struct editor_project;
 
 struct arena_files_database_entry {
 	augs::path_type path;
-	std::vector<std::byte> cached_file;
+
+	/* Shared with other server instances in this process through arena_file_store. */
+	std::shared_ptr<const stored_arena_file> opened_file;
 
 	void free_opened_file() {
-		std::vector<std::byte>().swap(cached_file);
+		opened_file.reset();
 	}
 };
 
@@ -121,7 +125,6 @@ class server_setup :
 
 	const packaged_official_content& official;
 
-	std::unique_ptr<editor_project> last_loaded_project;
 	arena_files_database_type arena_files_database;
 
 	augs::server_listen_input last_start;
@@ -132,6 +135,19 @@ class server_setup :
 	std::unordered_set<augs::secure_hash_type> cached_currently_downloaded_files;
 	std::unordered_set<augs::secure_hash_type> opened_arena_files;
 
+	struct pending_file_chunk {
+		netcode_address_t to;
+		file_chunk_packet packet;
+	};
+
+	std::vector<pending_file_chunk> pending_file_chunks;
+	netcode_packet_batch file_chunks_batch;
+
+	net_time_t when_last_measured_file_transfers = 0;
+	uint32_t file_chunks_sent_since_measured = 0;
+	double file_transfer_cpu_secs_since_measured = 0.0;
+	server_network_info file_transfer_stats;
+
 	auto quit_playtesting_or(custom_imgui_result result) const {
 		if (vars.playtesting_context && result == custom_imgui_result::GO_TO_MAIN_MENU) {
 			return custom_imgui_result::QUIT_PLAYTESTING;
@@ -278,8 +294,13 @@ class server_setup :
 
 public:
 	net_time_t last_logged_at = 0;
+	net_time_t last_dumped_trace_at = 0;
+	std::size_t last_checked_step_for_trace = 0;
 	server_profiler profiler;
 
+	augs::trace_recorder trace;
+	std::future<void> trace_dump_job;
+
 	bool should_check_for_updates_once();
 	bool should_write_vars_to_disk_once();
 private:
@@ -460,6 +481,8 @@ public:
 			return;
 		}
 
+		const auto tracing = augs::trace_recorder::current_scope(&trace);
+
 #if BUILD_NATIVE_SOCKETS
 		if (nat_traversal) {
 			nat_traversal->last_detected_nat = in.last_detected_nat;
@@ -474,6 +497,10 @@ public:
 
 		const auto current_time = get_current_time();
 
+		if (server_time <= current_time) {
+			profiler.tick_lateness.measure(current_time - server_time);
+		}
+
 		while (server_time <= current_time) {
 			if (shutdown_scheduled) {
 				shutdown();
@@ -481,6 +508,8 @@ public:
 				return;
 			}
 
+			dump_performance_trace_if_step_was_long();
+
 			auto scope = measure_scope(profiler.step);
 
 			finalize_webhook_jobs();
@@ -493,6 +522,7 @@ public:
 			{
 				auto scope = measure_scope(profiler.advance_adapter);
 				handle_client_messages();
+				flush_file_chunks();
 			}
 
 			{
@@ -553,6 +583,9 @@ public:
 				const auto unpacked = unpack(step_collected);
 				const auto arena = get_arena_handle();
 
+				auto settings = solve_settings();
+				settings.pool = in.solve_pool;
+
 				if (is_dedicated()) {
 					auto post_solve = [&](auto old_callback, const const_logic_step step) {
 						handle_abandon_requests(step);
@@ -580,7 +613,7 @@ public:
 					arena.advance(
 						unpacked, 
 						new_callbacks, 
-						solve_settings()
+						settings
 					);
 				}
 				else {
@@ -612,7 +645,7 @@ public:
 					arena.advance(
 						unpacked, 
 						new_callbacks, 
-						solve_settings()
+						settings
 					);
 
 					const auto& removed = unpacked.general.removed_player;
@@ -643,9 +676,11 @@ public:
 		}
 
 		refresh_available_direct_download_bandwidths();
+		measure_file_transfers();
 		clean_unused_cached_files();
 
 		log_performance();
+		dump_performance_trace_if_step_was_long();
 	}
 
 	template <class T>
@@ -696,6 +731,10 @@ public:
 
 	void sleep_until_next_tick();
 
+	/* In the clock of augs::high_precision_secs. */
+	net_time_t get_next_tick_time() const;
+	void delay_next_tick_by(net_time_t secs);
+
 	void update_stats(server_network_info&) const;
 
 	server_step_entropy unpack(const compact_server_step_entropy&) const;
@@ -750,6 +789,8 @@ public:
 
 	void reset_player_meta_to_default(const mode_player_id&);
 	void log_performance();
+	void dump_performance_trace(const std::string& reason);
+	void dump_performance_trace_if_step_was_long();
 
 	::synced_meta_update make_synced_meta_update_from(
 		const server_client_state&,
@@ -805,6 +846,8 @@ public:
 	file_chunk_index_type calc_num_chunks_per_tick_per_downloader() const;
 
 	bool send_file_chunk(client_id_type id, const arena_files_database_entry& entry, file_chunk_index_type i);
+	void flush_file_chunks();
+	void measure_file_transfers();
 	void clean_unused_cached_files();
 
 	void apply_nonzoomedout_visible_world_area(vec2);
@@ -151,6 +151,7 @@ struct server_vars {
 	uint32_t max_buffered_client_commands = 1000;
 
 	uint32_t state_hash_once_every_tick = 1;
+	bool wide_state_hash = false;
 	float send_net_statistics_update_once_every_secs = 1;
 
 	float max_kick_ban_linger_secs = 2;
@@ -162,6 +163,8 @@ struct server_vars {
 	uint32_t max_unauthorized_rcon_commands = 100;
 	uint32_t max_bots = 0;
 	float log_performance_once_every_secs = 1;
+	bool record_performance_trace = false;
+	float dump_performance_trace_if_step_exceeds_ms = 0.f;
 	float sleep_mult = 0.1f;
 
 	float max_direct_file_bandwidth = 2.0f;
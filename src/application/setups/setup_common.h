@@ -49,6 +49,10 @@ struct network_profiler;
 struct network_info;
 struct lag_compensation_settings;
 
+namespace augs {
+	class thread_pool;
+}
+
 struct server_advance_input {
 	const vec2i screen_size;
 	const input_settings settings;
@@ -59,6 +63,8 @@ struct server_advance_input {
 	network_profiler& network_performance;
 	server_network_info& server_stats;
 
+	augs::thread_pool* const solve_pool = nullptr;
+
 	auto make_accumulator_input() const {
 		return entropy_accumulator::input {
 			settings,
@@ -83,6 +89,8 @@ struct client_advance_input {
 	interpolation_system& interp;
 	past_infection_system& past_infection;
 
+	augs::thread_pool* const solve_pool = nullptr;
+
 	auto make_accumulator_input() const {
 		return entropy_accumulator::input {
 			settings,
@@ -128,13 +128,22 @@ namespace augs {
 		return meta.computed_length_in_seconds;
 	}
 
-	sound_buffer::sound_buffer(const sound_buffer_loading_input input) {
-		from_file(input);
-	}
+	std::vector<sound_data> decode_sound_variations(
+		const sound_buffer_loading_input& input,
+		const path_type& pcm_cache_dir
+	) {
+		auto decode = [&](const path_type& path) {
+			if (pcm_cache_dir.empty()) {
+				return sound_data(path);
+			}
+
+			return decode_sound_cached(path, pcm_cache_dir);
+		};
+
+		std::vector<sound_data> result;
 
-	void sound_buffer::from_file(const sound_buffer_loading_input input) {
 		const auto& path = input.source_sound;
-		variations.emplace_back(path, input.settings);
+		result.emplace_back(decode(path));
 
 		const auto ext = augs::path_type(path).extension();
 		const auto without_ext = augs::path_type(path).replace_extension("").string();
@@ -146,13 +155,36 @@ namespace augs {
 				const auto next_path = augs::path_type(typesafe_sprintf("%x_%x%x", without_num, i, ext));
 
 				try {
-					variations.emplace_back(next_path, input.settings);
+					result.emplace_back(decode(next_path));
 				}
 				catch (...) {
 					break;
 				}
 			}
 		}
+
+		return result;
+	}
+
+	sound_buffer::sound_buffer(const sound_buffer_loading_input input) {
+		from_file(input);
+	}
+
+	sound_buffer::sound_buffer(
+		const std::vector<sound_data>& decoded_variations,
+		const sound_buffer_loading_settings settings
+	) {
+		variations.reserve(decoded_variations.size());
+
+		for (const auto& d : decoded_variations) {
+			variations.emplace_back(d, settings);
+		}
+	}
+
+	void sound_buffer::from_file(const sound_buffer_loading_input input) {
+		for (const auto& d : decode_sound_variations(input, {})) {
+			variations.emplace_back(d, input.settings);
+		}
 	}
 
 	const single_sound_buffer& sound_buffer::get_buffer(const std::size_t variation_index) const {
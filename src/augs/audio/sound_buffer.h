@@ -42,12 +42,26 @@ namespace augs {
 		}
 	};
 
+	/*
+		Decodes the sound and, if its name ends with _1, all of its consecutively numbered variations,
+		up to the first one that is missing or fails to decode.
+
+		Doesn't touch OpenAL, so it can run on any thread.
+		If pcm_cache_dir is not empty, the samples go through decode_sound_cached.
+	*/
+
+	std::vector<sound_data> decode_sound_variations(
+		const sound_buffer_loading_input&,
+		const path_type& pcm_cache_dir
+	);
+
 	class sound_buffer {
 		void from_file(const sound_buffer_loading_input);
 
 		std::vector<single_sound_buffer> variations;
 	public:
 		sound_buffer(const sound_buffer_loading_input);
+		sound_buffer(const std::vector<sound_data>& decoded_variations, sound_buffer_loading_settings);
 
 		const single_sound_buffer& get_buffer(std::size_t variation_index) const;
 
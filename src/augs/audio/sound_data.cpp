@@ -4,11 +4,19 @@
 #endif
 
 #include <cstring>
+#include <thread>
+#include <optional>
+#include <algorithm>
 
+#include "augs/log.h"
 #include "augs/misc/scope_guard.h"
 #include "augs/audio/sound_data.h"
 #include "augs/ensure.h"
 #include "augs/filesystem/file.h"
+#include "augs/filesystem/directory.h"
+#include "augs/enums/callback_result.h"
+#include "augs/readwrite/byte_file.h"
+#include "augs/misc/secure_hash.h"
 #include "augs/audio/sound_data.h"
 #include "augs/build_settings/setting_log_audio_files.h"
 
@@ -17,28 +25,61 @@
 #include "stb/stb_vorbis.c"
 #endif
 
-template <class T>
-auto fclosed_unique(T* const ptr) {
-	return std::unique_ptr<T, decltype(fclose)*>(ptr, fclose);
-}
-
 namespace augs {
+#if BUILD_SOUND_FORMAT_DECODERS
+	static std::vector<std::byte> read_sound_file(const path_type& path) {
+		if (path.empty()) {
+			throw sound_decoding_error("Failed to decode a sound file: empty path was passed.");
+		}
+
+		try {
+			return file_to_bytes(path);
+		}
+		catch (const file_open_error&) {
+			throw sound_decoding_error("Failed to decode %x: could not open the file for reading.", path);
+		}
+	}
+#endif
+
 	sound_data::sound_data(const path_type& path) {
 		channels = 1;
 
+#if BUILD_SOUND_FORMAT_DECODERS
+		decode(read_sound_file(path), path);
+#else
 		if (path.empty()) {
 			throw sound_decoding_error("Failed to decode a sound file: empty path was passed.");
 		}
+#endif
+	}
+
+	sound_data::sound_data(const std::vector<std::byte>& bytes, const path_type& reported_path) {
+		channels = 1;
 
 #if BUILD_SOUND_FORMAT_DECODERS
+		decode(bytes, reported_path);
+#else
+		(void)bytes;
+		(void)reported_path;
+#endif
+	}
+
+#if BUILD_SOUND_FORMAT_DECODERS
+	void sound_data::decode(const std::vector<std::byte>& bytes, const path_type& path) {
 		const auto extension = path.extension();
-		const auto path_str = path.string();
 
         if (extension == ".ogg") {
             short* decoded_samples = nullptr;
 
             // Decode the file
-            int samples_output = stb_vorbis_decode_filename(path_str.c_str(), &channels, &frequency, &decoded_samples);
+            int samples_output = stb_vorbis_decode_memory(
+				reinterpret_cast<const unsigned char*>(bytes.data()),
+				static_cast<int>(bytes.size()),
+				&channels,
+				&frequency,
+				&decoded_samples
+			);
+
             if (samples_output < 0) {
                 // Handle error
                 throw sound_decoding_error("Failed to decode %x as OGG file. STB error code: %x", path, samples_output);
@@ -52,16 +93,6 @@ namespace augs {
             free(decoded_samples);
         }
 		else if (extension == ".wav") {
-#if PLATFORM_UNIX
-			auto wav_file = fclosed_unique(fopen(path_str.c_str(), "rbe"));
-#else
-			auto wav_file = fclosed_unique(fopen(path_str.c_str(), "rb"));
-#endif
-
-			if (!wav_file) {
-				throw sound_decoding_error("Failed to decode %x: could not open the file for reading.", path);
-			}
-
 			typedef struct WAV_HEADER {
 				/* RIFF Chunk Descriptor */
 				uint8_t         RIFF[4];        // RIFF Header Magic header
@@ -83,17 +114,19 @@ namespace augs {
 
 			wav_hdr wav_header = {};
 
-			if (fread(&wav_header, 1, sizeof(wav_hdr), wav_file.get()) > 0) {
+			if (bytes.size() >= sizeof(wav_hdr)) {
+				std::memcpy(&wav_header, bytes.data(), sizeof(wav_hdr));
+
 				if (wav_header.bitsPerSample == 16) {
 					channels = wav_header.NumOfChan;
 					frequency = wav_header.SamplesPerSec;
-					samples.resize(wav_header.Subchunk2Size / sizeof(sound_sample_type));
-					
-					if (const auto bytes_read = fread(samples.data(), sizeof(char), wav_header.Subchunk2Size, wav_file.get());
-						bytes_read != wav_header.Subchunk2Size
-					) {
+
+					if (bytes.size() - sizeof(wav_hdr) < wav_header.Subchunk2Size) {
 						throw sound_decoding_error("Failed to decode %x as WAV file.", path);
 					}
+
+					samples.resize(wav_header.Subchunk2Size / sizeof(sound_sample_type));
+					std::memcpy(samples.data(), bytes.data() + sizeof(wav_hdr), samples.size() * sizeof(sound_sample_type));
 				}
 				else {
 					throw sound_decoding_error(
@@ -137,11 +170,485 @@ namespace augs {
 			channels,
 			compute_length_in_seconds()
 		);
-#endif
 #endif
 	}
+#endif
 	
 	double sound_data::compute_length_in_seconds() const {
 		return static_cast<double>(samples.size()) / (frequency * channels);
 	}
+
+#if BUILD_SOUND_FORMAT_DECODERS
+	constexpr uint32_t pcm_cache_magic_v = 0x4d435053;
+
+	/* Bump whenever the decoded samples start to differ, e.g. if decoding starts to resample. */
+	constexpr uint32_t pcm_cache_version_v = 1;
+
+	struct pcm_cache_header {
+		uint32_t magic = pcm_cache_magic_v;
+		uint32_t version = pcm_cache_version_v;
+		int32_t frequency = 0;
+		int32_t channels = 0;
+		uint64_t num_samples = 0;
+	};
+
+	static std::optional<sound_data> read_cached_pcm(const path_type& cached_path) {
+		if (cached_path.empty() || !augs::exists(cached_path)) {
+			return std::nullopt;
+		}
+
+		try {
+			const auto file_size = std::filesystem::file_size(cached_path);
+
+			pcm_cache_header header;
+
+			if (file_size < sizeof(header)) {
+				return std::nullopt;
+			}
+
+			auto in = open_binary_input_stream(cached_path);
+			in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+			const auto samples_bytes = file_size - sizeof(header);
+
+			/* Anything else is a corrupted file, and the source is decoded again. */
+
+			const bool valid =
+				header.magic == pcm_cache_magic_v
+				&& header.version == pcm_cache_version_v
+				&& header.frequency > 0
+				&& (header.channels == 1 || header.channels == 2)
+				&& header.num_samples % header.channels == 0
+				&& header.num_samples * sizeof(sound_sample_type) == samples_bytes
+			;
+
+			if (!valid) {
+				return std::nullopt;
+			}
+
+			sound_data result;
+			result.frequency = header.frequency;
+			result.channels = header.channels;
+			result.samples.resize(header.num_samples);
+
+			in.read(reinterpret_cast<char*>(result.samples.data()), samples_bytes);
+
+			return result;
+		}
+		catch (const std::exception&) {
+			return std::nullopt;
+		}
+	}
+
+	static bool write_cached_pcm(const sound_data& data, const path_type& cached_path) {
+		pcm_cache_header header;
+		header.frequency = data.frequency;
+		header.channels = data.channels;
+		header.num_samples = data.samples.size();
+
+		/* Another decoder might be writing the same file, so publish it atomically. */
+
+		const auto thread_suffix = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+		const auto temporary_path = augs::path_type(cached_path).replace_extension(thread_suffix + ".tmp");
+
+		try {
+			augs::create_directories_for(cached_path);
+
+			{
+				auto out = open_binary_output_stream(temporary_path);
+				out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				out.write(reinterpret_cast<const char*>(data.samples.data()), data.samples.size() * sizeof(sound_sample_type));
+			}
+
+			std::filesystem::rename(temporary_path, cached_path);
+			return true;
+		}
+		catch (const std::exception& err) {
+			LOG("Failed to cache the decoded samples in %x: %x", cached_path, err.what());
+			augs::remove_file(temporary_path);
+			return false;
+		}
+	}
+
+	/*
+		Hashing every source file on each launch would take a good part of what the cache saves,
+		so the name of the cached file found for a source is remembered under its path, size and last write time.
+	*/
+
+	static path_type get_source_stamp_path(const path_type& path, const path_type& pcm_cache_dir) {
+		try {
+			const auto stamp =
+				path.string() + '\n'
+				+ std::to_string(std::filesystem::file_size(path)) + '\n'
+				+ std::to_string(augs::last_write_time(path).time_since_epoch().count())
+			;
+
+			return pcm_cache_dir / "stamps" / (std::string(to_hex_format(secure_hash(stamp))) + ".txt");
+		}
+		catch (const std::filesystem::filesystem_error&) {
+			return {};
+		}
+	}
+
+	static path_type read_stamped_pcm_path(const path_type& stamp_path, const path_type& pcm_cache_dir) {
+		if (stamp_path.empty() || !augs::exists(stamp_path)) {
+			return {};
+		}
+
+		try {
+			return pcm_cache_dir / path_type(file_read_first_line(stamp_path)).filename();
+		}
+		catch (const std::exception&) {
+			return {};
+		}
+	}
+
+	static void mark_recently_used(const path_type& cached_path) {
+		/* Might have just been evicted by another process, which only means it will be decoded again next time. */
+		std::error_code err;
+		std::filesystem::last_write_time(cached_path, std::filesystem::file_time_type::clock::now(), err);
+	}
+
+	static void write_stamp(const path_type& stamp_path, const path_type& cached_path) {
+		if (stamp_path.empty()) {
+			return;
+		}
+
+		try {
+			augs::create_directories_for(stamp_path);
+			augs::save_as_text(stamp_path, cached_path.filename().string());
+		}
+		catch (const std::exception& err) {
+			LOG("Failed to save the decoded samples stamp %x: %x", stamp_path, err.what());
+		}
+	}
+#endif
+
+	sound_data decode_sound_cached(const path_type& path, const path_type& pcm_cache_dir) {
+#if BUILD_SOUND_FORMAT_DECODERS
+		const auto stamp_path = get_source_stamp_path(path, pcm_cache_dir);
+
+		const auto stamped_path = read_stamped_pcm_path(stamp_path, pcm_cache_dir);
+
+		if (auto cached = read_cached_pcm(stamped_path)) {
+			mark_recently_used(stamped_path);
+			return std::move(*cached);
+		}
+
+		const auto bytes = read_sound_file(path);
+		const auto cached_path = pcm_cache_dir / (std::string(to_hex_format(secure_hash(bytes))) + ".pcm");
+
+		if (auto cached = read_cached_pcm(cached_path)) {
+			mark_recently_used(cached_path);
+			write_stamp(stamp_path, cached_path);
+			return std::move(*cached);
+		}
+
+		auto result = sound_data(bytes, path);
+
+		if (write_cached_pcm(result, cached_path)) {
+			write_stamp(stamp_path, cached_path);
+		}
+
+		return result;
+#else
+		(void)pcm_cache_dir;
+		return sound_data(path);
+#endif
+	}
+
+	std::size_t evict_cached_pcm(const path_type& pcm_cache_dir, const std::uintmax_t max_bytes) {
+		struct cached_pcm {
+			std::filesystem::file_time_type last_used;
+			std::uintmax_t size = 0;
+			path_type path;
+		};
+
+		std::vector<cached_pcm> cached;
+
+		try {
+			if (!augs::exists(pcm_cache_dir)) {
+				return 0;
+			}
+
+			for_each_in_directory(
+				pcm_cache_dir,
+				[](const auto&) { return callback_result::CONTINUE; },
+				[&](const auto& p) {
+					if (p.extension() == ".pcm") {
+						std::error_code err;
+
+						const auto last_used = std::filesystem::last_write_time(p, err);
+						const auto size = err ? 0 : std::filesystem::file_size(p, err);
+
+						/* Might have just been evicted by another process. */
+						if (!err) {
+							cached.push_back({ last_used, size, p });
+						}
+					}
+
+					return callback_result::CONTINUE;
+				}
+			);
+		}
+		catch (const std::filesystem::filesystem_error& err) {
+			LOG("Failed to list the decoded samples: %x", err.what());
+			return 0;
+		}
+
+		std::sort(
+			cached.begin(),
+			cached.end(),
+			[](const auto& a, const auto& b) {
+				return a.last_used > b.last_used;
+			}
+		);
+
+		std::uintmax_t total_bytes = 0;
+		std::size_t num_removed = 0;
+
+		for (const auto& c : cached) {
+			total_bytes += c.size;
+
+			if (total_bytes > max_bytes && remove_file(c.path)) {
+				++num_removed;
+			}
+		}
+
+		if (num_removed == 0) {
+			return 0;
+		}
+
+		/* Stamps are only ever left dangling by the eviction, so this is the only time they need to be looked at. */
+
+		const auto stamps_dir = pcm_cache_dir / "stamps";
+
+		try {
+			if (augs::exists(stamps_dir)) {
+				for_each_in_directory(
+					stamps_dir,
+					[](const auto&) { return callback_result::CONTINUE; },
+					[&](const auto& stamp_path) {
+						const bool dangling = [&]() {
+							try {
+								return !augs::exists(pcm_cache_dir / path_type(file_read_first_line(stamp_path)).filename());
+							}
+							catch (const std::exception&) {
+								return true;
+							}
+						}();
+
+						if (dangling) {
+							remove_file(stamp_path);
+						}
+
+						return callback_result::CONTINUE;
+					}
+				);
+			}
+		}
+		catch (const std::filesystem::filesystem_error& err) {
+			LOG("Failed to list the decoded samples stamps: %x", err.what());
+		}
+
+		return num_removed;
+	}
+}
+
+#if (BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS) && BUILD_SOUND_FORMAT_DECODERS
+#include "augs/filesystem/temporary_directory.h"
+#include "augs/enums/callback_result.h"
+#include "all_paths.h"
+
+static auto find_official_sounds() {
+	std::vector<augs::path_type> official_sounds;
+
+	augs::for_each_in_directory(
+		OFFICIAL_CONTENT_DIR / "sfx",
+		[](const auto&) { return callback_result::CONTINUE; },
+		[&](const auto& path) {
+			if (path.extension() == ".ogg" || path.extension() == ".wav") {
+				official_sounds.push_back(path);
+			}
+
+			return callback_result::CONTINUE;
+		}
+	);
+
+	std::sort(official_sounds.begin(), official_sounds.end());
+	return official_sounds;
+}
+#endif
+
+#if BUILD_UNIT_TESTS && BUILD_SOUND_FORMAT_DECODERS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("SoundData DecodedCache") {
+	const auto official_sounds = find_official_sounds();
+	REQUIRE(official_sounds.size() > 0);
+
+	const auto temp = augs::temporary_directory("decoded_cache");
+	const auto cache_dir = temp / "decoded_sounds";
+
+	const auto source = temp / ("source" + official_sounds.front().extension().string());
+	std::filesystem::copy_file(official_sounds.front(), source);
+
+	const auto expected = augs::sound_data(source);
+
+	auto require_expected = [&](const augs::sound_data& d) {
+		REQUIRE(d.samples == expected.samples);
+		REQUIRE(d.frequency == expected.frequency);
+		REQUIRE(d.channels == expected.channels);
+	};
+
+	auto find_cached = [&]() {
+		std::vector<augs::path_type> result;
+
+		augs::for_each_in_directory(
+			cache_dir,
+			[](const auto&) { return callback_result::CONTINUE; },
+			[&](const auto& path) {
+				if (path.extension() == ".pcm") {
+					result.push_back(path);
+				}
+
+				return callback_result::CONTINUE;
+			}
+		);
+
+		return result;
+	};
+
+	/* Cold, then found by the stamp of the source. */
+	require_expected(augs::decode_sound_cached(source, cache_dir));
+	require_expected(augs::decode_sound_cached(source, cache_dir));
+
+	const auto cached = find_cached();
+	REQUIRE(cached.size() == 1);
+
+	{
+		/* A corrupted header must never be trusted, so the source is decoded again. */
+
+		auto bytes = augs::file_to_bytes(cached[0]);
+		const auto channels_offset = 3 * sizeof(uint32_t);
+
+		std::memset(bytes.data() + channels_offset, 0, sizeof(int32_t));
+		augs::bytes_to_file(bytes, cached[0]);
+
+		require_expected(augs::decode_sound_cached(source, cache_dir));
+		REQUIRE(augs::file_to_bytes(cached[0]) != bytes);
+	}
+
+	{
+		/* A truncated file as well. */
+
+		auto bytes = augs::file_to_bytes(cached[0]);
+		bytes.resize(bytes.size() - sizeof(augs::sound_sample_type));
+		augs::bytes_to_file(bytes, cached[0]);
+
+		require_expected(augs::decode_sound_cached(source, cache_dir));
+	}
+}
+
+TEST_CASE("SoundData DecodedCacheEviction") {
+	const auto official_sounds = find_official_sounds();
+	REQUIRE(official_sounds.size() > 1);
+
+	const auto temp = augs::temporary_directory("decoded_cache_eviction");
+	const auto cache_dir = temp / "decoded_sounds";
+
+	auto count_in = [](const augs::path_type& dir) {
+		std::size_t n = 0;
+
+		augs::for_each_in_directory(
+			dir,
+			[](const auto&) { return callback_result::CONTINUE; },
+			[&](const auto&) { ++n; return callback_result::CONTINUE; }
+		);
+
+		return n;
+	};
+
+	auto cached_path_of = [&](const augs::path_type& p) {
+		return cache_dir / (std::string(augs::to_hex_format(augs::secure_hash(augs::file_to_bytes(p)))) + ".pcm");
+	};
+
+	const auto& older = official_sounds[0];
+	const auto& newer = official_sounds[1];
+
+	augs::decode_sound_cached(older, cache_dir);
+	augs::decode_sound_cached(newer, cache_dir);
+
+	REQUIRE(count_in(cache_dir) == 2);
+	REQUIRE(count_in(cache_dir / "stamps") == 2);
+
+	/* Nothing is removed while everything fits. */
+	REQUIRE(0 == augs::evict_cached_pcm(cache_dir));
+
+	const auto hour_ago = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+	std::filesystem::last_write_time(cached_path_of(older), hour_ago);
+	std::filesystem::last_write_time(cached_path_of(newer), hour_ago);
+
+	/* Using a sound marks it as recently used, so the other one goes first. */
+	augs::decode_sound_cached(newer, cache_dir);
+
+	REQUIRE(1 == augs::evict_cached_pcm(cache_dir, std::filesystem::file_size(cached_path_of(newer))));
+
+	REQUIRE(!augs::exists(cached_path_of(older)));
+	REQUIRE(augs::exists(cached_path_of(newer)));
+	REQUIRE(count_in(cache_dir / "stamps") == 1);
+
+	/* An evicted sound is just decoded again. */
+
+	const auto redecoded = augs::decode_sound_cached(older, cache_dir);
+	REQUIRE(redecoded.samples == augs::sound_data(older).samples);
+	REQUIRE(augs::exists(cached_path_of(older)));
+}
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_SOUND_FORMAT_DECODERS
+#include "augs/internal_benchmarks.h"
+#include "augs/misc/timing/timer.h"
+
+INTERNAL_BENCHMARK("SoundData DecodedCache") {
+	const auto official_sounds = find_official_sounds();
+
+	const auto temp = augs::temporary_directory("decoded_cache_benchmark");
+	const auto cache_dir = temp / "decoded_sounds";
+
+	auto decode_all = [&](auto decode) {
+		augs::timer t;
+
+		std::vector<augs::sound_data> result;
+
+		for (const auto& p : official_sounds) {
+			result.emplace_back(decode(p));
+		}
+
+		return std::make_pair(std::move(result), t.get<std::chrono::milliseconds>());
+	};
+
+	const auto uncached = decode_all([](const auto& p) { return augs::sound_data(p); });
+	const auto cold = decode_all([&](const auto& p) { return augs::decode_sound_cached(p, cache_dir); });
+	const auto warm = decode_all([&](const auto& p) { return augs::decode_sound_cached(p, cache_dir); });
+
+	std::size_t num_mismatched = 0;
+
+	for (std::size_t i = 0; i < official_sounds.size(); ++i) {
+		for (const auto* const d : { &cold.first[i], &warm.first[i] }) {
+			if (d->samples != uncached.first[i].samples) {
+				++num_mismatched;
+			}
+		}
+	}
+
+	LOG(
+		"Decoded %x official sounds (%x mismatched). Without cache: %x ms, cold cache: %x ms, warm cache: %x ms.",
+		official_sounds.size(),
+		num_mismatched,
+		uncached.second,
+		cold.second,
+		warm.second
+	);
 }
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include "augs/filesystem/path.h"
 #include "augs/templates/exception_templates.h"
 
@@ -15,8 +17,28 @@ namespace augs {
 		int frequency = 0;
 		int channels = 0;
 
+		sound_data() = default;
 		sound_data(const path_type& path);
+		sound_data(const std::vector<std::byte>& bytes, const path_type& reported_path);
 
 		double compute_length_in_seconds() const;
+
+	private:
+		void decode(const std::vector<std::byte>& bytes, const path_type& path);
 	};
-}
\ No newline at end of file
+
+	/*
+		Decoding OGGs takes most of the time spent loading sounds.
+		This keeps the decoded samples in pcm_cache_dir, in files named by a hash of the source file,
+		so that a sound is only ever decoded once, even if it's copied between projects.
+		Sources whose path, size and last write time did not change are not even hashed.
+	*/
+
+	sound_data decode_sound_cached(const path_type& path, const path_type& pcm_cache_dir);
+
+	/* Least recently used samples are evicted once all of them take more than this. */
+	constexpr std::uintmax_t pcm_cache_max_bytes_v = 256 * 1024 * 1024;
+
+	/* Removes the least recently used samples from pcm_cache_dir, along with the stamps pointing to them. Returns how many samples were removed. */
+	std::size_t evict_cached_pcm(const path_type& pcm_cache_dir, std::uintmax_t max_bytes = pcm_cache_max_bytes_v);
+}
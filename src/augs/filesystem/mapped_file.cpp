@@ -0,0 +1,170 @@
+#include "augs/filesystem/mapped_file.h"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#undef min
+#undef max
+#elif PLATFORM_UNIX && !PLATFORM_WEB
+#define MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include "augs/filesystem/file.h"
+#include "augs/readwrite/byte_file.h"
+#endif
+
+namespace augs {
+	mapped_file::mapped_file(const path_type& path) {
+#if PLATFORM_WINDOWS
+		file_handle = CreateFileW(
+			path.wstring().c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+
+		if (file_handle == INVALID_HANDLE_VALUE) {
+			file_handle = nullptr;
+			throw mapped_file_error("Failed to open %x for mapping.", path);
+		}
+
+		LARGE_INTEGER file_size;
+
+		if (!GetFileSizeEx(file_handle, &file_size)) {
+			close();
+			throw mapped_file_error("Failed to read the size of %x.", path);
+		}
+
+		if (file_size.QuadPart == 0) {
+			return;
+		}
+
+		mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (mapping_handle == nullptr) {
+			close();
+			throw mapped_file_error("Failed to create a mapping of %x.", path);
+		}
+
+		const auto view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+
+		if (view == nullptr) {
+			close();
+			throw mapped_file_error("Failed to map %x.", path);
+		}
+
+		mapped = static_cast<const std::byte*>(view);
+		mapped_size = static_cast<std::size_t>(file_size.QuadPart);
+#elif MAPPED_FILE_POSIX
+		const auto fd = ::open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (fd == -1) {
+			throw mapped_file_error("Failed to open %x for mapping.", path);
+		}
+
+		struct stat st;
+
+		if (::fstat(fd, &st) == -1) {
+			::close(fd);
+			throw mapped_file_error("Failed to read the size of %x.", path);
+		}
+
+		if (st.st_size == 0) {
+			::close(fd);
+			return;
+		}
+
+		const auto size = static_cast<std::size_t>(st.st_size);
+		const auto view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		/* The mapping stays valid after the descriptor is closed. */
+		::close(fd);
+
+		if (view == MAP_FAILED) {
+			throw mapped_file_error("Failed to map %x.", path);
+		}
+
+		mapped = static_cast<const std::byte*>(view);
+		mapped_size = size;
+#else
+		try {
+			file_to_bytes(path, fallback);
+		}
+		catch (const file_open_error&) {
+			throw mapped_file_error("Failed to open %x for mapping.", path);
+		}
+
+		mapped = fallback.data();
+		mapped_size = fallback.size();
+#endif
+	}
+
+	void mapped_file::close() {
+#if PLATFORM_WINDOWS
+		if (mapped != nullptr) {
+			UnmapViewOfFile(mapped);
+		}
+
+		if (mapping_handle != nullptr) {
+			CloseHandle(mapping_handle);
+		}
+
+		if (file_handle != nullptr) {
+			CloseHandle(file_handle);
+		}
+
+		file_handle = nullptr;
+		mapping_handle = nullptr;
+#elif MAPPED_FILE_POSIX
+		if (mapped != nullptr) {
+			::munmap(const_cast<std::byte*>(mapped), mapped_size);
+		}
+#else
+		fallback.clear();
+#endif
+
+		mapped = nullptr;
+		mapped_size = 0;
+	}
+
+	void mapped_file::move_from(mapped_file& b) {
+		mapped = b.mapped;
+		mapped_size = b.mapped_size;
+
+#if PLATFORM_WINDOWS
+		file_handle = b.file_handle;
+		mapping_handle = b.mapping_handle;
+
+		b.file_handle = nullptr;
+		b.mapping_handle = nullptr;
+#endif
+
+		/* Moving a vector keeps its buffer, so the pointer to the fallback stays valid. */
+		fallback = std::move(b.fallback);
+
+		b.mapped = nullptr;
+		b.mapped_size = 0;
+	}
+
+	mapped_file::~mapped_file() {
+		close();
+	}
+
+	mapped_file::mapped_file(mapped_file&& b) noexcept {
+		move_from(b);
+	}
+
+	mapped_file& mapped_file::operator=(mapped_file&& b) noexcept {
+		if (this != &b) {
+			close();
+			move_from(b);
+		}
+
+		return *this;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+#include "augs/filesystem/path.h"
+#include "augs/templates/exception_templates.h"
+
+namespace augs {
+	struct mapped_file_error : error_with_typesafe_sprintf {
+		using error_with_typesafe_sprintf::error_with_typesafe_sprintf;
+	};
+
+	/*
+		Read-only view of a whole file mapped into memory.
+
+		Pages are read from disk only when they are first touched
+		and are shared with the system's page cache instead of being copied.
+		Where mapping is unavailable (the web), the file is just read into memory.
+	*/
+
+	class mapped_file {
+		const std::byte* mapped = nullptr;
+		std::size_t mapped_size = 0;
+
+#if PLATFORM_WINDOWS
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+
+		std::vector<std::byte> fallback;
+
+		void close();
+		void move_from(mapped_file&);
+
+	public:
+		mapped_file() = default;
+		explicit mapped_file(const path_type& path);
+
+		~mapped_file();
+
+		mapped_file(mapped_file&&) noexcept;
+		mapped_file& operator=(mapped_file&&) noexcept;
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		const std::byte* data() const {
+			return mapped;
+		}
+
+		std::size_t size() const {
+			return mapped_size;
+		}
+
+		bool empty() const {
+			return mapped_size == 0;
+		}
+	};
+}
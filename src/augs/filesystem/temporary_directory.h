@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <thread>
+#include <functional>
+#include <filesystem>
+
+#include "augs/filesystem/path.h"
+
+namespace augs {
+	/*
+		A fresh directory in the system's temporary folder, removed with all its contents on destruction.
+		Lets unit tests work with files without touching the game's own folders, like the cache.
+	*/
+
+	class temporary_directory {
+		path_type path;
+
+	public:
+		temporary_directory(const std::string& name) {
+			const auto thread_suffix = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+			path = std::filesystem::temp_directory_path() / ("hypersomnia_" + name + "_" + thread_suffix);
+
+			std::error_code err;
+			std::filesystem::remove_all(path, err);
+			std::filesystem::create_directories(path);
+		}
+
+		~temporary_directory() {
+			std::error_code err;
+			std::filesystem::remove_all(path, err);
+		}
+
+		temporary_directory(const temporary_directory&) = delete;
+		temporary_directory& operator=(const temporary_directory&) = delete;
+
+		const path_type& get() const {
+			return path;
+		}
+
+		path_type operator/(const path_type& p) const {
+			return path / p;
+		}
+	};
+}
@@ -0,0 +1,44 @@
+#include <vector>
+
+#include "augs/log.h"
+#include "augs/internal_benchmarks.h"
+#include "augs/misc/timing/timer.h"
+
+namespace augs {
+	struct internal_benchmark {
+		const char* name;
+		internal_benchmark_function run;
+	};
+
+	static auto& get_internal_benchmarks() {
+		static std::vector<internal_benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	internal_benchmark_registrar::internal_benchmark_registrar(
+		const char* const name,
+		const internal_benchmark_function run
+	) {
+		get_internal_benchmarks().push_back({ name, run });
+	}
+
+	std::size_t run_internal_benchmarks(const std::string& filter) {
+		std::size_t num_run = 0;
+
+		for (const auto& b : get_internal_benchmarks()) {
+			if (filter != "all" && std::string(b.name).find(filter) == std::string::npos) {
+				continue;
+			}
+
+			LOG("Running benchmark: %x", b.name);
+
+			augs::timer t;
+			b.run();
+
+			LOG("%x finished in %x s.", b.name, t.get<std::chrono::seconds>());
+			++num_run;
+		}
+
+		return num_run;
+	}
+}
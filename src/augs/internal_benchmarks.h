@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/*
+	Timing comparisons of optimized code paths against their straightforward counterparts.
+	Unit tests only check behavior, so whatever measures time belongs here.
+
+	Benchmarks are defined next to the code they measure, under BUILD_INTERNAL_BENCHMARKS,
+	and only ever run with --benchmark-internals.
+*/
+
+namespace augs {
+	using internal_benchmark_function = void(*)();
+
+	struct internal_benchmark_registrar {
+		internal_benchmark_registrar(const char* name, internal_benchmark_function);
+	};
+
+	/* Runs all benchmarks whose name contains the filter, or every benchmark if it is "all". Returns how many have run. */
+	std::size_t run_internal_benchmarks(const std::string& filter);
+}
+
+#define INTERNAL_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define INTERNAL_BENCHMARK_CONCAT(a, b) INTERNAL_BENCHMARK_CONCAT_IMPL(a, b)
+#define INTERNAL_BENCHMARK_FUNCTION INTERNAL_BENCHMARK_CONCAT(internal_benchmark_, __LINE__)
+
+#define INTERNAL_BENCHMARK(name) \
+	static void INTERNAL_BENCHMARK_FUNCTION(); \
+	static const augs::internal_benchmark_registrar INTERNAL_BENCHMARK_CONCAT(internal_benchmark_registrar_, __LINE__)(name, INTERNAL_BENCHMARK_FUNCTION); \
+	static void INTERNAL_BENCHMARK_FUNCTION()
@@ -1,13 +1,20 @@
 #include <string>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <condition_variable>
 
 #include "augs/log.h"
+#include "augs/log_async.h"
 #include "augs/math/vec2.h"
 #include "augs/app_type.h"
 
 #include "augs/filesystem/file.h"
 #include "augs/string/string_templates.h"
+#include "augs/templates/algorithm_templates.h"
+#include "augs/templates/container_templates.h"
 #include "augs/log_path_getters.h"
 #include "augs/misc/date_time.h"
 #include "augs/misc/mutex.h"
@@ -34,6 +41,9 @@ std::string log_timestamp_format;
 std::string live_log_path;
 app_type current_app_type;
 
+/* Opened once and kept open, guarded by log_mutex. */
+static std::ofstream live_log_file;
+
 std::string get_path_in_log_files(const std::string& name) {
 	return (LOGS_DIR / (get_preffix_for(current_app_type) + name)).string();
 }
@@ -70,6 +80,8 @@ void program_log::push_entry(const log_entry& new_entry) {
 }
 
 void program_log::mark_last_init_log() {
+	augs::flush_log();
+
 	auto lock = augs::scoped_lock(log_mutex);
 
 	init_logs_count = all_entries.size();
@@ -86,6 +98,8 @@ std::size_t program_log::get_init_logs_count_nomutex() const {
 }
 
 std::string program_log::get_complete() const {
+	augs::flush_log();
+
 	auto lock = augs::scoped_lock(log_mutex);
 
 	auto logs = std::string();
@@ -102,29 +116,328 @@ std::string& LOG_THREAD_PREFFIX() {
 	return preffix;
 }
 
-void LOG_NOFORMAT(const std::string& s) {
-#if ENABLE_LOG 
-	auto lock = augs::scoped_lock(log_mutex);
+struct queued_log_line {
+	uint64_t order = 0;
+	std::chrono::system_clock::time_point when;
+	std::string text;
+};
+
+/* Has to be called under log_mutex. */
+
+static std::string with_timestamp(const std::chrono::system_clock::time_point& when, const std::string& text) {
+	if (log_timestamp_format.empty()) {
+		return text;
+	}
+
+	return augs::date_time(when).get_readable_format(::log_timestamp_format.c_str()) + text;
+}
+
+struct async_log_writer {
+	/* Has to be called under log_mutex. */
+
+	template <class F>
+	static void output(F for_each_line) {
+#if OUTPUT_TO_STDOUT
+		std::string batch;
+#endif
+
+		if (log_to_live_file && !live_log_file.is_open()) {
+			live_log_file.open(live_log_path, std::ios::out | std::ios::app);
+		}
+
+		const bool to_live_file = log_to_live_file && live_log_file.is_open();
+
+		for_each_line([&](std::string&& line) {
+#if OUTPUT_TO_STDOUT
+			batch += line;
+			batch += '\n';
+#endif
+
+			if (to_live_file) {
+				live_log_file << line << '\n';
+			}
+
+			program_log::get_current().push_entry({ std::move(line) });
+		});
 
-	auto lg = [&](const auto& f) {
-		program_log::get_current().push_entry({ f });
 #if OUTPUT_TO_STDOUT
-		std::cout << f << std::endl;
+		std::cout << batch << std::flush;
 #endif
 
-		if (log_to_live_file) {
-			std::ofstream recording_file(live_log_path, std::ios::out | std::ios::app);
-			recording_file << f << std::endl;
+		if (to_live_file) {
+			live_log_file.flush();
 		}
+	}
+
+#if !WEB_SINGLETHREAD
+	/*
+		Every thread that logs gets its own ring, written only by that thread.
+		A full ring drops the new line instead of blocking the thread.
+	*/
+
+	static constexpr std::size_t lines_per_thread = 1024;
+
+	struct thread_ring {
+		std::atomic<uint64_t> num_pushed = 0;
+		std::atomic<uint64_t> num_popped = 0;
+		std::atomic<uint64_t> num_dropped = 0;
+		std::atomic<bool> abandoned = false;
+
+		std::unique_ptr<queued_log_line[]> lines = std::make_unique<queued_log_line[]>(lines_per_thread);
 	};
 
-	if (log_timestamp_format.empty()) {
-		lg(LOG_THREAD_PREFFIX() + s);
+	/*
+		The writer frees a ring once its thread has exited.
+		A LOG from a thread_local destructor that runs after ring_owner's must not touch it,
+		so the owner leaves this flag behind. It is trivially destructible, so it outlives the owner.
+	*/
+
+	static inline thread_local bool ring_torn_down = false;
+
+	struct ring_owner {
+		thread_ring* ring = nullptr;
+
+		~ring_owner() {
+			if (ring != nullptr) {
+				ring->abandoned.store(true, std::memory_order_release);
+				ring = nullptr;
+			}
+
+			ring_torn_down = true;
+		}
+	};
+
+	std::atomic<bool> running = false;
+	std::atomic<uint64_t> next_order = 0;
+
+	std::mutex rings_lk;
+	std::vector<std::unique_ptr<thread_ring>> rings;
+
+	/* Only one thread may pop from the rings at a time. */
+	std::mutex drain_lk;
+	std::vector<queued_log_line> drained;
+
+	uint64_t num_written = 0;
+	uint64_t num_dropped = 0;
+	uint64_t num_reported_dropped = 0;
+
+	std::mutex wake_lk;
+	std::condition_variable wake_cv;
+	bool quit = false;
+
+	std::thread writer;
+
+	static auto& get_instance() {
+		/* Never destroyed, so that a late LOG during static destruction still finds it. */
+		static auto* const instance = new async_log_writer;
+		return *instance;
+	}
+
+	/* Null once this thread's ring was torn down. */
+
+	thread_ring* find_ring_of_this_thread() {
+		if (ring_torn_down) {
+			return nullptr;
+		}
+
+		thread_local ring_owner owner;
+
+		if (owner.ring == nullptr) {
+			std::scoped_lock lock(rings_lk);
+
+			rings.emplace_back(std::make_unique<thread_ring>());
+			owner.ring = rings.back().get();
+		}
+
+		return owner.ring;
+	}
+
+	bool push(thread_ring& ring, std::string&& text) {
+		const auto pushed = ring.num_pushed.load(std::memory_order_relaxed);
+
+		if (pushed - ring.num_popped.load(std::memory_order_acquire) >= lines_per_thread) {
+			ring.num_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		auto& line = ring.lines[pushed % lines_per_thread];
+
+		line.order = next_order.fetch_add(1, std::memory_order_relaxed);
+		line.when = std::chrono::system_clock::now();
+		line.text = std::move(text);
+
+		ring.num_pushed.store(pushed + 1, std::memory_order_release);
+		return true;
+	}
+
+	void drain() {
+		std::scoped_lock lock(drain_lk);
+
+		drained.clear();
+
+		uint64_t dropped_total = 0;
+
+		{
+			std::scoped_lock rings_lock(rings_lk);
+
+			for (auto& r : rings) {
+				/* Checked before popping, so that the last lines of an exited thread are not missed. */
+				const bool abandoned = r->abandoned.load(std::memory_order_acquire);
+
+				const auto pushed = r->num_pushed.load(std::memory_order_acquire);
+				auto popped = r->num_popped.load(std::memory_order_relaxed);
+
+				for (; popped < pushed; ++popped) {
+					drained.emplace_back(std::move(r->lines[popped % lines_per_thread]));
+				}
+
+				r->num_popped.store(popped, std::memory_order_release);
+
+				const auto ring_dropped = r->num_dropped.load(std::memory_order_relaxed);
+
+				if (abandoned) {
+					num_dropped += ring_dropped;
+					r.reset();
+				}
+				else {
+					dropped_total += ring_dropped;
+				}
+			}
+
+			erase_if(rings, [](const auto& r) { return r == nullptr; });
+		}
+
+		const auto now_dropped = num_dropped + dropped_total;
+		const auto newly_dropped = now_dropped - num_reported_dropped;
+
+		if (drained.empty() && newly_dropped == 0) {
+			return;
+		}
+
+		sort_range(drained, [](const auto& a, const auto& b) { return a.order < b.order; });
+
+		auto lock_log = augs::scoped_lock(log_mutex);
+
+		output([&](auto emit) {
+			for (auto& l : drained) {
+				emit(with_timestamp(l.when, l.text));
+			}
+
+			if (newly_dropped > 0) {
+				emit(with_timestamp(std::chrono::system_clock::now(), typesafe_sprintf("Dropped %x log lines as the log writer could not keep up.", newly_dropped)));
+			}
+		});
+
+		num_written += drained.size();
+		num_reported_dropped = now_dropped;
+	}
+
+	void start() {
+		if (running.load()) {
+			return;
+		}
+
+		quit = false;
+		running.store(true);
+
+		writer = std::thread([this]() {
+			/* Batches whatever was logged in the meantime into a single write. */
+			const auto write_once_every = std::chrono::milliseconds(5);
+
+			while (true) {
+				drain();
+
+				std::unique_lock<std::mutex> lock(wake_lk);
+
+				if (wake_cv.wait_for(lock, write_once_every, [this]() { return quit; })) {
+					break;
+				}
+			}
+		});
+	}
+
+	void stop() {
+		if (!running.load()) {
+			return;
+		}
+
+		running.store(false);
+
+		{
+			std::scoped_lock lock(wake_lk);
+			quit = true;
+		}
+
+		wake_cv.notify_all();
+		writer.join();
+
+		drain();
 	}
-	else {
-		lg(augs::date_time().get_readable_format(::log_timestamp_format.c_str()) + LOG_THREAD_PREFFIX() + s);
+#endif
+};
+
+namespace augs {
+	void start_async_log() {
+#if !WEB_SINGLETHREAD
+		async_log_writer::get_instance().start();
+#endif
+	}
+
+	void stop_async_log() {
+#if !WEB_SINGLETHREAD
+		async_log_writer::get_instance().stop();
+#endif
+	}
+
+	void flush_log() {
+#if !WEB_SINGLETHREAD
+		auto& w = async_log_writer::get_instance();
+
+		if (w.running.load(std::memory_order_acquire)) {
+			w.drain();
+		}
+#endif
+	}
+
+	async_log_stats get_async_log_stats() {
+		async_log_stats stats;
+
+#if !WEB_SINGLETHREAD
+		auto& w = async_log_writer::get_instance();
+
+		std::scoped_lock lock(w.drain_lk);
+
+		stats.num_written = w.num_written;
+		stats.num_dropped = w.num_reported_dropped;
+#endif
+
+		return stats;
+	}
+}
+
+void LOG_NOFORMAT(const std::string& s) {
+#if ENABLE_LOG 
+#if !WEB_SINGLETHREAD
+	auto& w = async_log_writer::get_instance();
+
+	if (w.running.load(std::memory_order_acquire)) {
+		if (const auto ring = w.find_ring_of_this_thread()) {
+			w.push(*ring, LOG_THREAD_PREFFIX() + s);
+			return;
+		}
+
+		/* The thread is exiting and its ring is gone, so write the line directly, like before the writer started. */
 	}
+#endif
+
+	const auto when = std::chrono::system_clock::now();
+
+	auto lock = augs::scoped_lock(log_mutex);
+
+	async_log_writer::output([&](auto emit) {
+		emit(with_timestamp(when, LOG_THREAD_PREFFIX() + s));
+	});
 #else
 	(void)s;
 #endif
-}
\ No newline at end of file
+}
@@ -16,7 +16,7 @@ class program_log {
 	unsigned max_all_entries;
 
 	void push_entry(const log_entry&);
-	friend void LOG_NOFORMAT(const std::string& f);
+	friend struct async_log_writer;
 
 public:
 	static auto& get_current() {
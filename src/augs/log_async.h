@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+
+namespace augs {
+	struct async_log_stats {
+		std::size_t num_written = 0;
+		std::size_t num_dropped = 0;
+	};
+
+	/*
+		Once started, LOG only queues the line in a ring of the calling thread
+		and a background thread writes the queued lines in batches.
+		Lines that do not fit in a full ring are dropped and counted.
+	*/
+
+	void start_async_log();
+	void stop_async_log();
+
+	/* Writes out all lines queued so far. */
+	void flush_log();
+
+	async_log_stats get_async_log_stats();
+}
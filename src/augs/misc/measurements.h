@@ -7,6 +7,7 @@
 #include "augs/templates/algorithm_templates.h"
 #include "augs/misc/timing/timer.h"
 #include "augs/misc/scope_guard.h"
+#include "augs/misc/trace_recorder_declaration.h"
 
 namespace augs {
 	template <class derived, class T = double>
@@ -19,6 +20,9 @@ namespace augs {
 		T last_maximum = T();
 		T last_measurement = T();
 
+		T total = T();
+		std::size_t num_measurements = 0;
+
 		bool measured = false;
 
 		struct summary_data {
@@ -47,6 +51,9 @@ namespace augs {
 			measured = true;
 			last_measurement = value;
 
+			total += value;
+			++num_measurements;
+
 			tracked[measurement_index] = last_measurement;
 			++measurement_index;
 			measurement_index %= tracked.size();
@@ -87,6 +94,16 @@ namespace augs {
 			return last_measurement;
 		}
 
+		/* Unlike the average, these cover every measurement ever made. */
+
+		T get_total_units() const {
+			return total;
+		}
+
+		std::size_t get_num_measurements() const {
+			return num_measurements;
+		}
+
 		bool was_measured() const {
 			return summary_info.measured;
 		}
@@ -116,6 +133,7 @@ namespace augs {
 
 	class time_measurements : public measurements<time_measurements, double> {
 		timer tm;
+		uint32_t trace_name_id = 0;
 
 		using base = measurements<time_measurements, double>;
 		friend base;
@@ -150,7 +168,12 @@ namespace augs {
 		}
 
 		void stop() {
-			measure(tm.get<std::chrono::seconds>());
+			const auto secs = tm.get<std::chrono::seconds>();
+			measure(secs);
+
+			if (const auto recorder = current_trace_recorder) {
+				record_trace_event(*recorder, trace_name_id, title, secs);
+			}
 		}
 	};
 
@@ -178,6 +178,61 @@ void test_pool() {
 	REQUIRE(5 == p.size());
 }
 
+TEST_CASE("Pool AssignChangedFrom") {
+	p_t source = p_t(6);
+	p_t target = p_t(6);
+
+	kv_t keys;
+
+	for (int i = 0; i < 4; ++i) {
+		keys.push_back(source.allocate(i).key);
+	}
+
+	/* Never synced, so all objects are compared. */
+
+	REQUIRE(4 == target.assign_changed_from(source));
+	REQUIRE(0 == target.assign_changed_from(source));
+
+	target.forget_changes_in_sync_with(source);
+
+	REQUIRE(!target.might_differ_from(source));
+	REQUIRE(0 == target.assign_changed_from(source));
+
+	source.get(keys[1]) = 20;
+	source.get(keys[3]) = 40;
+
+	REQUIRE(target.might_differ_from(source));
+	REQUIRE(2 == target.assign_changed_from(source));
+	REQUIRE(20 == target.get(keys[1]));
+	REQUIRE(40 == target.get(keys[3]));
+
+	target.forget_changes_in_sync_with(source);
+
+	/* Marks come from write access alone, on either side. */
+
+	target.get(keys[2]) = 2;
+	REQUIRE(1 == target.assign_changed_from(source));
+
+	target.forget_changes_in_sync_with(source);
+
+	{
+		const p_t copied = target;
+		REQUIRE(copied.might_differ_from(source));
+	}
+
+	/* The last object moves into the freed slot and a new one is allocated in its place. */
+
+	source.free(keys[0]);
+	const auto new_key = source.allocate(100).key;
+
+	REQUIRE(2 == target.assign_changed_from(source));
+
+	REQUIRE(target.dead(keys[0]));
+	REQUIRE(100 == target.get(new_key));
+	REQUIRE(source.size() == target.size());
+	REQUIRE(source.indirectors_equal(target));
+}
+
 TEST_CASE("Pool Readwrite") {
 	test_pool<augs::pool<float, of_size<100>::make_nontrivial_constant_vector, unsigned short>>();
 	test_pool<augs::pool<float, make_vector, unsigned char>>();
@@ -185,3 +240,56 @@ TEST_CASE("Pool Readwrite") {
 
 #endif
 #endif
+
+#if BUILD_UNIT_TESTS && BUILD_TEST_SCENES
+#include "test_scenes/test_scene_fixture.h"
+#include "test_scenes/create_test_scene_entity.h"
+#include "game/cosmos/cosmic_functions.h"
+#include "game/cosmos/entity_handle.h"
+#include "game/organization/all_component_includes.h"
+
+TEST_CASE("Pool UndoDeleteSplitComponents") {
+	const auto scene = make_test_scene_cosmos();
+
+	auto& cosm = *scene;
+
+	/*
+		The entity pool keeps split components in columns of their own.
+		Another character after the deleted one makes the undo move it out of the restored slot.
+	*/
+
+	const auto character = create_test_scene_entity(cosm, test_controlled_characters::METROPOLIS_SOLDIER, vec2(0, 0));
+	create_test_scene_entity(cosm, test_controlled_characters::RESISTANCE_SOLDIER, vec2(300, 0));
+
+	using E = entity_type_of<decltype(character)>;
+	static_assert(num_types_in_list_v<split_components_of<E>> > 0);
+
+	const auto moved_to = transformr(vec2(1234, -567), 45);
+	character.set_logic_transform(moved_to);
+
+	auto& health = character.template get<components::sentience>().template get<health_meter_instance>();
+	health.value = 13;
+
+	const auto id = character.get_id();
+	const auto deleted_content = character.get();
+
+	auto deleted_split_content = make_split_components<E>();
+
+	for_each_through_std_get(deleted_split_content, [&](auto& c) {
+		using C = remove_cref<decltype(c)>;
+		c = character.template get_raw_component<C>();
+	});
+
+	const auto undo_delete_input = cosmic::delete_entity(cosm[id]);
+
+	REQUIRE(undo_delete_input.has_value());
+	REQUIRE(cosm[id].dead());
+
+	const auto undeleted = cosmic::undo_delete_entity(cosm, *undo_delete_input, deleted_content, deleted_split_content, reinference_type::ONLY_AFFECTED);
+
+	REQUIRE(undeleted.get_id() == id);
+	REQUIRE(undeleted.get_logic_transform().pos == moved_to.pos);
+	REQUIRE(undeleted.get_logic_transform().rotation == moved_to.rotation);
+	REQUIRE(undeleted.template get<components::sentience>().template get<health_meter_instance>().value == 13);
+}
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <cstring>
 
 #if !IS_PRODUCTION_BUILD
 #include "augs/ensure.h"
@@ -11,6 +12,7 @@
 #include "augs/templates/container_templates.h"
 
 #include "augs/misc/pool/pool_structs.h"
+#include "augs/misc/pool/pool_change_marks.h"
 #include "augs/misc/pool/pooled_object_id.h"
 #include "augs/templates/per_type.h"
 
@@ -41,6 +43,8 @@ namespace augs {
 		make_container_type<size_type> free_indirectors;
 		per_type_container<synchronized_array_list, make_container_type> synchronized_arrays;
 
+		pool_change_marks changes;
+
 		auto& get_indirector(const key_type key) {
 			return indirectors[key.indirection_index];
 		}
@@ -113,6 +117,7 @@ namespace augs {
 
 			indirectors.resize(new_capacity);
 			free_indirectors.reserve(new_capacity);
+			changes.reserve(new_capacity);
 
 			for (size_type i = 0; i < (new_capacity - old_capacity); ++i) {
 				free_indirectors.push_back(new_capacity - i - 1);
@@ -187,12 +192,21 @@ namespace augs {
 			ensure_versions_match(indirector, key);
 #endif
 
-			return self.objects[indirector.real_index];
+			return self.nth_impl(self, indirector.real_index);
+		}
+
+		template <class S>
+		static auto& nth_impl(S& self, const size_type real_index) {
+			if constexpr(!std::is_const_v<S>) {
+				self.changes.mark(real_index);
+			}
+
+			return self.objects[real_index];
 		}
 		
 		template <class S>
 		static auto& get_no_check_impl(S& self, const unversioned_id_type key) {
-			return self.objects[self.indirectors[key.indirection_index].real_index];
+			return nth_impl(self, self.indirectors[key.indirection_index].real_index);
 		}
 
 		template <class S>
@@ -207,13 +221,13 @@ namespace augs {
 				return nullptr;
 			}
 
-			return &self.objects[indirector.real_index];
+			return &nth_impl(self, indirector.real_index);
 		}
 
 		template <class S>
 		static auto find_no_check_impl(S& self, const unversioned_id_type key) -> maybe_const_ptr_t<std::is_const_v<S>, mapped_type> {
 			if (key.is_set()) {
-				return &self.objects[self.indirectors[key.indirection_index].real_index];
+				return &nth_impl(self, self.indirectors[key.indirection_index].real_index);
 			}
 
 			return nullptr;
@@ -260,7 +274,16 @@ namespace augs {
 			return !alive(key);
 		}
 
+		mapped_type& get_nth(const size_type real_index) {
+			return nth_impl(*this, real_index);
+		}
+
+		const mapped_type& get_nth(const size_type real_index) const {
+			return nth_impl(*this, real_index);
+		}
+
 		mapped_type* data() {
+			changes.mark_all();
 			return objects.data();
 		}
 
@@ -320,6 +343,148 @@ namespace augs {
 			;
 		}
 
+		/*
+			Makes this pool equal to the source pool,
+			writing only the objects that were accessed for writing in either of them
+			since they were last put in sync with each other (see forget_changes_in_sync_with).
+
+			If the two weren't in sync before, or either was copied, read or cleared since,
+			every object is compared bytewise instead.
+
+			The slots, indirectors and free indirectors are always copied whole.
+			Synchronized arrays follow the objects.
+
+			Returns the number of objects that had to be written.
+		*/
+
+		size_type assign_changed_from(const pool& source) {
+			static_assert(std::is_trivially_copyable_v<mapped_type>, "Can't compare objects bytewise.");
+
+			slots = source.slots;
+			indirectors = source.indirectors;
+			free_indirectors = source.free_indirectors;
+
+			if (!changes_tracked_with(source)) {
+				return assign_by_comparing_all(source);
+			}
+
+			const auto old_n = static_cast<std::size_t>(objects.size());
+			const auto n = static_cast<std::size_t>(source.objects.size());
+			const auto common_n = std::min(old_n, n);
+
+			size_type num_copied = 0;
+
+			changes.for_each_marked_in_either(source.changes, [&](const std::size_t i) {
+				if (i >= common_n) {
+					return;
+				}
+
+				objects[i] = source.objects[i];
+
+				if constexpr(has_synchronized_arrays) {
+					synchronized_arrays.for_each_container(
+						[&](auto& container) {
+							using C = std::remove_cvref_t<decltype(container)>;
+							container[i] = source.synchronized_arrays.template get<C>()[i];
+						}
+					);
+				}
+
+				++num_copied;
+			});
+
+			while (static_cast<std::size_t>(objects.size()) > n) {
+				objects.pop_back();
+
+				if constexpr(has_synchronized_arrays) {
+					synchronized_arrays.for_each_container(
+						[&](auto& container) {
+							container.pop_back();
+						}
+					);
+				}
+			}
+
+			for (std::size_t i = old_n; i < n; ++i) {
+				objects.emplace_back(source.objects[i]);
+
+				if constexpr(has_synchronized_arrays) {
+					synchronized_arrays.for_each_container(
+						[&](auto& container) {
+							using C = std::remove_cvref_t<decltype(container)>;
+							container.emplace_back(source.synchronized_arrays.template get<C>()[i]);
+						}
+					);
+				}
+
+				++num_copied;
+			}
+
+			return num_copied;
+		}
+
+		/*
+			Tells both pools that they are equal now,
+			so that the next assign_changed_from between them only writes what gets accessed for writing until then.
+		*/
+
+		void forget_changes_in_sync_with(pool& b) {
+			/* Copies and reads don't reserve marks, so they are reserved here, before they start counting. */
+			changes.reserve(capacity());
+			b.changes.reserve(b.capacity());
+
+			changes.clear_and_partner_with(std::addressof(b));
+			b.changes.clear_and_partner_with(this);
+		}
+
+		bool changes_tracked_with(const pool& b) const {
+			return
+				!changes.all_marked()
+				&& !b.changes.all_marked()
+				&& changes.in_sync_with(std::addressof(b))
+				&& b.changes.in_sync_with(this)
+			;
+		}
+
+		/* False only if both pools are known to be equal. */
+
+		bool might_differ_from(const pool& b) const {
+			if (!changes_tracked_with(b)) {
+				return true;
+			}
+
+			return changes.any_marked() || b.changes.any_marked();
+		}
+
+	private:
+		size_type assign_by_comparing_all(const pool& source) {
+			if constexpr(has_synchronized_arrays) {
+				synchronized_arrays = source.synchronized_arrays;
+			}
+
+			const auto n = source.objects.size();
+
+			if (objects.size() != n) {
+				objects = source.objects;
+				return static_cast<size_type>(n);
+			}
+
+			size_type num_copied = 0;
+
+			for (std::size_t i = 0; i < n; ++i) {
+				auto& target_object = objects[i];
+				const auto& source_object = source.objects[i];
+
+				if (std::memcmp(std::addressof(target_object), std::addressof(source_object), sizeof(mapped_type))) {
+					std::memcpy(std::addressof(target_object), std::addressof(source_object), sizeof(mapped_type));
+					++num_copied;
+				}
+			}
+
+			return num_copied;
+		}
+
+	public:
 		template <class F>
 		void for_each_id_and_object(F f) {
 			key_type id;
@@ -329,7 +494,7 @@ namespace augs {
 				id.indirection_index = s.pointing_indirector;
 				id.version = indirectors[s.pointing_indirector].version;
 
-				f(id, objects[i]);
+				f(id, get_nth(i));
 			}
 		}
 
@@ -347,6 +512,7 @@ namespace augs {
 		}
 
 		auto begin() {
+			changes.mark_all();
 			return objects.begin();
 		}
 
@@ -355,6 +521,7 @@ namespace augs {
 		}
 
 		auto end() {
+			changes.mark_all();
 			return objects.end();
 		}
 
@@ -397,6 +564,8 @@ namespace augs {
 		}
 
 		void clear() {
+			changes.mark_all();
+
 			objects.clear();
 			slots.clear();
 			indirectors.clear();
@@ -409,6 +578,7 @@ namespace augs {
 
 		template <class C>
 		auto& get_corresponding_array() {
+			changes.mark_all();
 			return synchronized_arrays.template get_for<C>();
 		}
 
@@ -420,6 +590,7 @@ namespace augs {
 		template <class C>
 		C& get_corresponding(mapped_type& object) {
 			const auto idx = index_in(objects, object);
+			changes.mark(idx);
 			return synchronized_arrays.template get_for<C>()[idx];
 		}
 
@@ -41,6 +41,7 @@ namespace augs {
 
 		slots.push_back(allocated_slot);
 		objects.emplace_back(std::forward<Args>(args)...);
+		changes.mark(new_slot_index);
 
 		if constexpr(has_synchronized_arrays) {
 			synchronized_arrays.for_each_container(
@@ -79,6 +80,8 @@ namespace augs {
 			/* ...and mark it as unused. */
 			indirector.real_index = static_cast<size_type>(-1);
 
+			changes.mark(removed_at_index);
+
 			slots.pop_back();
 			objects.pop_back();
 
@@ -127,6 +130,9 @@ namespace augs {
 		/* ...and mark it as unused. */
 		indirector.real_index = static_cast<size_type>(-1);
 
+		changes.mark(removed_at_index);
+		changes.mark(size() - 1);
+
 		if (removed_at_index != size() - 1) {
 			{
 				const auto indirector_of_last_element = slots.back().pointing_indirector;
@@ -191,6 +197,9 @@ namespace augs {
 		indirector.real_index = real_index;
 		--indirector.version;
 
+		changes.mark(real_index);
+		changes.mark(size());
+
 		auto get_new_key = [&](){
 			key_type new_key;
 			new_key.version = indirector.version;
@@ -222,9 +231,17 @@ namespace augs {
 			if constexpr(has_synchronized_arrays) {
 				synchronized_arrays.for_each_container(
 					[&](auto& container) {
+						/* Ensure new_space isn't invalidated */
+						container.reserve(container.size() + 1);
+
 						auto& new_space = container[real_index];
+						using value_type = std::remove_reference_t<decltype(new_space)>;
+
 						container.emplace_back(std::move(new_space));
+
+						/* The caller assigns to the restored slot, so it must hold a live object. */
 						std::destroy_at(std::addressof(new_space));
+						new (std::addressof(new_space)) value_type();
 					}
 				);
 			}
@@ -0,0 +1,145 @@
+#pragma once
+#include <bit>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace augs {
+	/*
+		Remembers which objects of a pool were accessed for writing
+		since the pool was last brought in sync with its partner (see pool::assign_changed_from).
+
+		Marks are set by the mutable accessors of the pool, so a mark only means that an object might have changed.
+		Setting a mark is thread-safe, as the solver accesses entities from many threads at once.
+		Anything else - resizing, clearing, syncing - must happen on a single thread.
+
+		Marks are not state. A copied pool starts with everything marked and with no partner,
+		so its first sync compares all objects.
+	*/
+
+	class pool_change_marks {
+		using word_type = std::uint64_t;
+		static constexpr std::size_t bits_per_word = 64;
+
+		std::unique_ptr<std::atomic<word_type>[]> words;
+		std::size_t num_words = 0;
+
+		bool all = true;
+		const void* partner = nullptr;
+
+		static auto words_for(const std::size_t capacity) {
+			return (capacity + bits_per_word - 1) / bits_per_word;
+		}
+
+	public:
+		pool_change_marks() = default;
+
+		pool_change_marks(const pool_change_marks&) : pool_change_marks() {}
+		pool_change_marks(pool_change_marks&&) : pool_change_marks() {}
+
+		pool_change_marks& operator=(const pool_change_marks&) {
+			mark_all();
+			return *this;
+		}
+
+		pool_change_marks& operator=(pool_change_marks&&) {
+			mark_all();
+			return *this;
+		}
+
+		void reserve(const std::size_t capacity) {
+			const auto new_num_words = words_for(capacity);
+
+			if (new_num_words <= num_words) {
+				return;
+			}
+
+			auto new_words = std::make_unique<std::atomic<word_type>[]>(new_num_words);
+
+			for (std::size_t i = 0; i < new_num_words; ++i) {
+				new_words[i].store(i < num_words ? words[i].load(std::memory_order_relaxed) : 0, std::memory_order_relaxed);
+			}
+
+			words = std::move(new_words);
+			num_words = new_num_words;
+		}
+
+		void mark(const std::size_t index) {
+			if (all) {
+				return;
+			}
+
+			const auto w = index / bits_per_word;
+
+			if (w >= num_words) {
+				/* The pool reserves marks for its whole capacity, so this never happens for its objects. */
+				return;
+			}
+
+			const auto bit = word_type(1) << (index % bits_per_word);
+			auto& word = words[w];
+
+			if (!(word.load(std::memory_order_relaxed) & bit)) {
+				word.fetch_or(bit, std::memory_order_relaxed);
+			}
+		}
+
+		void mark_all() {
+			all = true;
+			partner = nullptr;
+		}
+
+		bool all_marked() const {
+			return all;
+		}
+
+		bool in_sync_with(const void* const other) const {
+			return partner == other;
+		}
+
+		bool any_marked() const {
+			if (all) {
+				return true;
+			}
+
+			for (std::size_t i = 0; i < num_words; ++i) {
+				if (words[i].load(std::memory_order_relaxed)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/* Calls the callback for every marked index in the union of both marks, in increasing order. */
+
+		template <class F>
+		void for_each_marked_in_either(const pool_change_marks& b, F&& callback) const {
+			const auto n = std::max(num_words, b.num_words);
+
+			for (std::size_t i = 0; i < n; ++i) {
+				auto word =
+					(i < num_words ? words[i].load(std::memory_order_relaxed) : 0)
+					| (i < b.num_words ? b.words[i].load(std::memory_order_relaxed) : 0)
+				;
+
+				while (word) {
+					const auto bit_index = static_cast<std::size_t>(std::countr_zero(word));
+					callback(i * bits_per_word + bit_index);
+					word &= word - 1;
+				}
+			}
+		}
+
+		void clear_and_partner_with(const void* const new_partner) {
+			for (std::size_t i = 0; i < num_words; ++i) {
+				words[i].store(0, std::memory_order_relaxed);
+			}
+
+			all = false;
+			partner = new_partner;
+		}
+	};
+}
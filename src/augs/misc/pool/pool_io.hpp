@@ -2,6 +2,7 @@
 #include "augs/misc/pool/pool.h"
 
 #include "augs/readwrite/byte_readwrite_declaration.h"
+#include "augs/readwrite/special_readwrite_traits.h"
 
 namespace augs {
 	template <class A, template <class> class B, class C, class D, class... E>
@@ -16,6 +17,26 @@ namespace augs {
 		w(slots);
 		w(indirectors);
 		w(free_indirectors);
+
+		if constexpr(has_synchronized_arrays) {
+			synchronized_arrays.for_each_container(
+				[&](const auto& container) {
+					using V = typename remove_cref<decltype(container)>::value_type;
+
+					if constexpr(is_pool_column_v<V>) {
+						using Column = remove_cref<decltype(container)>;
+
+						if constexpr(has_special_column_write_v<Archive, pool, Column>) {
+							/* Written after the slots and indirectors, so that the reader knows the ids. */
+							ar.special_write_column(*this, container);
+						}
+						else {
+							w(container);
+						}
+					}
+				}
+			);
+		}
 	}
 
 	template <class A, template <class> class B, class C, class D, class... E>
@@ -26,6 +47,8 @@ namespace augs {
 			augs::read_bytes(ar, object);
 		};
 
+		changes.mark_all();
+
 		r(objects);
 		r(slots);
 		r(indirectors);
@@ -34,7 +57,21 @@ namespace augs {
 		if constexpr(has_synchronized_arrays) {
 			synchronized_arrays.for_each_container(
 				[&](auto& container) {
-					container.resize(objects.size());
+					using V = typename remove_cref<decltype(container)>::value_type;
+
+					if constexpr(is_pool_column_v<V>) {
+						using Column = remove_cref<decltype(container)>;
+
+						if constexpr(has_special_column_read_v<Archive, pool, Column>) {
+							ar.special_read_column(*this, container);
+						}
+						else {
+							r(container);
+						}
+					}
+					else {
+						container.resize(objects.size());
+					}
 				}
 			);
 		}
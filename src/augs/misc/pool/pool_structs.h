@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 
 namespace augs {
 /*	
@@ -27,4 +28,28 @@ namespace augs {
 		size_type real_index = static_cast<size_type>(-1);
 		size_type indirection_index = static_cast<size_type>(-1);
 	};
+
+	/*
+		Wrap a type in pool's synchronized array list
+		to keep a column of it alongside the objects, one value per object.
+
+		Unlike the other synchronized arrays, which only hold inferrable data,
+		columns are state - they are serialized together with the objects.
+	*/
+
+	template <class T>
+	struct pool_column {
+		// GEN INTROSPECTOR struct augs::pool_column class T
+		T value;
+		// END GEN INTROSPECTOR
+	};
+
+	template <class T>
+	struct is_pool_column : std::false_type {};
+
+	template <class T>
+	struct is_pool_column<pool_column<T>> : std::true_type {};
+
+	template <class T>
+	constexpr bool is_pool_column_v = is_pool_column<T>::value;
 }
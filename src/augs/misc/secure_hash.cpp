@@ -101,3 +101,32 @@ namespace augs {
 		return output;
 	}
 }
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/misc/streaming_hasher.h"
+
+TEST_CASE("SecureHash StreamingHasherMatchesOneShot") {
+	std::vector<std::byte> bytes;
+
+	for (std::size_t i = 0; i < 20000; ++i) {
+		bytes.push_back(static_cast<std::byte>((i * 31) % 251));
+	}
+
+	augs::streaming_hasher hasher;
+
+	std::size_t pos = 0;
+	std::size_t piece = 1;
+
+	while (pos < bytes.size()) {
+		const auto n = std::min(piece, bytes.size() - pos);
+		hasher.write_bytes(bytes.data() + pos, n);
+
+		pos += n;
+		piece = (piece * 7) % 5000 + 1;
+	}
+
+	const auto streamed = hasher.finalize<augs::secure_hash_type>();
+	REQUIRE(streamed == augs::secure_hash(bytes));
+}
+#endif
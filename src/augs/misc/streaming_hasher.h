@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#include "3rdparty/blake3/blake3.h"
+
+namespace augs {
+	/*
+		Hashes trivially copyable values as they come,
+		without serializing them into an intermediate memory_stream first.
+
+		Small writes are gathered in a fixed buffer of a few blake3 chunks,
+		so that blake3 always receives input wide enough for its SIMD paths.
+	*/
+
+	class streaming_hasher {
+		static constexpr std::size_t batch_size_v = BLAKE3_CHUNK_LEN * 4;
+
+		blake3_hasher hasher;
+		std::array<uint8_t, batch_size_v> batch;
+		std::size_t num_batched = 0;
+
+		void flush() {
+			if (num_batched > 0) {
+				blake3_hasher_update(&hasher, batch.data(), num_batched);
+				num_batched = 0;
+			}
+		}
+
+	public:
+		streaming_hasher() {
+			blake3_hasher_init(&hasher);
+		}
+
+		void write_bytes(const void* const bytes, const std::size_t n) {
+			if (num_batched + n > batch_size_v) {
+				flush();
+
+				if (n > batch_size_v) {
+					blake3_hasher_update(&hasher, bytes, n);
+					return;
+				}
+			}
+
+			std::memcpy(batch.data() + num_batched, bytes, n);
+			num_batched += n;
+		}
+
+		/* Lets augs::write_bytes stream whole serializable objects into the hasher. */
+
+		void write(const std::byte* const bytes, const std::size_t n) {
+			write_bytes(bytes, n);
+		}
+
+		template <class T>
+		void write(const T& object) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed directly.");
+			write_bytes(std::addressof(object), sizeof(T));
+		}
+
+		template <class T>
+		T finalize() {
+			static_assert(std::is_trivially_copyable_v<T>);
+
+			flush();
+
+			T result;
+			blake3_hasher_finalize(&hasher, reinterpret_cast<uint8_t*>(std::addressof(result)), sizeof(T));
+			return result;
+		}
+	};
+}
@@ -0,0 +1,254 @@
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+#include "augs/misc/trace_recorder.h"
+#include "augs/misc/date_time.h"
+#include "augs/filesystem/file.h"
+#include "augs/string/typesafe_sprintf.h"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#undef min
+#undef max
+#else
+#include <unistd.h>
+#endif
+
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+
+namespace augs {
+	thread_local trace_recorder* current_trace_recorder = nullptr;
+
+	static unsigned get_process_id() {
+#if PLATFORM_WINDOWS
+		return static_cast<unsigned>(GetCurrentProcessId());
+#else
+		return static_cast<unsigned>(getpid());
+#endif
+	}
+
+	static uint64_t now_ns() {
+		using namespace std::chrono;
+		return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	static uint64_t next_recorder_id() {
+		static std::atomic<uint64_t> next = 1;
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static auto& get_names_lock() {
+		static std::mutex lk;
+		return lk;
+	}
+
+	static auto& get_names() {
+		static std::vector<std::string> names = { "" };
+		return names;
+	}
+
+	trace_recorder::current_scope::current_scope(trace_recorder* const recorder) : previous(current_trace_recorder) {
+		current_trace_recorder = recorder;
+	}
+
+	trace_recorder::current_scope::~current_scope() {
+		current_trace_recorder = previous;
+	}
+
+	void record_trace_event(trace_recorder& recorder, uint32_t& name_id, const std::string& name, const double duration_secs) {
+		if (!recorder.is_enabled()) {
+			return;
+		}
+
+		if (name_id == 0) {
+			name_id = trace_recorder::intern(name);
+		}
+
+		recorder.record(name_id, duration_secs);
+	}
+
+	trace_recorder::trace_recorder() : id(next_recorder_id()) {}
+
+	void trace_recorder::set_enabled(const bool flag) {
+		enabled.store(flag, std::memory_order_relaxed);
+	}
+
+	uint32_t trace_recorder::intern(const std::string& name) {
+		std::scoped_lock lock(get_names_lock());
+
+		auto& names = get_names();
+		const auto found = std::find(names.begin() + 1, names.end(), name);
+
+		if (found != names.end()) {
+			return static_cast<uint32_t>(found - names.begin());
+		}
+
+		names.push_back(name);
+		return static_cast<uint32_t>(names.size() - 1);
+	}
+
+	trace_recorder::thread_ring& trace_recorder::get_ring_of_this_thread() {
+		/* A thread usually steps a single server, so remember the ring it has last written to. */
+
+		thread_local uint64_t cached_recorder_id = 0;
+		thread_local thread_ring* cached_ring = nullptr;
+
+		if (cached_recorder_id != id) {
+			std::scoped_lock lock(lk);
+
+			const auto this_thread = std::this_thread::get_id();
+
+			const auto found = std::find_if(
+				rings.begin(),
+				rings.end(),
+				[&](const auto& r) { return r->thread == this_thread; }
+			);
+
+			if (found != rings.end()) {
+				cached_ring = found->get();
+			}
+			else {
+				rings.emplace_back(std::make_unique<thread_ring>());
+				cached_ring = rings.back().get();
+				cached_ring->thread = this_thread;
+				cached_ring->thread_index = static_cast<uint32_t>(rings.size() - 1);
+			}
+
+			cached_recorder_id = id;
+		}
+
+		return *cached_ring;
+	}
+
+	void trace_recorder::record(const uint32_t name_id, const double duration_secs) {
+		const auto end_ns = now_ns();
+		const auto duration_ns = std::min(end_ns, static_cast<uint64_t>(duration_secs * 1e9));
+
+		auto& ring = get_ring_of_this_thread();
+
+		/* Only this thread ever writes to its ring. */
+		const auto n = ring.num_written.load(std::memory_order_relaxed);
+		auto& e = ring.events[n % events_per_thread];
+
+		e.begin_ns.store(end_ns - duration_ns, std::memory_order_relaxed);
+		e.duration_ns.store(duration_ns, std::memory_order_relaxed);
+		e.name_id.store(name_id, std::memory_order_relaxed);
+
+		ring.num_written.store(n + 1, std::memory_order_release);
+	}
+
+	trace_recorder::snapshot trace_recorder::take_snapshot() const {
+		snapshot result;
+		auto& all = result.events;
+
+		auto oldest_kept = [](const uint64_t num_written) {
+			return num_written > events_per_thread ? num_written - events_per_thread : 0;
+		};
+
+		{
+			std::scoped_lock lock(get_names_lock());
+			result.names = get_names();
+		}
+
+		std::scoped_lock lock(lk);
+
+		for (const auto& r : rings) {
+			const auto last = r->num_written.load(std::memory_order_acquire);
+			const auto first = oldest_kept(last);
+			const auto copied_from = all.size();
+
+			for (auto i = first; i < last; ++i) {
+				const auto& e = r->events[i % events_per_thread];
+
+				all.push_back({
+					r->thread_index,
+					e.name_id.load(std::memory_order_relaxed),
+					e.begin_ns.load(std::memory_order_relaxed),
+					e.duration_ns.load(std::memory_order_relaxed)
+				});
+			}
+
+			/* The thread might have overwritten the oldest events while they were being copied. */
+
+			const auto overwritten = oldest_kept(r->num_written.load(std::memory_order_acquire));
+
+			if (overwritten > first) {
+				const auto num_torn = std::min(overwritten - first, last - first);
+				all.erase(all.begin() + copied_from, all.begin() + copied_from + num_torn);
+			}
+		}
+
+		return result;
+	}
+
+	std::size_t trace_recorder::write_chrome_trace(const snapshot& in, const path_type& to) {
+		const auto& all = in.events;
+		const auto& known_names = in.names;
+
+		uint64_t earliest_ns = std::numeric_limits<uint64_t>::max();
+
+		for (const auto& e : all) {
+			earliest_ns = std::min(earliest_ns, e.begin_ns);
+		}
+
+		rapidjson::StringBuffer s;
+		rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+		writer.StartObject();
+		writer.Key("displayTimeUnit");
+		writer.String("ms");
+
+		writer.Key("traceEvents");
+		writer.StartArray();
+
+		std::size_t num_written = 0;
+
+		for (const auto& e : all) {
+			if (e.name_id == 0 || e.name_id >= known_names.size()) {
+				continue;
+			}
+
+			writer.StartObject();
+
+			writer.Key("name");
+			writer.String(known_names[e.name_id].c_str());
+
+			writer.Key("ph");
+			writer.String("X");
+
+			writer.Key("pid");
+			writer.Uint(get_process_id());
+
+			writer.Key("tid");
+			writer.Uint(e.thread_index);
+
+			writer.Key("ts");
+			writer.Double((e.begin_ns - earliest_ns) / 1000.0);
+
+			writer.Key("dur");
+			writer.Double(e.duration_ns / 1000.0);
+
+			writer.EndObject();
+
+			++num_written;
+		}
+
+		writer.EndArray();
+		writer.EndObject();
+
+		augs::save_as_text(to, s.GetString());
+
+		return num_written;
+	}
+
+	std::string trace_recorder::make_dump_file_name(const std::string& instance_label) {
+		return typesafe_sprintf(
+			"trace_%x_%x_%x.json",
+			instance_label,
+			get_process_id(),
+			date_time().get_readable_for_file()
+		);
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "augs/filesystem/path.h"
+#include "augs/misc/trace_recorder_declaration.h"
+
+namespace augs {
+	/*
+		Records every measure_scope as a begin timestamp and a duration,
+		so that a single long step can be attributed after the fact.
+
+		Every server instance and the client own their recorder and make it current for the thread they step on,
+		so instances sharing a process neither enable recording for each other nor mix their events.
+		Measurements on threads without a current recorder are not recorded.
+
+		Every thread writes to its own ring of the most recent events, without any locks.
+		The rings are copied quickly on the recording thread,
+		and then written as a Chrome trace JSON file, which opens in Perfetto, on any other thread.
+
+		Recording is off by default, so that a stopped time_measurements only pays for a thread_local load
+		and a call if some recorder is current.
+	*/
+
+	class trace_recorder {
+	public:
+		static constexpr std::size_t events_per_thread = 1 << 14;
+
+		struct snapshot {
+			struct copied_event {
+				uint32_t thread_index = 0;
+				uint32_t name_id = 0;
+				uint64_t begin_ns = 0;
+				uint64_t duration_ns = 0;
+			};
+
+			std::vector<copied_event> events;
+			std::vector<std::string> names;
+		};
+
+		/* Makes the recorder current for this thread until destruction. */
+
+		class current_scope {
+			trace_recorder* const previous;
+
+		public:
+			current_scope(trace_recorder*);
+			~current_scope();
+
+			current_scope(const current_scope&) = delete;
+			current_scope& operator=(const current_scope&) = delete;
+		};
+
+	private:
+		struct event {
+			std::atomic<uint64_t> begin_ns = 0;
+			std::atomic<uint64_t> duration_ns = 0;
+			std::atomic<uint32_t> name_id = 0;
+		};
+
+		struct thread_ring {
+			std::thread::id thread;
+			uint32_t thread_index = 0;
+			std::atomic<uint64_t> num_written = 0;
+			std::unique_ptr<event[]> events = std::make_unique<event[]>(events_per_thread);
+		};
+
+		/* Unique for the whole process run, unlike the address of a recorder. */
+		const uint64_t id;
+
+		std::atomic<bool> enabled = false;
+
+		mutable std::mutex lk;
+		std::vector<std::unique_ptr<thread_ring>> rings;
+
+		thread_ring& get_ring_of_this_thread();
+
+	public:
+		trace_recorder();
+
+		trace_recorder(const trace_recorder&) = delete;
+		trace_recorder& operator=(const trace_recorder&) = delete;
+
+		void set_enabled(bool);
+
+		bool is_enabled() const {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		/* Returns a non-zero identifier of the name, the same for equal names in all recorders. */
+		static uint32_t intern(const std::string& name);
+
+		/* Records an event that has just ended. */
+		void record(uint32_t name_id, double duration_secs);
+
+		snapshot take_snapshot() const;
+
+		/* Returns the number of events written. Throws if the file could not be written. */
+		static std::size_t write_chrome_trace(const snapshot&, const path_type& to);
+
+		/*
+			Dumps of several processes or instances can happen within the same second,
+			so the name has the process id and the label of the instance next to the date.
+		*/
+
+		static std::string make_dump_file_name(const std::string& instance_label);
+	};
+}
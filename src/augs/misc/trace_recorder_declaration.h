@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+namespace augs {
+	class trace_recorder;
+
+	/* Set for the duration of a trace_recorder::current_scope. */
+	extern thread_local trace_recorder* current_trace_recorder;
+
+	/*
+		Records a measurement that has just stopped, if the recorder is enabled.
+		Interns the name on first use and caches its identifier in name_id.
+	*/
+
+	void record_trace_event(trace_recorder&, uint32_t& name_id, const std::string& name, double duration_secs);
+}
@@ -0,0 +1,101 @@
+#include <array>
+#include <cstring>
+#include <algorithm>
+
+#include "augs/network/netcode_packet_batch.h"
+#include "augs/templates/container_templates.h"
+
+#if PLATFORM_LINUX
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+/* Same conversion as netcode_socket_send_packet does internally. */
+
+static socklen_t to_sockaddr(const netcode_address_t& from, sockaddr_storage& to) {
+	std::memset(&to, 0, sizeof(to));
+
+	if (from.type == NETCODE_ADDRESS_IPV6) {
+		auto& s = reinterpret_cast<sockaddr_in6&>(to);
+		s.sin6_family = AF_INET6;
+		s.sin6_port = htons(from.port);
+
+		for (int i = 0; i < 8; ++i) {
+			const auto part = htons(from.data.ipv6[i]);
+			std::memcpy(s.sin6_addr.s6_addr + i * 2, &part, sizeof(part));
+		}
+
+		return sizeof(sockaddr_in6);
+	}
+
+	auto& s = reinterpret_cast<sockaddr_in&>(to);
+	s.sin_family = AF_INET;
+	s.sin_port = htons(from.port);
+	s.sin_addr.s_addr =
+		  uint32_t(from.data.ipv4[0])
+		| uint32_t(from.data.ipv4[1]) << 8
+		| uint32_t(from.data.ipv4[2]) << 16
+		| uint32_t(from.data.ipv4[3]) << 24
+	;
+
+	return sizeof(sockaddr_in);
+}
+#endif
+
+std::size_t netcode_packet_batch::send(netcode_socket_t socket) {
+	std::size_t num_calls = 0;
+
+#if PLATFORM_LINUX
+	constexpr std::size_t max_per_call = 64;
+
+	std::array<mmsghdr, max_per_call> messages;
+	std::array<iovec, max_per_call> buffers;
+	std::array<sockaddr_storage, max_per_call> addresses;
+
+	/* Like netcode_socket_send_packet, only send to addresses of the socket's own family. */
+
+	erase_if(entries, [&](const entry& e) {
+		return e.to.type != socket.address.type;
+	});
+
+	std::size_t first = 0;
+
+	while (first < entries.size()) {
+		const auto n = std::min(max_per_call, entries.size() - first);
+
+		for (std::size_t i = 0; i < n; ++i) {
+			const auto& e = entries[first + i];
+
+			buffers[i].iov_base = const_cast<std::byte*>(e.bytes);
+			buffers[i].iov_len = static_cast<std::size_t>(e.num_bytes);
+
+			auto& m = messages[i];
+			std::memset(&m, 0, sizeof(m));
+
+			m.msg_hdr.msg_name = &addresses[i];
+			m.msg_hdr.msg_namelen = to_sockaddr(e.to, addresses[i]);
+			m.msg_hdr.msg_iov = &buffers[i];
+			m.msg_hdr.msg_iovlen = 1;
+		}
+
+		const auto num_sent = ::sendmmsg(static_cast<int>(socket.handle), messages.data(), static_cast<unsigned>(n), 0);
+		++num_calls;
+
+		if (num_sent <= 0) {
+			/* Just like a failed sendto, drop the rest of the datagrams. */
+			break;
+		}
+
+		first += static_cast<std::size_t>(num_sent);
+	}
+#else
+	for (auto& e : entries) {
+		netcode_socket_send_packet(&socket, &e.to, const_cast<std::byte*>(e.bytes), e.num_bytes);
+		++num_calls;
+	}
+#endif
+
+	entries.clear();
+	return num_calls;
+}
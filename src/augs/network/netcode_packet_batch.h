@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "augs/network/netcode_sockets.h"
+
+/*
+	Datagrams gathered over a tick and sent all at once.
+
+	On Linux the whole batch goes out in a handful of sendmmsg calls
+	instead of a separate sendto for every datagram.
+	Elsewhere it falls back to netcode_socket_send_packet in a loop.
+
+	Only pointers to the bytes are stored, so they must stay alive until send.
+*/
+
+struct netcode_packet_batch {
+	struct entry {
+		netcode_address_t to;
+		const std::byte* bytes = nullptr;
+		int num_bytes = 0;
+	};
+
+	std::vector<entry> entries;
+
+	void push(const netcode_address_t& to, const std::byte* bytes, const int num_bytes) {
+		entries.push_back({ to, bytes, num_bytes });
+	}
+
+	bool empty() const {
+		return entries.empty();
+	}
+
+	std::size_t size() const {
+		return entries.size();
+	}
+
+	void clear() {
+		entries.clear();
+	}
+
+	/* Clears the batch. Returns the number of system calls made. */
+	std::size_t send(netcode_socket_t socket);
+};
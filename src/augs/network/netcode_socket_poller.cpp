@@ -0,0 +1,72 @@
+#include <cmath>
+#include <algorithm>
+#include <array>
+
+#include "augs/network/netcode_socket_poller.h"
+#include "augs/misc/date_time.h"
+#include "augs/log.h"
+
+#if PLATFORM_LINUX
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#endif
+
+#if PLATFORM_LINUX
+netcode_socket_poller::netcode_socket_poller() : epoll_fd(epoll_create1(EPOLL_CLOEXEC)) {
+	if (epoll_fd == -1) {
+		LOG("epoll_create1 failed: %x. Falling back to sleeping.", std::strerror(errno));
+	}
+}
+
+netcode_socket_poller::~netcode_socket_poller() {
+	if (epoll_fd != -1) {
+		::close(epoll_fd);
+	}
+}
+
+bool netcode_socket_poller::add(const netcode_socket_t& socket) {
+	if (epoll_fd == -1) {
+		return false;
+	}
+
+	epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.u64 = static_cast<uint64_t>(socket.handle);
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, static_cast<int>(socket.handle), &ev) == -1) {
+		LOG("epoll_ctl failed: %x", std::strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+bool netcode_socket_poller::wait(const double max_secs) {
+	if (epoll_fd == -1) {
+		augs::sleep(max_secs);
+		return false;
+	}
+
+	/* Level-triggered, so it is enough to know that anything at all is readable. */
+	std::array<epoll_event, 16> events;
+
+	const auto timeout_ms = static_cast<int>(std::ceil(std::max(0.0, max_secs) * 1000));
+	const auto num_ready = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), timeout_ms);
+
+	return num_ready > 0;
+}
+#else
+netcode_socket_poller::netcode_socket_poller() = default;
+netcode_socket_poller::~netcode_socket_poller() = default;
+
+bool netcode_socket_poller::add(const netcode_socket_t&) {
+	return false;
+}
+
+bool netcode_socket_poller::wait(const double max_secs) {
+	augs::sleep(max_secs);
+	return false;
+}
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include "augs/network/netcode_sockets.h"
+
+/*
+	Waits until any of the added sockets has a datagram to read, or until a timeout.
+
+	On Linux this is a single epoll_wait on all sockets, so a loop built on it
+	wakes up the moment a packet arrives instead of on its next sleep.
+	Elsewhere it falls back to sleeping through the whole timeout.
+
+	A signal interrupts the wait on Linux.
+*/
+
+class netcode_socket_poller {
+#if PLATFORM_LINUX
+	int epoll_fd = -1;
+#endif
+
+public:
+	netcode_socket_poller();
+	~netcode_socket_poller();
+
+	netcode_socket_poller(const netcode_socket_poller&) = delete;
+	netcode_socket_poller& operator=(const netcode_socket_poller&) = delete;
+
+	/* Returns false if the socket could not be watched. */
+	bool add(const netcode_socket_t& socket);
+
+	/* Returns true if some socket has become readable before the timeout. */
+	bool wait(double max_secs);
+};
@@ -16,6 +16,22 @@
 */
 constexpr port_type DEFAULT_GAME_PORT_V = 8412;
 
+/*
+	Bump whenever the serialization of any network message changes.
+	A client tells the server its version in requested_client_settings
+	and the server kicks it with an explanation if it differs.
+
+	Demos store the server messages as they were sent,
+	so a demo can only be replayed by a build that speaks the same version (see demo_file_meta).
+
+	2 - file_download_payload carries the compressed size of the file.
+	3 - The shared part of server_step_entropy is length-prefixed and byte-aligned.
+	4 - server_step_entropy_meta carries the wide_state_hash bit, and state hashes use blake3 instead of crc32.
+	5 - Split components in arena snapshots are delta-encoded per entity against the clean round state.
+*/
+
+constexpr uint32_t game_protocol_version_v = 5;
+
 constexpr port_type DEFAULT_MASTERSERVER_PORT_V = 8430;
 constexpr const char* demo_address_preffix_v = "demo://";
 
@@ -139,6 +155,16 @@ struct server_network_info {
 	float sent_kbps = 0.f;
 	float received_kbps = 0.f;
 
+	/* Direct arena file downloads, averaged over the last second. */
+	uint32_t num_direct_downloaders = 0;
+	float file_chunks_per_second_per_downloader = 0.f;
+	float file_transfer_cpu_ms_per_downloader = 0.f;
+
+	/* Arena files held in memory for downloads, shared by all instances in this process. */
+	uint32_t num_stored_arena_files = 0;
+	uint64_t stored_arena_files_uncompressed_bytes = 0;
+	uint64_t stored_arena_files_compressed_bytes = 0;
+
 	bool are_set() const {
 		return sent_kbps > 0.f && received_kbps > 0;
 	}
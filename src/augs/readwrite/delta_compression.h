@@ -84,6 +84,38 @@ namespace augs {
 			return changed_bytes.size() > 0;
 		}
 
+		std::size_t get_encoded_size() const {
+			return
+				2 * sizeof(offset_type)
+				+ changed_bytes.size() * sizeof(delta_unit)
+				+ changed_offsets.size() * sizeof(offset_type)
+			;
+		}
+
+		/*
+			Checks a delta that came from an untrusted source
+			so that decode_into never writes past the decoded object.
+		*/
+
+		bool fits_in_object() const {
+			if (changed_offsets.size() % 2 != 0) {
+				return false;
+			}
+
+			std::size_t total_offset = 0;
+			std::size_t total_copied = 0;
+
+			for (std::size_t i = 0; i < changed_offsets.size(); i += 2) {
+				const auto skipped = static_cast<std::size_t>(changed_offsets[i]);
+				const auto copied = static_cast<std::size_t>(changed_offsets[i + 1]);
+
+				total_offset += skipped + copied;
+				total_copied += copied;
+			}
+
+			return total_offset <= length_bytes && total_copied == changed_bytes.size();
+		}
+
 		template <class A>
 		bool write(
 			A& out,
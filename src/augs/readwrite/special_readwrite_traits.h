@@ -27,9 +27,39 @@ namespace augs {
 	> : std::true_type 
 	{};
 
+	/* For archives that encode pool columns with the knowledge of the pool they belong to. */
+
+	template <class ArgsList, class = void>
+	struct has_special_column_read : std::false_type 
+	{};
+
+	template <class Archive, class Pool, class Column>
+	struct has_special_column_read <
+		type_list<Archive, Pool, Column>,
+		decltype(std::declval<Archive&>().special_read_column(std::declval<const Pool&>(), std::declval<Column&>()), void())
+	> : std::true_type 
+	{};
+
+	template <class ArgsList, class = void>
+	struct has_special_column_write : std::false_type 
+	{};
+
+	template <class Archive, class Pool, class Column>
+	struct has_special_column_write <
+		type_list<Archive, Pool, Column>,
+		decltype(std::declval<Archive&>().special_write_column(std::declval<const Pool&>(), std::declval<const Column&>()), void())
+	> : std::true_type 
+	{};
+
 	template <class... Args>
 	constexpr bool has_special_read_v = has_special_read<type_list<Args...>>::value;
 
+	template <class... Args>
+	constexpr bool has_special_column_read_v = has_special_column_read<type_list<Args...>>::value;
+
+	template <class... Args>
+	constexpr bool has_special_column_write_v = has_special_column_write<type_list<Args...>>::value;
+
 	template <class... Args>
 	constexpr bool has_special_write_v = has_special_write<type_list<Args...>>::value;
 
@@ -0,0 +1,137 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace augs {
+	/*
+		Move-only replacement for std::function<void()>
+		that keeps closures of up to buffer_size bytes inside the object itself.
+
+		Larger closures still work, they're just allocated on the heap.
+	*/
+
+	template <std::size_t buffer_size>
+	class small_task {
+		using invoker_type = void(*)(void*);
+
+		/* Moves the callable from "from" into "to" and destroys the source. Only destroys if "to" is null. */
+		using manager_type = void(*)(void* to, void* from);
+
+		alignas(std::max_align_t) std::byte buffer[buffer_size];
+
+		invoker_type invoker = nullptr;
+		manager_type manager = nullptr;
+
+		template <class T>
+		static T& get_inline(void* const b) {
+			return *std::launder(reinterpret_cast<T*>(b));
+		}
+
+		template <class T>
+		static T*& get_heap(void* const b) {
+			return *std::launder(reinterpret_cast<T**>(b));
+		}
+
+		void move_from(small_task& b) noexcept {
+			if (b.manager != nullptr) {
+				b.manager(buffer, b.buffer);
+			}
+
+			invoker = b.invoker;
+			manager = b.manager;
+
+			b.invoker = nullptr;
+			b.manager = nullptr;
+		}
+
+	public:
+		template <class T>
+		static constexpr bool fits_inline_v =
+			sizeof(T) <= buffer_size
+			&& alignof(T) <= alignof(std::max_align_t)
+			&& std::is_nothrow_move_constructible_v<T>
+		;
+
+		small_task() = default;
+
+		template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_task>>>
+		small_task(F&& f) {
+			using T = std::decay_t<F>;
+
+			if constexpr(fits_inline_v<T>) {
+				new (buffer) T(std::forward<F>(f));
+
+				invoker = [](void* const b) {
+					get_inline<T>(b)();
+				};
+
+				manager = [](void* const to, void* const from) {
+					auto& source = get_inline<T>(from);
+
+					if (to != nullptr) {
+						new (to) T(std::move(source));
+					}
+
+					source.~T();
+				};
+			}
+			else {
+				new (buffer) T*(new T(std::forward<F>(f)));
+
+				invoker = [](void* const b) {
+					(*get_heap<T>(b))();
+				};
+
+				manager = [](void* const to, void* const from) {
+					auto& source = get_heap<T>(from);
+
+					if (to != nullptr) {
+						new (to) T*(source);
+					}
+					else {
+						delete source;
+					}
+				};
+			}
+		}
+
+		small_task(small_task&& b) noexcept {
+			move_from(b);
+		}
+
+		small_task& operator=(small_task&& b) noexcept {
+			if (this != &b) {
+				reset();
+				move_from(b);
+			}
+
+			return *this;
+		}
+
+		small_task(const small_task&) = delete;
+		small_task& operator=(const small_task&) = delete;
+
+		~small_task() {
+			reset();
+		}
+
+		void reset() {
+			if (manager != nullptr) {
+				manager(nullptr, buffer);
+			}
+
+			invoker = nullptr;
+			manager = nullptr;
+		}
+
+		explicit operator bool() const {
+			return invoker != nullptr;
+		}
+
+		void operator()() {
+			invoker(buffer);
+		}
+	};
+}
@@ -0,0 +1,206 @@
+#if BUILD_UNIT_TESTS
+#include <atomic>
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/templates/thread_pool.h"
+
+TEST_CASE("ThreadPool NestedSubmit") {
+	for (const std::size_t num_workers : { 0u, 1u, 3u }) {
+		augs::thread_pool pool(num_workers);
+
+		std::atomic<int> num_outer = 0;
+		std::atomic<int> num_nested = 0;
+
+		for (int round = 0; round < 20; ++round) {
+			for (int i = 0; i < 64; ++i) {
+				pool.enqueue([&]() {
+					/* Would wait forever for its own batch if the nested work wasn't run inline. */
+
+					for (int j = 0; j < 4; ++j) {
+						pool.enqueue([&]() { ++num_nested; });
+					}
+
+					pool.submit();
+					pool.help_until_no_tasks();
+					pool.wait_for_all_tasks_to_complete();
+
+					++num_outer;
+				});
+			}
+
+			pool.submit();
+			pool.help_until_no_tasks();
+			pool.wait_for_all_tasks_to_complete();
+		}
+
+		REQUIRE(num_outer.load() == 20 * 64);
+		REQUIRE(num_nested.load() == 20 * 64 * 4);
+	}
+}
+
+TEST_CASE("ThreadPool SubmitToAnotherPool") {
+	augs::thread_pool outer(2);
+	augs::thread_pool inner(2);
+
+	std::atomic<int> num_inner = 0;
+
+	for (int i = 0; i < 2; ++i) {
+		outer.enqueue([&]() {
+			/* A different pool keeps running its batch on its own workers. */
+
+			for (int j = 0; j < 16; ++j) {
+				inner.enqueue([&]() { ++num_inner; });
+			}
+
+			inner.submit();
+			inner.help_until_no_tasks();
+			inner.wait_for_all_tasks_to_complete();
+		});
+
+		outer.submit();
+		outer.help_until_no_tasks();
+		outer.wait_for_all_tasks_to_complete();
+	}
+
+	REQUIRE(num_inner.load() == 2 * 16);
+}
+#endif
+
+#if BUILD_TEST_SCENES && (BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS)
+#include "test_scenes/test_scene_fixture.h"
+#include "game/stateless_systems/visibility_system.h"
+#include "game/cosmos/entity_handle.h"
+#include "game/cosmos/for_each_entity.h"
+#include "game/organization/all_component_includes.h"
+#include "game/enums/filters.h"
+#include "game/debug_drawing_settings.h"
+
+/* The lights of the test scene, repeated to as many as a crowded screen would submit in a single frame. */
+
+static auto make_light_visibility_requests(const cosmos& cosm, const std::size_t num_lights) {
+	std::vector<visibility_request> scene_requests;
+
+	cosm.for_each_having<components::light>(
+		[&](const auto light_entity) {
+			const auto& light = light_entity.template get<components::light>();
+
+			visibility_request request;
+			request.eye_transform = light_entity.get_logic_transform();
+			request.queried_rect = light.calc_reach_trimmed();
+			request.filter = predefined_queries::line_of_sight();
+			request.subject = light_entity;
+			request.color = light.color;
+
+			scene_requests.push_back(request);
+		}
+	);
+
+	std::vector<visibility_request> requests;
+
+	if (scene_requests.empty()) {
+		return requests;
+	}
+
+	for (std::size_t i = 0; i < num_lights; ++i) {
+		requests.push_back(scene_requests[i % scene_requests.size()]);
+	}
+
+	return requests;
+}
+
+/* One small job per light. */
+
+static void calc_light_visibilities(
+	augs::thread_pool& pool,
+	const cosmos& cosm,
+	const std::vector<visibility_request>& requests,
+	std::vector<visibility_response>& responses
+) {
+	for (std::size_t i = 0; i < requests.size(); ++i) {
+		auto light_job = [&cosm, &request = requests[i], &response = responses[i]]() {
+			visibility_system(DEBUG_FRAME_LINES).calc_visibility(cosm, request, response);
+		};
+
+		pool.enqueue(light_job);
+	}
+
+	pool.submit();
+	pool.help_until_no_tasks();
+	pool.wait_for_all_tasks_to_complete();
+}
+#endif
+
+#if BUILD_UNIT_TESTS && BUILD_TEST_SCENES
+TEST_CASE("ThreadPool LightVisibilityJobs") {
+	const auto scene = make_test_scene_cosmos();
+	const auto& cosm = *scene;
+
+	const auto requests = make_light_visibility_requests(cosm, 100);
+
+	REQUIRE(!requests.empty());
+
+	std::vector<visibility_response> serial_responses(requests.size());
+	std::vector<visibility_response> pooled_responses(requests.size());
+
+	for (std::size_t i = 0; i < requests.size(); ++i) {
+		visibility_system(DEBUG_FRAME_LINES).calc_visibility(cosm, requests[i], serial_responses[i]);
+	}
+
+	auto pool = augs::thread_pool(3);
+	calc_light_visibilities(pool, cosm, requests, pooled_responses);
+
+	for (std::size_t i = 0; i < requests.size(); ++i) {
+		REQUIRE(serial_responses[i].get_num_triangles() == pooled_responses[i].get_num_triangles());
+		REQUIRE(serial_responses[i].edges == pooled_responses[i].edges);
+	}
+}
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_TEST_SCENES
+#include <thread>
+#include "augs/internal_benchmarks.h"
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+
+INTERNAL_BENCHMARK("ThreadPool LightVisibilityJobs") {
+	const auto scene = make_test_scene_cosmos();
+	const auto& cosm = *scene;
+
+	const auto requests = make_light_visibility_requests(cosm, 500);
+	const int num_frames = 60;
+
+	std::vector<visibility_response> serial_responses(requests.size());
+	std::vector<visibility_response> pooled_responses(requests.size());
+
+	const auto num_workers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	auto pool = augs::thread_pool(num_workers);
+
+	double serial_ms = 0.0;
+	double pooled_ms = 0.0;
+
+	for (int f = 0; f < num_frames; ++f) {
+		{
+			augs::timer t;
+
+			for (std::size_t i = 0; i < requests.size(); ++i) {
+				visibility_system(DEBUG_FRAME_LINES).calc_visibility(cosm, requests[i], serial_responses[i]);
+			}
+
+			serial_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+			calc_light_visibilities(pool, cosm, requests, pooled_responses);
+			pooled_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG(
+		"%x light visibility jobs per frame. Serial: %x ms, pool of %x workers: %x ms (avg. per frame).",
+		requests.size(),
+		serial_ms / num_frames,
+		num_workers,
+		pooled_ms / num_frames
+	);
+}
+#endif
@@ -1,11 +1,15 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
 
+#include "augs/templates/small_task.h"
+
 namespace augs {
 #if WEB_SINGLETHREAD
 	class thread_pool {
@@ -30,24 +34,68 @@ namespace augs {
 		void wait_for_all_tasks_to_complete() {}
 	};
 #else
+	/*
+		Every worker owns a queue that is a contiguous range of the submitted batch.
+		A worker claims tasks from its own range and, once it runs dry, steals from the ranges of others.
+
+		Tasks are only ever published in whole batches by submit(),
+		so claiming a task, whether own or stolen, is a single atomic increment.
+		Locks are taken once per batch, never per task.
+
+		Tasks are stored in small_task objects inside vectors that keep their capacity,
+		so enqueueing a typical closure does not allocate once the pool warms up.
+
+		A task may itself use the pool it runs on, e.g. a solver pass that splits its own work.
+		The running batch can't be replaced until it completes, which would never happen while one of its tasks waits,
+		so such nested work runs inline: enqueue calls the task right away, and the rest of the calls do nothing.
+	*/
+
 	class thread_pool {
+		static constexpr std::size_t task_buffer_size_v = 128;
+		using task_type = small_task<task_buffer_size_v>;
+
+		struct alignas(64) task_queue {
+			std::atomic<std::size_t> next = 0;
+			std::size_t end = 0;
+		};
+
 		std::vector<std::thread> workers;
-		std::vector<std::function<void()>> tasks;
-		std::vector<std::function<void()>> cold_tasks;
+		std::vector<task_type> tasks;
+		std::vector<task_type> cold_tasks;
+
+		/* The last queue belongs to the threads that help with help_until_no_tasks. */
+		std::vector<task_queue> queues;
+
+		std::atomic<std::size_t> tasks_remaining = 0;
 
-		int tasks_completed = 0;
-		int tasks_posted = 0;
+		std::shared_mutex batch_mutex;
 
-		std::mutex queue_mutex;
-		std::condition_variable cv;
+		std::mutex wake_mutex;
+		std::condition_variable wake_variable;
+		uint64_t batch_generation = 0;
 
 		std::condition_variable completion_variable;
 		std::mutex completion_mutex;
 
 		std::atomic<bool> shall_quit = false;
 
-		auto lock_queue() {
-			return std::unique_lock<std::mutex>(queue_mutex);
+		/* The pool whose task this thread is running, if any. */
+		static inline thread_local const thread_pool* running_task_of = nullptr;
+
+		bool called_from_own_task() const {
+			return running_task_of == this;
+		}
+
+		auto lock_batch() {
+			return std::unique_lock<std::shared_mutex>(batch_mutex);
+		}
+
+		auto lock_batch_shared() {
+			return std::shared_lock<std::shared_mutex>(batch_mutex);
+		}
+
+		auto lock_wake() {
+			return std::unique_lock<std::mutex>(wake_mutex);
 		}
 
 		auto lock_completion() {
@@ -55,39 +103,76 @@ namespace augs {
 		}
 
 		void register_completion() {
-			bool completed = false;
-
-			{
-				auto lock = lock_completion();
-				++tasks_completed;
-
-				completed = tasks_completed == tasks_posted;
-			}
+			if (tasks_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				{
+					/* Prevents a lost wakeup between the waiter's check and its wait. */
+					auto lock = lock_completion();
+				}
 
-			if (completed) {
 				completion_variable.notify_all();
 			}
 		}
 
-		auto make_continuous_worker() {
-			return [this] {
-				for (;;) {
-					std::function<void()> task;
+		bool try_run_one(const std::size_t own_queue) {
+			const auto n = queues.size();
+
+			for (std::size_t i = 0; i < n; ++i) {
+				auto& queue = queues[(own_queue + i) % n];
+
+				if (queue.next.load(std::memory_order_relaxed) >= queue.end) {
+					continue;
+				}
+
+				const auto index = queue.next.fetch_add(1, std::memory_order_relaxed);
+
+				if (index < queue.end) {
+					auto& task = tasks[index];
 
 					{
-						auto lock = lock_queue();
-						cv.wait(lock, [this]{ return shall_quit || !tasks.empty(); });
+						const auto previous = running_task_of;
+						running_task_of = this;
 
-						if (shall_quit.load() && tasks.empty()) {
-							return;
-						}
+						task();
 
-						task = std::move(tasks.back());
-						tasks.pop_back();
+						running_task_of = previous;
 					}
 
-					task();
+					task.reset();
+
 					register_completion();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void run_until_no_tasks(const std::size_t own_queue) {
+			auto lock = lock_batch_shared();
+
+			while (try_run_one(own_queue)) {}
+		}
+
+		auto make_continuous_worker(const std::size_t own_queue, const uint64_t first_generation) {
+			return [this, own_queue, first_generation] {
+				auto seen_generation = first_generation;
+
+				for (;;) {
+					bool quitting = false;
+
+					{
+						auto lock = lock_wake();
+						wake_variable.wait(lock, [&]{ return shall_quit.load() || batch_generation != seen_generation; });
+
+						seen_generation = batch_generation;
+						quitting = shall_quit.load();
+					}
+
+					run_until_no_tasks(own_queue);
+
+					if (quitting) {
+						return;
+					}
 				}
 			};
 		}
@@ -103,12 +188,20 @@ namespace augs {
 				return;
 			}
 
-			shall_quit.store(true);
-			cv.notify_all();
+			{
+				auto lock = lock_wake();
+				shall_quit.store(true);
+			}
+
+			wake_variable.notify_all();
 			join_all();
 			workers.clear();
 		}
 
+		std::size_t get_helper_queue() const {
+			return queues.size() - 1;
+		}
+
 	public:
 		thread_pool(const std::size_t num_workers) {
 			resize(num_workers);
@@ -122,32 +215,67 @@ namespace augs {
 			quit_all_workers();
 			shall_quit.store(false);
 
+			{
+				auto lock = lock_batch();
+				queues = std::vector<task_queue>(num_workers + 1);
+			}
+
+			const auto generation = [&]() {
+				auto lock = lock_wake();
+				return batch_generation;
+			}();
+
 			for (std::size_t i = 0; i < num_workers; ++i) {
-				workers.emplace_back(make_continuous_worker());
+				workers.emplace_back(make_continuous_worker(i, generation));
 			}
 		}
 
 		template <class F>
 		void enqueue(F&& f) {
+			if (called_from_own_task()) {
+				f();
+				return;
+			}
+
 			cold_tasks.emplace_back(std::move(f));
 		}
 
 		void submit() {
+			if (called_from_own_task()) {
+				return;
+			}
+
+			/* The previous batch must be finished before its storage can be reused. */
+			help_until_no_tasks();
+			wait_for_all_tasks_to_complete();
+
+			if (cold_tasks.empty()) {
+				return;
+			}
+
 			{
-				auto lock = lock_queue();
-				ensure(tasks.empty());
+				auto lock = lock_batch();
+
+				tasks.clear();
 				std::swap(cold_tasks, tasks);
 
-				{
-					auto lock = lock_completion();
-					tasks_completed = 0;
-					tasks_posted = tasks.size();
+				const auto num_tasks = tasks.size();
+				const auto num_queues = queues.size();
+
+				for (std::size_t i = 0; i < num_queues; ++i) {
+					queues[i].next.store(i * num_tasks / num_queues, std::memory_order_relaxed);
+					queues[i].end = (i + 1) * num_tasks / num_queues;
 				}
+
+				tasks_remaining.store(num_tasks);
 			}
 
-			cold_tasks.clear();
-			completion_variable.notify_all();
-			cv.notify_all();
+			{
+				auto lock = lock_wake();
+				++batch_generation;
+			}
+
+			wake_variable.notify_all();
 		}
 
 		std::size_t size() const {
@@ -155,28 +283,20 @@ namespace augs {
 		}
 
 		void help_until_no_tasks() {
-			for (;;) {
-				std::function<void()> task;
-
-				{
-					auto lock = lock_queue();
-
-					if (tasks.empty()) {
-						return;
-					}
-
-					task = std::move(tasks.back());
-					tasks.pop_back();
-				}
-
-				task();
-				register_completion();
+			if (called_from_own_task()) {
+				return;
 			}
+
+			run_until_no_tasks(get_helper_queue());
 		}
 
 		void wait_for_all_tasks_to_complete() {
+			if (called_from_own_task()) {
+				return;
+			}
+
 			auto lock = lock_completion();
-			completion_variable.wait(lock, [this]{ return tasks_posted == tasks_completed; });
+			completion_variable.wait(lock, [this]{ return tasks_remaining.load() == 0; });
 		}
 	};
 #endif
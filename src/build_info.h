@@ -102,6 +102,23 @@ Options:
                                 Remember to set --no-router if you're hosting e.g. on a proper VPS without a router.
 	--no-router					Disables NAT traversal for incoming connections. NAT traversal is unnecessary if you forwarded the ports,
                                 plan to only play over LAN or have a proper server instance with a dedicated IP address, without a router.
+    --client-swarm [N]          Connect N headless clients to the server given by --connect, all within one process and without a window.
+                                Without --connect, the server is hosted in the same process, on its own thread.
+                                The clients move and shoot at random and periodically log server step timings, bandwidth and repredictions.
+                                Useful for measuring how many players a dedicated server sustains.
+    --client-swarm-secs [SECS]  Stop the client swarm after SECS seconds. By default it runs until interrupted.
+    --benchmark-solver [DEMO]   Replay the DEMO as fast as possible without a window, rendering or audio, and quit.
+                                Logs the solver's steps per second, per-system timings and the final state hash.
+    --benchmark-report [PATH]   Write the --benchmark-solver results to PATH as JSON.
+    --benchmark-internals [NAME]  Run the timing benchmarks of engine internals whose names contain NAME, or all of them for "all", and quit.
+                                Only available in builds with BUILD_INTERNAL_BENCHMARKS.
+    --masterserver-load [N]     Simulate N community servers heartbeating to a local masterserver, each from its own UDP socket.
+                                Periodically logs how fast the masterserver serves the full JSON list, an unchanged list and a delta.
+                                Uses the ports of the masterserver section of config.json, or --nat-punch-port and --server-list-port.
+    --masterserver-load-secs [SECS]  Stop the masterserver load generator after SECS seconds. By default it runs until interrupted.
+    --compile-arenas            Before starting, compile every arena the server might switch to, as set in the server section of config.json.
+                                Compiled arenas are binary dumps of built arenas kept in the cache folder, so that map changes load them directly.
+    --compile-arenas-and-quit   The same as --compile-arenas, but quit afterwards. Useful as a build step for server images.
     --daily-autoupdates         Dedicated server only. Set this to apply updates when available, at a given hour every day - 03:00 (AM) by default.
                                 To change the hour, set the server.daily_autoupdate_hour variable in config.json, e.g. to "19:30".
 
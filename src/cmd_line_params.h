@@ -34,6 +34,8 @@ struct cmd_line_params {
 	bool only_check_update_availability_and_quit = false;
 	bool sync_external_arenas = false;
 	bool sync_external_arenas_and_quit = false;
+	bool compile_arenas = false;
+	bool compile_arenas_and_quit = false;
 	std::optional<int> autoupdate_delay;
 
 	augs::path_type apply_config;
@@ -42,6 +44,16 @@ struct cmd_line_params {
 	int test_fp_consistency = -1;
 	std::string connect_address;
 
+	uint32_t client_swarm_size = 0;
+	double client_swarm_secs = 0.0;
+
+	augs::path_type benchmark_demo;
+	augs::path_type benchmark_report;
+	std::string benchmark_internals;
+
+	uint32_t masterserver_load_servers = 0;
+	double masterserver_load_secs = 0.0;
+
 	bool as_service = false;
 
 	bool suppress_server_webhook = false;
@@ -241,6 +253,27 @@ struct cmd_line_params {
 			else if (a == "--connect") {
 				set_connect(get_next());
 			}
+			else if (a == "--client-swarm") {
+				client_swarm_size = static_cast<uint32_t>(std::max(0, std::atoi(get_next())));
+			}
+			else if (a == "--client-swarm-secs") {
+				client_swarm_secs = std::atof(get_next());
+			}
+			else if (a == "--benchmark-solver") {
+				benchmark_demo = get_next();
+			}
+			else if (a == "--benchmark-report") {
+				benchmark_report = get_next();
+			}
+			else if (a == "--benchmark-internals") {
+				benchmark_internals = get_next();
+			}
+			else if (a == "--masterserver-load") {
+				masterserver_load_servers = static_cast<uint32_t>(std::max(0, std::atoi(get_next())));
+			}
+			else if (a == "--masterserver-load-secs") {
+				masterserver_load_secs = std::atof(get_next());
+			}
 			else if (a == "--live-log") {
 				live_log_path = get_next();
 			}
@@ -250,6 +283,12 @@ struct cmd_line_params {
 			else if (a == "--sync-external-arenas-and-quit") {
 				sync_external_arenas_and_quit = true;
 			}
+			else if (a == "--compile-arenas") {
+				compile_arenas = true;
+			}
+			else if (a == "--compile-arenas-and-quit") {
+				compile_arenas_and_quit = true;
+			}
 			else if (a == "--appdata-dir") {
 				appdata_dir = get_next();
 			}
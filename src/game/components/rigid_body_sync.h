@@ -372,7 +372,7 @@ void component_synchronizer<E, components::rigid_body>::apply_impulse(
 				in the vicinity of (0, 0) coordinates instead of near wherever the player is.
 			*/
 
-			auto& lines = DEBUG_LOGIC_STEP_LINES;
+			auto& lines = get_logic_step_lines();
 			lines.emplace_back(green, to_pixels(location) + pixels, to_pixels(location));
 		}
 	}
@@ -24,6 +24,24 @@ void cosmic::after_solvable_copy(cosmos& to, const cosmos& from) {
 	to.get_solvable_inferred({}).physics.clone_from(from.get_solvable_inferred().physics, to, from);
 }
 
+void cosmic::after_solvable_changes_copy(cosmos& to, cosmos& from, const bool clone_physics) {
+	auto& to_physics = to.get_solvable_inferred({}).physics;
+	auto& from_physics = from.get_solvable_inferred({}).physics;
+
+	if (clone_physics) {
+		to_physics.clone_from(from_physics, to, from);
+	}
+	else {
+		to_physics.accumulated_messages = from_physics.accumulated_messages;
+	}
+
+	/* Cloning accesses the target entities for writing, so the marks are forgotten only afterwards. */
+	to.get_solvable({}).forget_changes_in_sync_with(from.get_solvable({}));
+
+	to_physics.stepped_since_sync = false;
+	from_physics.stepped_since_sync = false;
+}
+
 entity_handle just_create_entity(
 	allocate_new_entity_access access,
 	cosmos& cosm,
@@ -328,6 +346,13 @@ ref_typed_entity_handle<entity_type> cosmic::specific_clone_entity(
 		/* Initial copy-assignment */
 		new_components = source_components; 
 
+		using split_pointers = transform_types_in_list_t<split_components_of<entity_type>, std::add_pointer_t>;
+
+		for_each_type_in_list<split_pointers>([&](const auto c) {
+			using C = std::remove_pointer_t<decltype(c)>;
+			new_entity.template get_raw_component<C>({}) = source_entity.template get_raw_component<C>();
+		});
+
 		cosmic::make_suitable_for_cloning(new_solvable);
 
 		if (const auto slot = source_entity.get_current_slot()) {
@@ -33,6 +33,9 @@ class cosmic {
 	template <class F>
 	friend void entity_deleter(const entity_handle, F);
 
+	template <class H, class I>
+	static void assign_components(const H& handle, const I& components);
+
 	template <class E, class C, class I, class P>
 	static ref_typed_entity_handle<E> specific_create_entity_detail(
 		allocate_new_entity_access access,
@@ -78,11 +81,12 @@ public:
 		Post post_construction
 	);
 
-	template <class C, class I, class E>
+	template <class C, class I, class E, class S>
 	static ref_typed_entity_handle<E> undo_delete_entity(
 		C& cosm,
 		const I undo_delete_input,
 		const entity_solvable<E>& deleted_content,
+		const S& deleted_split_content,
 		const reinference_type reinference
 	);
 
@@ -112,6 +116,7 @@ public:
 	static void for_each_entity(C& self, F callback);
 
 	static void after_solvable_copy(cosmos&, const cosmos&);
+	static void after_solvable_changes_copy(cosmos& to, cosmos& from, bool clone_physics);
 	static void set_flavour_id_cache_enabled(bool flag, cosmos&);
 
 	template <class... Types>
@@ -9,7 +9,9 @@ struct cosmic_profiler : public augs::profiler_mixin<cosmic_profiler> {
 
 	augs::amount_measurements<std::size_t> visibility_raycasts = 1;
 	augs::amount_measurements<std::size_t> pathfinding_raycasts = 1;
+	augs::amount_measurements<std::size_t> missile_raycasts = 1;
 	augs::amount_measurements<std::size_t> total_step_raycasts = 1;
+	augs::amount_measurements<double> raycasts_per_second = 1;
 
 	augs::amount_measurements<std::size_t> entropy_length = 1;
 
@@ -1,5 +1,5 @@
 #include "augs/ensure_rel.h"
-#include "3rdparty/crc32/crc32.h"
+#include "augs/misc/streaming_hasher.h"
 
 #include "augs/readwrite/memory_stream.h"
 
@@ -54,12 +54,12 @@ cosmos& cosmos::operator=(const cosmos& b) {
 }
 
 template <class T>
-T cosmos::calculate_solvable_signi_hash() const {
+T cosmos::calculate_solvable_signi_hash(const bool wide) const {
 	if constexpr(std::is_same_v<T, uint32_t>) {
-		augs::memory_stream ss;
+		augs::streaming_hasher hasher;
 
-		augs::write_bytes(ss, get_clock().now);
-		augs::write_bytes(ss, get_entities_count());
+		hasher.write(get_clock().now);
+		hasher.write(get_entities_count());
 
 		for_each_having<components::sentience>(
 			[&](const auto& it) {
@@ -67,12 +67,35 @@ T cosmos::calculate_solvable_signi_hash() const {
 				const auto& c = b.get_raw_component().physics_transforms.m_xf;
 				const auto& s = it.template get<components::sentience>();
 
-				augs::write_bytes(ss, c);
-				augs::write_bytes(ss, s.meters);
+				hasher.write(c);
+				hasher.write(s.meters);
 			}
 		);
 
-		return crc32buf(reinterpret_cast<char*>(ss.data()), ss.get_write_pos());
+		if (wide) {
+			for_each_having<components::rigid_body>(
+				[&](const auto& it) {
+					const auto& b = it.template get<components::rigid_body>().get_raw_component();
+
+					hasher.write(b.physics_transforms.m_xf);
+					hasher.write(b.velocity);
+					hasher.write(b.angular_velocity);
+				}
+			);
+
+			for_each_having<components::item>(
+				[&](const auto& it) {
+					const auto& item = it.template get<components::item>().get_raw_component();
+					const auto& slot = item.current_slot;
+
+					hasher.write(item.charges);
+					hasher.write(slot.type);
+					hasher.write(slot.container_entity.raw);
+				}
+			);
+		}
+
+		return hasher.template finalize<uint32_t>();
 	}
 	else {
 		static_assert(always_false_v<T>, "Unsupported hash type.");
@@ -81,7 +104,7 @@ T cosmos::calculate_solvable_signi_hash() const {
 	return 0u;
 }
 
-template uint32_t cosmos::calculate_solvable_signi_hash() const;
+template uint32_t cosmos::calculate_solvable_signi_hash(bool) const;
 
 std::string cosmos::summary() const {
 	return typesafe_sprintf("Entities: %x\n", get_entities_count());
@@ -170,3 +193,31 @@ void cosmos::assign_solvable(const cosmos& b) {
 
 	cosmic::after_solvable_copy(*this, b);
 }
+
+assign_solvable_changes_result cosmos::assign_solvable_changes(cosmos& b) {
+	/* 
+		Produces exactly the same state as assign_solvable.
+
+		If both cosmoi were last synced with each other,
+		only the entities accessed for writing in either of them since then are written.
+		Otherwise, entities are compared one by one.
+
+		The b2World is cloned from scratch only if an entity with a body or fixtures might have changed,
+		or if a physics step moved anything in either of them.
+		The source is non-const because syncing resets its change marks too.
+	*/
+
+	assign_solvable_changes_result result;
+
+	result.cloned_physics =
+		get_solvable().physical_entities_might_differ_from(b.get_solvable())
+		|| get_solvable_inferred().physics.stepped_since_sync
+		|| b.get_solvable_inferred().physics.stepped_since_sync
+	;
+
+	result.num_written_entities = solvable.assign_changed_from(b.solvable);
+
+	cosmic::after_solvable_changes_copy(*this, b, result.cloned_physics);
+
+	return result;
+}
@@ -15,6 +15,11 @@
 
 using cosmos_id_type = int;
 
+struct assign_solvable_changes_result {
+	std::size_t num_written_entities = 0;
+	bool cloned_physics = false;
+};
+
 class cosmos {
 	template <class C, class F>
 	static void for_each_in_impl(C& self, const processing_subjects f, F callback) {
@@ -285,9 +290,15 @@ public:
 		return solvable.get_global_solvable();
 	}
 
+	/* Counts only the rays cast by the calling thread. */
+
 	template <class M>
-	auto measure_raycasts(M&) const {
-		return augs::scope_guard([](){});
+	auto measure_raycasts(M& measurement) const {
+		const auto before = physics_world_cache::get_num_raycasts_on_this_thread();
+
+		return augs::scope_guard([&measurement, before]() {
+			measurement.measure(physics_world_cache::get_num_raycasts_on_this_thread() - before);
+		});
 	}
 
 	template <class C>
@@ -309,9 +320,15 @@ public:
 	void set_fixed_delta(const augs::delta& dt);
 
 	void assign_solvable(const cosmos& b);
+	assign_solvable_changes_result assign_solvable_changes(cosmos& b);
+
+	/*
+		The wide variant additionally covers all rigid bodies and items,
+		catching desyncs before they propagate to the sentiences.
+	*/
 
 	template <class T>
-	T calculate_solvable_signi_hash() const;
+	T calculate_solvable_signi_hash(bool wide = false) const;
 
 	cosmos_id_type get_cosmos_id() const {
 		return cosmos_id;
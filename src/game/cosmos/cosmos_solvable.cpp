@@ -68,6 +68,56 @@ void cosmos_solvable::destroy_all_caches() {
 	new (&inferred) cosmos_solvable_inferred;
 }
 
+std::size_t cosmos_solvable::assign_changed_from(const cosmos_solvable& b) {
+	auto& signi = significant;
+	const auto& source_signi = b.significant;
+
+	std::size_t num_copied = 0;
+
+	signi.entity_pools.for_each_container(
+		[&](auto& entity_pool) {
+			using P = remove_cref<decltype(entity_pool)>;
+			num_copied += entity_pool.assign_changed_from(source_signi.entity_pools.template get<P>());
+		}
+	);
+
+	signi.clk = source_signi.clk;
+	signi.specific_names = source_signi.specific_names;
+	signi.global = source_signi.global;
+
+	inferred = b.inferred;
+
+	return num_copied;
+}
+
+bool cosmos_solvable::physical_entities_might_differ_from(const cosmos_solvable& b) const {
+	bool result = false;
+
+	significant.entity_pools.for_each_container(
+		[&](const auto& entity_pool) {
+			using P = remove_cref<decltype(entity_pool)>;
+			using E = entity_type_of<typename P::value_type>;
+
+			if constexpr(has_any_of_v<E, invariants::rigid_body, invariants::fixtures>) {
+				if (entity_pool.might_differ_from(b.significant.entity_pools.template get<P>())) {
+					result = true;
+				}
+			}
+		}
+	);
+
+	return result;
+}
+
+void cosmos_solvable::forget_changes_in_sync_with(cosmos_solvable& b) {
+	significant.entity_pools.for_each_container(
+		[&](auto& entity_pool) {
+			using P = remove_cref<decltype(entity_pool)>;
+			entity_pool.forget_changes_in_sync_with(b.significant.entity_pools.template get<P>());
+		}
+	);
+}
+
 void cosmos_solvable::increment_step() {
 	++significant.clk.now.step;
 }
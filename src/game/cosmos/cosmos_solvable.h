@@ -65,6 +65,10 @@ public:
 
 	void destroy_all_caches();
 
+	std::size_t assign_changed_from(const cosmos_solvable&);
+	bool physical_entities_might_differ_from(const cosmos_solvable&) const;
+	void forget_changes_in_sync_with(cosmos_solvable&);
+
 	void increment_step();
 	void clear();
 
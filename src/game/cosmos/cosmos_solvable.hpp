@@ -16,13 +16,13 @@ void cosmos_solvable::for_each_entity_impl(S& self, F callback) {
 				using index_type = typename pool_type::used_size_type;
 
 				for (index_type i = 0; i < p.size(); ++i) {
-					using R = decltype(callback(p.data()[i], i));
+					using R = decltype(callback(p.get_nth(i), i));
 					
 					if constexpr(std::is_same_v<R, void>) {
-						callback(p.data()[i], i);
+						callback(p.get_nth(i), i);
 					}
 					else {
-						const auto result = callback(p.data()[i], i);
+						const auto result = callback(p.get_nth(i), i);
 
 						if constexpr(std::is_same_v<R, callback_result>) {
 							if (result == callback_result::ABORT) {
@@ -6,6 +6,23 @@
 #include "game/cosmos/entity_creation_error.h"
 #include "game/messages/create_entity_message.h"
 
+template <class H, class I>
+void cosmic::assign_components(const H& handle, const I& components) {
+	auto& solvable = handle.get({});
+
+	if constexpr(std::is_same_v<I, typename remove_cref<decltype(solvable)>::components_type>) {
+		solvable.component_state = components;
+	}
+	else {
+		/* Some of the components are split into the columns of the pool. */
+
+		for_each_through_std_get(components, [&](const auto& c) {
+			using C = remove_cref<decltype(c)>;
+			handle.template get_raw_component<C>({}) = c;
+		});
+	}
+}
+
 template <class E, class C, class I, class P>
 ref_typed_entity_handle<E> cosmic::specific_create_entity_detail(
 	allocate_new_entity_access access,
@@ -23,10 +40,7 @@ ref_typed_entity_handle<E> cosmic::specific_create_entity_detail(
 	const auto new_allocation = cosm.get_solvable({}).template allocate_next_entity<E>({ access, flavour_id.raw });
 	const auto handle = ref_typed_entity_handle<E> { cosm, { new_allocation.object, new_allocation.key } };
 
-	{
-		auto& object = new_allocation.object;
-		object.component_state = initial_components;
-	}
+	assign_components(handle, initial_components);
 
 	pre_construction(handle, handle.get({}));
 	construct_pre_inference(handle);
@@ -135,13 +149,16 @@ entity_handle cosmic::create_entity(
 	);
 }
 
-template <class C, class I, class E>
+template <class C, class I, class E, class S>
 ref_typed_entity_handle<E> cosmic::undo_delete_entity(
 	C& cosm,
 	const I undo_delete_input,
 	const entity_solvable<E>& deleted_content,
+	const S& deleted_split_content,
 	const reinference_type reinference
 ) {
+	static_assert(std::is_same_v<S, make_split_components<E>>);
+
 	auto& s = cosm.get_solvable({});
 
 	const auto new_allocation = s.template undo_free_entity<E>(undo_delete_input, deleted_content);
@@ -149,6 +166,13 @@ ref_typed_entity_handle<E> cosmic::undo_delete_entity(
 	
 	const auto handle = ref_typed_entity_handle<E> { cosm, { new_allocation.object, new_allocation.key } };
 
+	/* The solvable does not carry the split components, so they were kept separately. */
+
+	for_each_through_std_get(deleted_split_content, [&](const auto& c) {
+		using Component = remove_cref<decltype(c)>;
+		handle.template get_raw_component<Component>({}) = c;
+	});
+
 	if (reinference == reinference_type::ONLY_AFFECTED) {
 		infer_caches_for(handle);
 	}
@@ -27,7 +27,8 @@ struct entity_solvable_meta {
 template <class E>
 struct entity_solvable : entity_solvable_meta {
 	using used_entity_type = E;
-	using components_type = make_components<E>;
+	/* Split components live in the columns of the pool, not here. */
+	using components_type = make_solvable_components<E>;
 	using entity_solvable_meta::entity_solvable_meta;
 	using introspect_base = entity_solvable_meta;
 
@@ -38,6 +39,7 @@ struct entity_solvable : entity_solvable_meta {
 	template <class C>
 	static constexpr bool has() {
 		static_assert(!is_invariant_v<C>, "Don't check for invariants here!");
+		static_assert(!is_split_component_v<E, C>, "Split components are only accessible through handles.");
 
 		return is_one_of_list_v<C, components_type>;
 	}
@@ -42,6 +42,54 @@ using make_components =
 	>
 ;
 
+/*
+	An entity type may list some of its components in split_components.
+	Its pool then keeps each of them in a separate contiguous column
+	instead of inside the entity_solvable objects,
+	so that passes over just these components do not stride over all the other data.
+
+	Handles find split components transparently.
+*/
+
+template <class T, class = void>
+struct split_components_of_impl {
+	using type = type_list<>;
+};
+
+template <class T>
+struct split_components_of_impl<T, decltype(std::declval<typename T::split_components>(), void())> {
+	using type = typename T::split_components;
+};
+
+template <class T>
+using split_components_of = typename split_components_of_impl<T>::type;
+
+template <class T, class C>
+constexpr bool is_split_component_v = is_one_of_list_v<C, split_components_of<T>>;
+
+template <class T>
+struct is_stored_in_solvable {
+	template <class C>
+	struct type : std::bool_constant<!is_split_component_v<T, C>> {};
+};
+
+template <class T>
+using solvable_components_of = filter_types_in_list_t<is_stored_in_solvable<T>::template type, components_of<T>>;
+
+template <class T>
+using make_solvable_components = 
+	std::conditional_t<
+		all_in_list_are_v<std::is_trivially_copyable, solvable_components_of<T>>,
+		replace_list_type_t<solvable_components_of<T>, augs::trivially_copyable_tuple>,
+		replace_list_type_t<solvable_components_of<T>, std::tuple>
+	>
+;
+
+/* Values of the split components of a single entity, e.g. to keep them while it is deleted. */
+
+template <class T>
+using make_split_components = replace_list_type_t<split_components_of<T>, std::tuple>;
+
 template <template <class> class Predicate>
 using entity_types_passing = filter_types_in_list_t<Predicate, all_entity_types>;
 
@@ -12,6 +12,10 @@ public:
 	private_cosmos_solvable() = default;
 	explicit private_cosmos_solvable(const cosmic_pool_size_type reserved_entities) : solvable(reserved_entities) {};
 
+	auto assign_changed_from(const private_cosmos_solvable& b) {
+		return solvable.assign_changed_from(b.solvable);
+	}
+
 	auto& get_solvable(cosmos_solvable_access) {
 		return solvable;
 	}
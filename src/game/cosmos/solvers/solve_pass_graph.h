@@ -0,0 +1,162 @@
+#pragma once
+#include <vector>
+#include <typeindex>
+
+#include "augs/templates/thread_pool.h"
+#include "game/debug_drawing_settings.h"
+
+/*
+	Passes of the solver declare which components, message queues
+	and other shared resources they read and write.
+
+	A pass only waits for the earlier passes it conflicts with,
+	so passes with disjoint accesses can run concurrently on a thread pool.
+	Conflicting passes always run in the order they were added,
+	which keeps the result bit-identical to the serial execution
+	as long as the declarations are complete.
+
+	Passes that create or delete entities, touch the physics world
+	or simply haven't had their accesses audited are added with add_exclusive.
+	They conflict with every other pass, so they run alone, at the very point they were added.
+
+	Logic step lines written by concurrent passes go to a buffer per pass
+	and are appended in the order of the passes once the whole level completes.
+
+	The graph is meant to be built once and then run for every step,
+	so the passes are plain functions of the step rather than closures over it.
+	Running never modifies the graph, so one graph may be run by several solving threads at once.
+*/
+
+namespace solve_access {
+	/* Resources shared between passes that are neither components nor message queues. */
+
+	struct step_rng {};
+	struct organisms {};
+}
+
+template <class... T>
+struct pass_reads {};
+
+template <class... T>
+struct pass_writes {};
+
+template <class... Args>
+class solve_pass_graph {
+	using access_list = std::vector<std::type_index>;
+	using callback_type = void(*)(Args...);
+
+	struct solve_pass {
+		access_list reads;
+		access_list writes;
+		callback_type callback;
+		bool exclusive = false;
+	};
+
+	std::vector<solve_pass> passes;
+
+	/* Indices of passes that may run concurrently, in the order they must run. */
+	std::vector<std::vector<std::size_t>> levels;
+
+	static bool intersect(const access_list& a, const access_list& b) {
+		for (const auto& aa : a) {
+			for (const auto& bb : b) {
+				if (aa == bb) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	static bool conflict(const solve_pass& a, const solve_pass& b) {
+		return
+			a.exclusive
+			|| b.exclusive
+			|| intersect(a.writes, b.writes)
+			|| intersect(a.writes, b.reads)
+			|| intersect(a.reads, b.writes)
+		;
+	}
+
+	std::size_t find_level_of(const std::size_t pass_index) const {
+		std::size_t level = 0;
+
+		for (std::size_t l = 0; l < levels.size(); ++l) {
+			for (const auto earlier : levels[l]) {
+				if (conflict(passes[pass_index], passes[earlier])) {
+					level = l + 1;
+				}
+			}
+		}
+
+		return level;
+	}
+
+	void place_last_pass() {
+		const auto pass_index = passes.size() - 1;
+		const auto level = find_level_of(pass_index);
+
+		if (level == levels.size()) {
+			levels.emplace_back();
+		}
+
+		levels[level].push_back(pass_index);
+	}
+
+public:
+	template <class... R, class... W>
+	void add(pass_reads<R...>, pass_writes<W...>, const callback_type callback) {
+		passes.push_back({
+			{ std::type_index(typeid(R))... },
+			{ std::type_index(typeid(W))... },
+			callback
+		});
+
+		place_last_pass();
+	}
+
+	void add_exclusive(const callback_type callback) {
+		passes.push_back({ {}, {}, callback, true });
+		place_last_pass();
+	}
+
+	void run(augs::thread_pool* const pool, Args... args) const {
+		const bool serial = pool == nullptr || pool->size() == 0 || levels.size() == passes.size();
+
+		if (serial) {
+			for (const auto& p : passes) {
+				p.callback(args...);
+			}
+
+			return;
+		}
+
+		for (const auto& level : levels) {
+			if (level.size() == 1) {
+				passes[level[0]].callback(args...);
+				continue;
+			}
+
+			std::vector<std::vector<debug_line>> lines_per_pass(level.size());
+
+			for (std::size_t i = 0; i < level.size(); ++i) {
+				pool->enqueue([&lines = lines_per_pass[i], callback = passes[level[i]].callback, args...]() {
+					auto redirect = scoped_logic_step_lines(lines);
+					callback(args...);
+				});
+			}
+
+			pool->submit();
+			pool->help_until_no_tasks();
+			pool->wait_for_all_tasks_to_complete();
+
+			auto& merged = get_logic_step_lines();
+
+			for (std::size_t i = 0; i < level.size(); ++i) {
+				const auto& lines = lines_per_pass[i];
+				merged.insert(merged.end(), lines.begin(), lines.end());
+			}
+		}
+	}
+};
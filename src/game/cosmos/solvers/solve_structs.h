@@ -2,6 +2,10 @@
 #include "game/cosmos/entity_id.h"
 #include "game/detail/view_input/predictability_info.h"
 
+namespace augs {
+	class thread_pool;
+}
+
 struct solve_result {
 	bool state_inconsistent = false;
 };
@@ -14,4 +18,11 @@ struct solve_settings {
 	bool drop_weapons_if_empty = true;
 
 	bool pause_simulation = false;
+
+	/* 
+		If set, independent passes of the step may run concurrently.
+		The result stays bit-identical to the serial solve.
+	*/
+
+	augs::thread_pool* pool = nullptr;
 };
@@ -2,6 +2,7 @@
 #include "game/organization/all_component_includes.h"
 
 #include "game/cosmos/solvers/standard_solver.h"
+#include "game/cosmos/solvers/solve_pass_graph.h"
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/cosmic_functions.h"
 #include "game/cosmos/entity_handle.h"
@@ -53,65 +54,19 @@ data_living_one_step& standard_solver::get_thread_local_queues() {
 	return queues;
 }
 
-void standard_solve(const logic_step step) {
-	auto& cosm = step.get_cosmos();
-	auto& performance = cosm.profiler;
-
-	const bool pause_simulation = step.get_settings().pause_simulation;
-
-	auto input_and_intents_pass = [&]() {
-		input_system().make_input_messages(step);
-
-		intent_contextualization_system().contextualize_crosshair_action_intents(step);
-		intent_contextualization_system().contextualize_movement_intents(step);
-
-		intent_contextualization_system().handle_use_button_presses(step);
-	};
-
-	if (pause_simulation) {
-		auto logic_scope = measure_scope(performance.logic);
-
-		/*
-			Only handle inputs.
-		*/
+using step_pass_graph = solve_pass_graph<const logic_step>;
 
-		input_and_intents_pass();
+static void make_inputs_and_intents(const logic_step step) {
+	input_system().make_input_messages(step);
 
-		{
-			auto scope = measure_scope(performance.movement);
-			movement_system().set_movement_flags_from_input(step);
-		}
+	intent_contextualization_system().contextualize_crosshair_action_intents(step);
+	intent_contextualization_system().contextualize_movement_intents(step);
 
-		crosshair_system().handle_crosshair_intents(step);
-		crosshair_system().update_base_offsets(step);
-
-		return;
-	}
-
-	auto& global = cosm.get_global_solvable();
-
-#if STRESS_TEST_REINFERENCES
-	{
-		auto& s_rng = step.step_rng;
-
-		if (const auto v = s_rng.randval(0, 4); v == 4) {
-			auto rrr = randomization::from_random_device();
-			const auto times = rrr.randval(1, 9);
-
-			for (int i = 0; i < times; ++i) {
-				cosmic::reinfer_solvable(cosm);
-			}
-		}
-	}
-#endif
-
-	ensure_greater(step.get_delta().in_seconds(), 0.f);
-
-	auto logic_scope = measure_scope(performance.logic);
-
-	auto total_raycasts_scope = cosm.measure_raycasts(performance.total_step_raycasts);
+	intent_contextualization_system().handle_use_button_presses(step);
+}
 
-	contact_listener listener(cosm);
+static void perform_transfers_from_entropy(const logic_step step) {
+	auto& cosm = step.get_cosmos();
 
 	for (const auto& p : step.get_entropy().players) {
 		const auto player_entity = cosm[p.first];
@@ -153,148 +108,415 @@ void standard_solve(const logic_step step) {
 		}
 	}
 
-	performance.entropy_length.measure(step.get_entropy().length());
+	cosm.profiler.entropy_length.measure(step.get_entropy().length());
+}
 
-	sentience_system().cast_spells(step);
+/*
+	Every pass of a step, in the order they run serially.
+	The physics step sits between the two graphs, as the contact listener has to know about it,
+	and it would anyway have to run alone.
+*/
+
+static const step_pass_graph& get_passes_before_physics() {
+	static const auto graph = []() {
+		step_pass_graph g;
+
+		g.add_exclusive([](const logic_step step) { perform_transfers_from_entropy(step); });
+		g.add_exclusive([](const logic_step step) { sentience_system().cast_spells(step); });
+		g.add_exclusive([](const logic_step step) { make_inputs_and_intents(step); });
+		g.add_exclusive([](const logic_step step) { intent_contextualization_system().advance_use_interactions(step); });
+
+		g.add(
+			pass_reads<invariants::movement_path, invariants::area_marker>(),
+			pass_writes<
+				components::movement_path,
+				components::transform,
+				components::animation,
+				messages::start_particle_effect,
+				solve_access::step_rng,
+				solve_access::organisms
+			>(),
+			[](const logic_step step) {
+				auto scope = measure_scope(step.get_cosmos().profiler.movement_paths);
+				movement_path_system().advance_paths(step);
+			}
+		);
+
+		g.add(
+			pass_reads<invariants::animation>(),
+			pass_writes<components::animation, messages::queue_deletion>(),
+			[](const logic_step step) {
+				auto scope = measure_scope(step.get_cosmos().profiler.stateful_animations);
+				animation_system().advance_stateful_animations(step);
+			}
+		);
 
-	input_and_intents_pass();
+		g.add_exclusive([](const logic_step step) {
+			auto scope = measure_scope(step.get_cosmos().profiler.movement);
+			movement_system().set_movement_flags_from_input(step);
+			movement_system().apply_movement_forces(step);
+		});
 
-	intent_contextualization_system().advance_use_interactions(step);
+		g.add_exclusive([](const logic_step step) {
+			crosshair_system().handle_crosshair_intents(step);
+			crosshair_system().update_base_offsets(step);
+			melee_system().initiate_and_update_moves(step);
+			sentience_system().rotate_towards_crosshairs_and_driven_vehicles(step);
 
-	{
-		auto scope = measure_scope(performance.movement_paths);
-		movement_path_system().advance_paths(step);
-	}
+			gun_system().launch_shots_due_to_pressed_triggers(step);
 
-	{
-		auto scope = measure_scope(performance.stateful_animations);
-		animation_system().advance_stateful_animations(step);
-	}
+			car_system().set_steering_flags_from_intents(step);
+			car_system().apply_movement_forces(step);
 
-	{
-		auto scope = measure_scope(performance.movement);
-		movement_system().set_movement_flags_from_input(step);
-		movement_system().apply_movement_forces(step);
-	}
+			melee_system().advance_thrown_melee_logic(step);
 
-	crosshair_system().handle_crosshair_intents(step);
-	crosshair_system().update_base_offsets(step);
-	melee_system().initiate_and_update_moves(step);
-	sentience_system().rotate_towards_crosshairs_and_driven_vehicles(step);
+			force_joint_system().apply_forces_towards_target_entities(step);
+			item_system().handle_throw_item_intents(step);
+			item_system().handle_reload_intents(step);
+			item_system().advance_reloading_contexts(step);
+			step.get_cosmos().get_global_solvable().solve_item_mounting(step);
+			item_system().handle_wielding_requests(step);
+		});
 
-	gun_system().launch_shots_due_to_pressed_triggers(step);
+		g.add_exclusive([](const logic_step step) {
+			const auto pool = step.get_settings().pool;
+			auto scope = measure_scope(step.get_cosmos().profiler.explosives);
 
-	car_system().set_steering_flags_from_intents(step);
-	car_system().apply_movement_forces(step);
+			demolitions_system().detonate_fuses(step, pool);
+			step.flush_pending_allocations();
+			demolitions_system().advance_cascade_explosions(step, pool);
+		});
 
-	melee_system().advance_thrown_melee_logic(step);
+		return g;
+	}();
 
-	force_joint_system().apply_forces_towards_target_entities(step);
-	item_system().handle_throw_item_intents(step);
-	item_system().handle_reload_intents(step);
-	item_system().advance_reloading_contexts(step);
-	global.solve_item_mounting(step);
-	item_system().handle_wielding_requests(step);
+	return graph;
+}
 
-	{
-		auto scope = measure_scope(performance.explosives);
+static const step_pass_graph& get_passes_after_physics() {
+	static const auto graph = []() {
+		step_pass_graph g;
+
+		g.add_exclusive([](const logic_step step) {
+			physics_system().post_and_clear_accumulated_collision_messages(step);
+			portal_system().advance_portal_logic(step);
+		});
+
+		g.add(
+			pass_reads<invariants::trace>(),
+			pass_writes<components::trace>(),
+			[](const logic_step step) { trace_system().lengthen_sprites_of_traces(step); }
+		);
+
+		g.add(
+			pass_reads<invariants::crosshair, invariants::sentience>(),
+			pass_writes<components::crosshair, components::sentience>(),
+			[](const logic_step step) { crosshair_system().integrate_crosshair_recoils(step); }
+		);
+
+		g.add_exclusive([](const logic_step step) {
+			auto& cosm = step.get_cosmos();
+			auto& performance = cosm.profiler;
+			auto scope = measure_scope(performance.missiles);
+
+			{
+				auto missile_raycasts_scope = cosm.measure_raycasts(performance.missile_raycasts);
+				missile_system().advance_penetrations(step);
+			}
 
-		demolitions_system().detonate_fuses(step);
-		step.flush_pending_allocations();
-		demolitions_system().advance_cascade_explosions(step);
-	}
+			missile_system().ricochet_missiles(step);
+			missile_system().detonate_colliding_missiles(step);
+			missile_system().detonate_expired_missiles(step);
+		});
+
+		g.add_exclusive([](const logic_step step) {
+			destruction_system().generate_damages_from_forceful_collisions(step);
+			destruction_system().apply_damages_and_split_fixtures(step);
+		});
+
+		g.add_exclusive([](const logic_step step) {
+			auto scope = measure_scope(step.get_cosmos().profiler.sentiences);
+
+			/* 
+				Called before process_damages_and_generate_health_events 
+				because it's meant to process health events posted externally
+				(e.g. forced deaths, posted by the game mode - for example when changing teams)
+			*/
+			sentience_system().process_special_results_of_health_events(step);
+
+			sentience_system().regenerate_values_and_advance_spell_logic(step);
+			sentience_system().process_damages_and_generate_health_events(step);
+		});
+
+		g.add(
+			pass_reads<invariants::head>(),
+			pass_writes<components::head>(),
+			[](const logic_step step) { sentience_system().cooldown_aimpunches(step); }
+		);
+
+		using driver_accesses = pass_writes<components::driver, components::car, components::movement>;
+
+		g.add(
+			pass_reads<messages::intent_message, components::sentience>(),
+			driver_accesses(),
+			[](const logic_step step) { driver_system().release_drivers_due_to_requests(step); }
+		);
+
+		g.add(
+			pass_reads<messages::collision_message, components::sentience, components::rigid_body>(),
+			driver_accesses(),
+			[](const logic_step step) { driver_system().assign_drivers_who_touch_wheels(step); }
+		);
+
+		g.add(
+			pass_reads<messages::collision_message, components::rigid_body>(),
+			driver_accesses(),
+			[](const logic_step step) { driver_system().release_drivers_due_to_ending_contact_with_wheel(step); }
+		);
+
+		using effect_events = pass_reads<
+			messages::collision_message,
+			messages::gunshot_message,
+			messages::damage_message,
+			messages::health_event,
+			messages::exhausted_cast,
+			components::sentience,
+			components::item,
+			components::sender
+		>;
+
+		g.add(
+			effect_events(),
+			pass_writes<
+				messages::start_particle_effect,
+				messages::stop_particle_effect,
+				messages::exploding_ring_effect,
+				messages::thunder_effect
+			>(),
+			[](const logic_step step) { particles_existence_system().play_particles_from_events(step); }
+		);
+
+		g.add(
+			pass_reads<invariants::continuous_particles>(),
+			pass_writes<components::continuous_particles, solve_access::step_rng>(),
+			[](const logic_step step) { particles_existence_system().displace_streams(step); }
+		);
+
+		g.add(
+			effect_events(),
+			pass_writes<
+				messages::start_sound_effect,
+				messages::start_particle_effect,
+				solve_access::step_rng
+			>(),
+			[](const logic_step step) { sound_existence_system().play_sounds_from_events(step); }
+		);
 
-	{
-		listener.during_step = true;
-		physics_system().step_and_set_new_transforms(step);
-		listener.during_step = false;
-	}
+#if TODO_VISIBILITY
+		g.add_exclusive([](const logic_step step) {
+			auto& cosm = step.get_cosmos();
+			auto scope = measure_scope(cosm.profiler.visibility);
+			auto visibility_raycasts_scope = cosm.measure_raycasts(cosm.profiler.visibility_raycasts);
 
-	physics_system().post_and_clear_accumulated_collision_messages(step);
-	portal_system().advance_portal_logic(step);
+			visibility_system(get_logic_step_lines()).calc_visibility(step);
+		});
+#endif
 
-	trace_system().lengthen_sprites_of_traces(step);
+		g.add_exclusive([](const logic_step step) {
+			auto scope = measure_scope(step.get_cosmos().profiler.ai);
+			behaviour_tree_system().evaluate_trees(step);
+		});
 
-	crosshair_system().integrate_crosshair_recoils(step);
+		g.add_exclusive([](const logic_step step) {
+			auto& cosm = step.get_cosmos();
+			auto pathfinding_raycasts_scope = cosm.measure_raycasts(cosm.profiler.pathfinding_raycasts);
 
-	{
-		auto scope = measure_scope(performance.missiles);
+#if TODO_PATHFINDING
+			auto scope = measure_scope(cosm.profiler.pathfinding);
+			pathfinding_system().advance_pathfinding_sessions(step);
+#endif
+		});
 
-		missile_system().advance_penetrations(step);
+		g.add_exclusive([](const logic_step step) {
+			auto& transfers = step.get_queue<item_slot_transfer_request>();
+			perform_transfers(transfers, step);
+		});
 
-		missile_system().ricochet_missiles(step);
-		missile_system().detonate_colliding_missiles(step);
-		missile_system().detonate_expired_missiles(step);
-	}
+		g.add(
+			pass_reads<>(),
+			pass_writes<components::trace, messages::queue_deletion>(),
+			[](const logic_step step) { trace_system().destroy_outdated_traces(step); }
+		);
 
-	destruction_system().generate_damages_from_forceful_collisions(step);
-	destruction_system().apply_damages_and_split_fixtures(step);
+		g.add(
+			pass_reads<invariants::remnant>(),
+			pass_writes<components::remnant, messages::queue_deletion>(),
+			[](const logic_step step) { remnant_system().shrink_and_destroy_remnants(step); }
+		);
 
-	{
-		auto scope = measure_scope(performance.sentiences);
+		g.add_exclusive([](const logic_step step) {
+			const auto queued_before_marking_num = step.get_queue<messages::queue_deletion>().size();
+			(void)queued_before_marking_num;
+
+			deletion_system().mark_queued_entities_and_their_children_for_deletion(step);
+
+			trace_system().spawn_finishing_traces_for_deleted_entities(step);
 
-		/* 
-			Called before process_damages_and_generate_health_events 
-			because it's meant to process health events posted externally
-			(e.g. forced deaths, posted by the game mode - for example when changing teams)
+			const auto queued_at_end_num = step.get_queue<messages::queue_deletion>().size();
+			(void)queued_at_end_num;
+
+			ensure_eq(queued_at_end_num, queued_before_marking_num);
+		});
+
+		return g;
+	}();
+
+	return graph;
+}
+
+void standard_solve(const logic_step step) {
+	auto& cosm = step.get_cosmos();
+	const auto pool = step.get_settings().pool;
+	auto& performance = cosm.profiler;
+
+	const bool pause_simulation = step.get_settings().pause_simulation;
+
+	if (pause_simulation) {
+		auto logic_scope = measure_scope(performance.logic);
+
+		/*
+			Only handle inputs.
 		*/
-		sentience_system().process_special_results_of_health_events(step);
 
-		sentience_system().regenerate_values_and_advance_spell_logic(step);
-		sentience_system().process_damages_and_generate_health_events(step);
-		sentience_system().cooldown_aimpunches(step);
-	}
+		make_inputs_and_intents(step);
+
+		{
+			auto scope = measure_scope(performance.movement);
+			movement_system().set_movement_flags_from_input(step);
+		}
 
-	driver_system().release_drivers_due_to_requests(step);
-	driver_system().assign_drivers_who_touch_wheels(step);
-	driver_system().release_drivers_due_to_ending_contact_with_wheel(step);
+		crosshair_system().handle_crosshair_intents(step);
+		crosshair_system().update_base_offsets(step);
 
-	particles_existence_system().play_particles_from_events(step);
-	particles_existence_system().displace_streams(step);
-	sound_existence_system().play_sounds_from_events(step);
+		return;
+	}
 
-#if TODO_VISIBILITY
+#if STRESS_TEST_REINFERENCES
 	{
-		auto scope = measure_scope(performance.visibility);
-		auto visibility_raycasts_scope = cosm.measure_raycasts(performance.visibility_raycasts);
+		auto& s_rng = step.step_rng;
 
-		visibility_system(DEBUG_LOGIC_STEP_LINES).calc_visibility(step);
+		if (const auto v = s_rng.randval(0, 4); v == 4) {
+			auto rrr = randomization::from_random_device();
+			const auto times = rrr.randval(1, 9);
+
+			for (int i = 0; i < times; ++i) {
+				cosmic::reinfer_solvable(cosm);
+			}
+		}
 	}
 #endif
 
+	ensure_greater(step.get_delta().in_seconds(), 0.f);
+
+	auto logic_scope = measure_scope(performance.logic);
+
+	/* Declared first, so that it runs after total_step_raycasts is measured. */
+	auto raycasts_per_second_scope = augs::scope_guard([&]() {
+		const auto total = static_cast<double>(performance.total_step_raycasts.get_last_measurement_units());
+		performance.raycasts_per_second.measure(total / step.get_delta().in_seconds());
+	});
+
+	auto total_raycasts_scope = cosm.measure_raycasts(performance.total_step_raycasts);
+
+	contact_listener listener(cosm);
+
+	get_passes_before_physics().run(pool, step);
+
 	{
-		auto scope = measure_scope(performance.ai);
-		behaviour_tree_system().evaluate_trees(step);
+		listener.during_step = true;
+		physics_system().step_and_set_new_transforms(step);
+		listener.during_step = false;
 	}
 
-	{
-		auto pathfinding_raycasts_scope = cosm.measure_raycasts(performance.pathfinding_raycasts);
+	get_passes_after_physics().run(pool, step);
 
-#if TODO_PATHFINDING
-		auto scope = measure_scope(performance.pathfinding);
-		pathfinding_system().advance_pathfinding_sessions(step);
+	cosmic::increment_step(cosm);
+}
+
+#if BUILD_TEST_SCENES && (BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS)
+#include "augs/templates/thread_pool.h"
+#include "test_scenes/test_scene_fixture.h"
+
+static auto make_parallel_solve_settings(augs::thread_pool& pool) {
+	auto settings = solve_settings();
+	settings.pool = std::addressof(pool);
+	return settings;
+}
 #endif
-	}
 
-	{
-		auto& transfers = step.get_queue<item_slot_transfer_request>();
-		perform_transfers(transfers, step);
+#if BUILD_UNIT_TESTS && BUILD_TEST_SCENES
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/readwrite/to_bytes.h"
+
+TEST_CASE("StandardSolver ParallelSolveDeterminism") {
+	const auto scene = make_test_scene_cosmos();
+
+	auto& serial = *scene;
+	cosmos parallel = serial;
+
+	auto pool = augs::thread_pool(3);
+	const auto parallel_settings = make_parallel_solve_settings(pool);
+
+	for (int i = 0; i < 60; ++i) {
+		advance_test_scene(serial, 1);
+		advance_test_scene(parallel, 1, parallel_settings);
+
+		REQUIRE(
+			serial.calculate_solvable_signi_hash<uint32_t>(true)
+			== parallel.calculate_solvable_signi_hash<uint32_t>(true)
+		);
 	}
 
-	trace_system().destroy_outdated_traces(step);
-	remnant_system().shrink_and_destroy_remnants(step);
+	REQUIRE(
+		augs::to_bytes(serial.get_solvable().significant)
+		== augs::to_bytes(parallel.get_solvable().significant)
+	);
+}
+#endif
 
-	const auto queued_before_marking_num = step.get_queue<messages::queue_deletion>().size();
-	(void)queued_before_marking_num;
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_TEST_SCENES
+#include "augs/internal_benchmarks.h"
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
 
-	deletion_system().mark_queued_entities_and_their_children_for_deletion(step);
+INTERNAL_BENCHMARK("StandardSolver ParallelSolve") {
+	const auto scene = make_test_scene_cosmos();
 
-	trace_system().spawn_finishing_traces_for_deleted_entities(step);
+	auto& serial = *scene;
+	cosmos parallel = serial;
 
-	const auto queued_at_end_num = step.get_queue<messages::queue_deletion>().size();
-	(void)queued_at_end_num;
+	auto pool = augs::thread_pool(3);
+	const auto parallel_settings = make_parallel_solve_settings(pool);
 
-	ensure_eq(queued_at_end_num, queued_before_marking_num);
+	const int num_steps = 300;
 
-	cosmic::increment_step(cosm);
+	double serial_ms = 0.0;
+	double parallel_ms = 0.0;
+
+	for (int i = 0; i < num_steps; ++i) {
+		{
+			augs::timer t;
+			advance_test_scene(serial, 1);
+			serial_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+			advance_test_scene(parallel, 1, parallel_settings);
+			parallel_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG("Solve of %x steps. Serial: %x ms, parallel: %x ms.", num_steps, serial_ms, parallel_ms);
 }
+#endif
@@ -18,6 +18,12 @@
 #include "augs/readwrite/byte_readwrite.h"
 #include "augs/log_path_getters.h"
 
+#include "augs/misc/pool/pool.h"
+#include "augs/misc/pool/pool_allocate.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/log.h"
+#include "game/cosmos/entity_pools.h"
+
 TEST_CASE("StateTest0 PaddingSanityCheck1") {
 	struct ok {
 		bool a;
@@ -214,5 +220,256 @@ TEST_CASE("StateTest2 PaddingTest") {
 #endif
 #endif
 }
+
+TEST_CASE("StateTest3 SplitComponentsIteration") {
+	/*
+		A pass over the rigid bodies and sentiences of characters
+		must give the same results with all components inside the pooled objects
+		as with these two split into columns and found the way handles find them.
+	*/
+
+	using E = controlled_character;
+
+	constexpr unsigned num_entities = 100;
+	constexpr unsigned num_passes = 3;
+
+	using whole_pool = augs::pool<make_components<E>, make_vector, unsigned>;
+	using split_pool = augs::pool<make_solvable_components<E>, make_vector, unsigned, transform_types_in_list_t<split_components_of<E>, augs::pool_column>>;
+
+	auto whole = std::make_unique<whole_pool>();
+	auto split = std::make_unique<split_pool>();
+
+	for (unsigned i = 0; i < num_entities; ++i) {
+		whole->allocate();
+		split->allocate();
+	}
+
+	unsigned i = 0;
+
+	for (auto& object : *whole) {
+		std::get<components::rigid_body>(object).velocity.x = static_cast<float>(i++);
+	}
+
+	i = 0;
+
+	for (auto& object : *split) {
+		split->template get_corresponding<augs::pool_column<components::rigid_body>>(object).value.velocity.x = static_cast<float>(i++);
+	}
+
+	auto pass = [](components::rigid_body& body, components::sentience& sentience) {
+		body.angular_velocity += body.velocity.x + 1.f;
+		++sentience.time_of_last_exertion.step;
+	};
+
+	for (unsigned p = 0; p < num_passes; ++p) {
+		for (auto& object : *whole) {
+			pass(std::get<components::rigid_body>(object), std::get<components::sentience>(object));
+		}
+
+		for (auto& object : *split) {
+			pass(
+				split->template get_corresponding<augs::pool_column<components::rigid_body>>(object).value,
+				split->template get_corresponding<augs::pool_column<components::sentience>>(object).value
+			);
+		}
+	}
+
+	REQUIRE(whole->size() == split->size());
+
+	for (unsigned e = 0; e < num_entities; ++e) {
+		const auto& w = whole->data()[e];
+		const auto& split_body = split->template get_corresponding<augs::pool_column<components::rigid_body>>(split->data()[e]).value;
+		const auto& split_sentience = split->template get_corresponding<augs::pool_column<components::sentience>>(split->data()[e]).value;
+
+		REQUIRE(std::get<components::rigid_body>(w).angular_velocity == split_body.angular_velocity);
+		REQUIRE(std::get<components::sentience>(w).time_of_last_exertion.step == split_sentience.time_of_last_exertion.step);
+	}
+}
+
+#if BUILD_TEST_SCENES
+#include "augs/readwrite/to_bytes.h"
+#include "test_scenes/test_scene_fixture.h"
+
+TEST_CASE("StateTest4 IncrementalSolvableTransfer") {
+	const auto referential = make_test_scene_cosmos();
+	auto& referential_cosm = *referential;
+
+	cosmos full = referential_cosm;
+	cosmos incremental = referential_cosm;
+
+	/* A typical misprediction: the predicted cosmoi have run ahead of the referential one. */
+
+	advance_test_scene(referential_cosm, 1);
+	advance_test_scene(full, 2);
+	advance_test_scene(incremental, 2);
+
+	full.assign_solvable(referential_cosm);
+
+	const auto first = incremental.assign_solvable_changes(referential_cosm);
+
+	REQUIRE(first.num_written_entities <= referential_cosm.get_entities_count());
+	REQUIRE(first.cloned_physics);
+
+	REQUIRE(
+		augs::to_bytes(full.get_solvable().significant)
+		== augs::to_bytes(incremental.get_solvable().significant)
+	);
+
+	const auto repeated = incremental.assign_solvable_changes(referential_cosm);
+
+	REQUIRE(0 == repeated.num_written_entities);
+	REQUIRE(!repeated.cloned_physics);
+
+	/* Now they are in sync, so only the entities that the steps accessed are written. */
+
+	advance_test_scene(referential_cosm, 1);
+	advance_test_scene(full, 2);
+	advance_test_scene(incremental, 2);
+
+	full.assign_solvable(referential_cosm);
+	incremental.assign_solvable_changes(referential_cosm);
+
+	REQUIRE(
+		augs::to_bytes(full.get_solvable().significant)
+		== augs::to_bytes(incremental.get_solvable().significant)
+	);
+
+	/* The inferred state must be valid too, so both must keep simulating identically. */
+
+	advance_test_scene(full, 3);
+	advance_test_scene(incremental, 3);
+
+	REQUIRE(full.calculate_solvable_signi_hash<uint32_t>() == incremental.calculate_solvable_signi_hash<uint32_t>());
+}
+
+#endif
+
+#endif
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS
+#include "augs/internal_benchmarks.h"
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/pool/pool.h"
+#include "augs/misc/pool/pool_allocate.h"
+#include "game/organization/all_component_includes.h"
+#include "game/cosmos/entity_pools.h"
+
+INTERNAL_BENCHMARK("StateTest3 SplitComponentsIteration") {
+	/*
+		A pass over the rigid bodies and sentiences of 5000 characters,
+		first with all components inside the pooled objects,
+		then with these two split into columns and found the way handles find them.
+		StateTest3 checks that both give the same results.
+	*/
+
+	using E = controlled_character;
+
+	constexpr unsigned num_entities = 5000;
+	constexpr unsigned num_passes = 100;
+
+	using whole_pool = augs::pool<make_components<E>, make_vector, unsigned>;
+	using split_pool = augs::pool<make_solvable_components<E>, make_vector, unsigned, transform_types_in_list_t<split_components_of<E>, augs::pool_column>>;
+
+	auto pass = [](components::rigid_body& body, components::sentience& sentience) {
+		body.angular_velocity += body.velocity.x + 1.f;
+		++sentience.time_of_last_exertion.step;
+	};
+
+	auto measure = [&](auto& p, auto for_each_entity) {
+		for (unsigned i = 0; i < num_entities; ++i) {
+			p.allocate();
+		}
+
+		augs::timer t;
+
+		for (unsigned i = 0; i < num_passes; ++i) {
+			for_each_entity(pass);
+		}
+
+		const auto ms = t.get<std::chrono::milliseconds>();
+
+		double total = 0.0;
+
+		for_each_entity([&](const components::rigid_body& body, const components::sentience& sentience) {
+			total += body.angular_velocity + sentience.time_of_last_exertion.step;
+		});
+
+		return std::make_pair(ms, total);
+	};
+
+	auto whole = std::make_unique<whole_pool>();
+	auto split = std::make_unique<split_pool>();
+
+	const auto whole_result = measure(*whole, [&](auto callback) {
+		for (auto& object : *whole) {
+			callback(std::get<components::rigid_body>(object), std::get<components::sentience>(object));
+		}
+	});
+
+	const auto split_result = measure(*split, [&](auto callback) {
+		for (auto& object : *split) {
+			callback(
+				split->template get_corresponding<augs::pool_column<components::rigid_body>>(object).value,
+				split->template get_corresponding<augs::pool_column<components::sentience>>(object).value
+			);
+		}
+	});
+
+	LOG(
+		"%x passes over %x characters. Object size: %x, split: %x. Components inside objects: %x ms, split into columns: %x ms.",
+		num_passes,
+		num_entities,
+		sizeof(typename whole_pool::mapped_type),
+		sizeof(typename split_pool::mapped_type),
+		whole_result.first,
+		split_result.first
+	);
+}
+
+#if BUILD_TEST_SCENES
+#include "test_scenes/test_scene_fixture.h"
+
+INTERNAL_BENCHMARK("StateTest4 IncrementalSolvableTransfer") {
+	const auto referential = make_test_scene_cosmos();
+	auto& referential_cosm = *referential;
+
+	cosmos full = referential_cosm;
+	cosmos incremental = referential_cosm;
+
+	const int num_trials = 50;
+
+	double full_ms = 0.0;
+	double incremental_ms = 0.0;
+	std::size_t num_written_entities = 0;
+
+	for (int i = 0; i < num_trials; ++i) {
+		advance_test_scene(referential_cosm, 1);
+		advance_test_scene(full, 2);
+		advance_test_scene(incremental, 2);
+
+		{
+			augs::timer t;
+			full.assign_solvable(referential_cosm);
+			full_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+			num_written_entities += incremental.assign_solvable_changes(referential_cosm).num_written_entities;
+			incremental_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG(
+		"Solvable transfer of %x entities. Full: %x ms, incremental: %x ms (avg. %x entities written).",
+		referential_cosm.get_entities_count(),
+		full_ms / num_trials,
+		incremental_ms / num_trials,
+		num_written_entities / num_trials
+	);
+}
+
 #endif
 #endif
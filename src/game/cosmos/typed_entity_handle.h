@@ -3,6 +3,7 @@
 
 #include "augs/templates/folded_finders.h"
 #include "augs/templates/for_each_std_get.h"
+#include "augs/templates/for_each_type.h"
 
 #include "game/cosmos/component_synchronizer.h"
 #include "game/cosmos/entity_pools.h"
@@ -12,6 +13,7 @@
 #include "game/cosmos/entity_solvable.h"
 #include "game/cosmos/cosmos_solvable_access.h"
 #include "game/cosmos/entity_type_traits.h"
+#include "game/cosmos/get_corresponding.h"
 
 #include "game/detail/entity_handle_mixins/all_handle_mixins.h"
 #include "game/common_state/entity_flavours.h"
@@ -274,7 +276,12 @@ private:
 
 	template <class T>
 	maybe_const_ptr_t<is_const, T> find_component_ptr() const {
-		if constexpr(subject_type::template has<T>()) {
+		if constexpr(is_split_component_v<entity_type, T>) {
+			ensure_alive();
+
+			return std::addressof(::get_corresponding<augs::pool_column<T>>(*this).value);
+		}
+		else if constexpr(subject_type::template has<T>()) {
 			ensure_alive();
 
 			return std::addressof(get_subject().template get<T>());
@@ -309,6 +316,23 @@ public:
 		return has_all_of_v<entity_type, T>;
 	}
 
+	/* 
+		Direct reference to the component state, wherever the pool keeps it.
+		Unlike get, never wraps the component in a synchronizer.
+	*/
+
+	template <class T>
+	auto& get_raw_component(cosmos_solvable_access) const {
+		static_assert(has<T>());
+		return *find_component_ptr<T>();
+	}
+
+	template <class T>
+	const auto& get_raw_component() const {
+		static_assert(has<T>());
+		return *find_component_ptr<T>();
+	}
+
 	template<class T>
 	decltype(auto) find() const {
 		if constexpr(is_invariant_v<T>) {
@@ -423,7 +447,17 @@ public:
 
 		for_each_through_std_get(
 			immutable_subject.component_state, 
-			std::forward<F>(callback)
+			callback
+		);
+
+		/* Iterate pointers to avoid constructing the components. */
+		using split_pointers = transform_types_in_list_t<split_components_of<entity_type>, std::add_pointer_t>;
+
+		for_each_type_in_list<split_pointers>(
+			[&](const auto c) {
+				using C = std::remove_pointer_t<decltype(c)>;
+				callback(get_raw_component<C>());
+			}
 		);
 	}
 
@@ -4,3 +4,21 @@ debug_drawing_settings DEBUG_DRAWING;
 std::vector<debug_line> DEBUG_LOGIC_STEP_LINES;
 std::vector<debug_line> DEBUG_PERSISTENT_LINES;
 std::vector<debug_line> DEBUG_FRAME_LINES;
+
+static thread_local std::vector<debug_line>* logic_step_lines_target = nullptr;
+
+std::vector<debug_line>& get_logic_step_lines() {
+	if (logic_step_lines_target != nullptr) {
+		return *logic_step_lines_target;
+	}
+
+	return DEBUG_LOGIC_STEP_LINES;
+}
+
+scoped_logic_step_lines::scoped_logic_step_lines(std::vector<debug_line>& target) : previous(logic_step_lines_target) {
+	logic_step_lines_target = &target;
+}
+
+scoped_logic_step_lines::~scoped_logic_step_lines() {
+	logic_step_lines_target = previous;
+}
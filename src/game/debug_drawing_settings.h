@@ -49,3 +49,23 @@ extern debug_drawing_settings DEBUG_DRAWING;
 extern std::vector<debug_line> DEBUG_LOGIC_STEP_LINES;
 extern std::vector<debug_line> DEBUG_PERSISTENT_LINES;
 extern std::vector<debug_line> DEBUG_FRAME_LINES;
+
+/*
+	Logic writes its step lines through get_logic_step_lines().
+	Passes that run on a thread pool are each given a buffer of their own with scoped_logic_step_lines,
+	which the solver appends to the lines of the calling thread in a fixed order once they complete.
+	Outside of such a scope, get_logic_step_lines() is simply DEBUG_LOGIC_STEP_LINES.
+*/
+
+std::vector<debug_line>& get_logic_step_lines();
+
+class scoped_logic_step_lines {
+	std::vector<debug_line>* const previous;
+
+public:
+	scoped_logic_step_lines(std::vector<debug_line>& target);
+	~scoped_logic_step_lines();
+
+	scoped_logic_step_lines(const scoped_logic_step_lines&) = delete;
+	scoped_logic_step_lines& operator=(const scoped_logic_step_lines&) = delete;
+};
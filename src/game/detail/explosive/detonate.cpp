@@ -33,7 +33,7 @@ void detonate(const detonate_input in, const bool destroy_subject) {
 
 	const auto subject = cosm[in.subject];
 
-	e.explosion.instantiate(step, in.location, damage_cause(subject));
+	e.explosion.instantiate(step, in.location, damage_cause(subject), always_predictable_v, in.precalculated_visibility);
 
 	if (destroy_subject) {
 		step.queue_deletion_of(subject, "Detonation");
@@ -117,3 +117,135 @@ void detonate_if(const entity_id& id, const transformr& where, const logic_step&
 		});
 	});
 }
+
+#if BUILD_UNIT_TESTS && BUILD_TEST_SCENES
+#include <Catch/single_include/catch2/catch.hpp>
+#include "augs/templates/thread_pool.h"
+#include "augs/readwrite/to_bytes.h"
+#include "game/stateless_systems/visibility_system.h"
+#include "test_scenes/test_scene_fixture.h"
+#include "test_scenes/create_test_scene_entity.h"
+#include "game/components/hand_fuse_component.h"
+#include "game/detail/explosive/precalculated_explosion_visibility.h"
+#include "game/detail/damage_origin.h"
+#include "game/debug_drawing_settings.h"
+
+TEST_CASE("Detonate PrecalculatedExplosionVisibility") {
+	const auto scene = make_test_scene_cosmos();
+
+	auto& serial_cosm = *scene;
+
+	/* Grenades that go off together at the first step, leaving cascades that explode in later steps. */
+
+	const auto grenades = {
+		test_hand_explosives::FORCE_GRENADE,
+		test_hand_explosives::PED_GRENADE,
+		test_hand_explosives::INTERFERENCE_GRENADE
+	};
+
+	std::vector<visibility_request> requests;
+	int column = 0;
+
+	for (const auto flavour : grenades) {
+		for (int row = 0; row < 3; ++row) {
+			const auto grenade = create_test_scene_entity(serial_cosm, flavour, vec2(column * 200.f, row * 200.f));
+
+			auto& fuse = grenade.template get<components::hand_fuse>();
+			fuse.when_armed = serial_cosm.get_clock().now;
+			fuse.fuse_delay_ms = 0.f;
+
+			const auto& explosive = grenade.template get<invariants::explosive>();
+			requests.push_back(explosive.explosion.make_visibility_request(grenade.get_logic_transform(), damage_cause(grenade)));
+		}
+
+		++column;
+	}
+
+	auto pool = augs::thread_pool(3);
+
+	{
+		auto precalculated = precalculated_explosion_visibility();
+
+		for (const auto& r : requests) {
+			precalculated.expect(r);
+		}
+
+		precalculated.calculate(serial_cosm, std::addressof(pool));
+
+		for (const auto& r : requests) {
+			visibility_response serial_response;
+			visibility_system(DEBUG_LOGIC_STEP_LINES).calc_visibility(serial_cosm, r, serial_response);
+
+			const auto found = precalculated.find(r);
+
+			REQUIRE(found != nullptr);
+			REQUIRE(found->edges == serial_response.edges);
+		}
+
+		auto unexpected = requests[0];
+		unexpected.eye_transform.pos.x += 1.f;
+
+		REQUIRE(precalculated.find(unexpected) == nullptr);
+	}
+
+	{
+		/* Rays drawn by the jobs end up in the logic step lines, in the order of requests. */
+
+		const auto previous_drawing = DEBUG_DRAWING;
+		DEBUG_DRAWING.draw_cast_rays = true;
+
+		std::vector<debug_line> serial_lines;
+
+		for (const auto& r : requests) {
+			visibility_response serial_response;
+			visibility_system(serial_lines).calc_visibility(serial_cosm, r, serial_response);
+		}
+
+		std::vector<debug_line> parallel_lines;
+
+		{
+			auto redirect = scoped_logic_step_lines(parallel_lines);
+			auto precalculated = precalculated_explosion_visibility();
+
+			for (const auto& r : requests) {
+				precalculated.expect(r);
+			}
+
+			precalculated.calculate(serial_cosm, std::addressof(pool));
+		}
+
+		DEBUG_DRAWING = previous_drawing;
+
+		REQUIRE(serial_lines.size() > 0);
+		REQUIRE(parallel_lines.size() == serial_lines.size());
+
+		for (std::size_t i = 0; i < serial_lines.size(); ++i) {
+			REQUIRE(parallel_lines[i].a == serial_lines[i].a);
+			REQUIRE(parallel_lines[i].b == serial_lines[i].b);
+			REQUIRE(parallel_lines[i].col == serial_lines[i].col);
+		}
+	}
+
+	/* The whole step must stay identical to the serial solver, including the order of side effects of explosions. */
+
+	cosmos parallel = serial_cosm;
+
+	auto parallel_settings = solve_settings();
+	parallel_settings.pool = std::addressof(pool);
+
+	for (int i = 0; i < 90; ++i) {
+		advance_test_scene(serial_cosm, 1);
+		advance_test_scene(parallel, 1, parallel_settings);
+
+		REQUIRE(
+			serial_cosm.calculate_solvable_signi_hash<uint32_t>(true)
+			== parallel.calculate_solvable_signi_hash<uint32_t>(true)
+		);
+	}
+
+	REQUIRE(
+		augs::to_bytes(serial_cosm.get_solvable().significant)
+		== augs::to_bytes(parallel.get_solvable().significant)
+	);
+}
+#endif
@@ -9,23 +9,31 @@ namespace invariants {
 }
 
 class cosmos;
+class precalculated_explosion_visibility;
 
 struct detonate_input {
 	const logic_step& step;
 	const entity_id& subject;
 	const invariants::explosive& explosive;
 	const transformr location;
+
+	/* If set, the explosion uses its visibility from here if it was expected. */
+	const precalculated_explosion_visibility* const precalculated_visibility = nullptr;
 };
 
 void detonate(detonate_input, bool destroy_subject = true);
 
 template <class E>
-void detonate_if(const E& handle, const logic_step& step) {
+void detonate_if(
+	const E& handle, 
+	const logic_step& step, 
+	const precalculated_explosion_visibility* const precalculated_visibility = nullptr
+) {
 	if constexpr(E::template has<invariants::explosive>()) {
 		const auto& explosive = handle.template get<invariants::explosive>();
 
 		detonate({
-			step, handle.get_id(), explosive, handle.get_logic_transform()
+			step, handle.get_id(), explosive, handle.get_logic_transform(), precalculated_visibility
 		});
 	}
 }
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "augs/graphics/debug_line.h"
+#include "game/messages/visibility_information.h"
+
+class cosmos;
+
+namespace augs {
+	class thread_pool;
+}
+
+/*
+	Visibility of explosions expected in this step, calculated ahead of time.
+
+	A system first tells which explosions it expects and calculates all of them at once,
+	in parallel if a pool is given. It then instantiates its explosions one by one,
+	in the same order and with the same side effects as without precalculation.
+	Each explosion only looks up a response to an identical request,
+	and calculates its own if none was expected.
+
+	Explosions only query walls, which instantiating an explosion never moves,
+	so a response calculated ahead is the same as one calculated right before instantiation.
+
+	Every job draws its cast rays into a buffer of its own.
+	The buffers are appended to the logic step lines in the order of requests once all jobs complete.
+*/
+
+class precalculated_explosion_visibility {
+	using request_type = messages::visibility_information_request;
+	using response_type = messages::visibility_information_response;
+
+	std::vector<request_type> requests;
+	std::vector<response_type> responses;
+	std::vector<std::vector<debug_line>> lines_per_request;
+
+public:
+	void clear();
+	void expect(const request_type&);
+	void calculate(const cosmos&, augs::thread_pool*);
+
+	const response_type* find(const request_type&) const;
+};
@@ -5,6 +5,20 @@
 #include "game/detail/physics/physics_scripts.h"
 #include "game/enums/filters.h"
 
+static thread_local std::size_t num_raycasts_on_this_thread = 0;
+
+std::size_t physics_world_cache::get_num_raycasts_on_this_thread() {
+	return num_raycasts_on_this_thread;
+}
+
+static bool should_raycast(const entity_id subject, const b2Filter& subject_filter, const b2Fixture& fixture) {
+	const auto fixture_entity = fixture.GetBody()->GetUserData();
+
+	return
+		(subject == entity_id() || fixture_entity != FixtureUserdata(subject)) &&
+		(b2ContactFilter::ShouldCollide(&subject_filter, &fixture.GetFilterData()));
+}
+
 struct raycast_input : public b2RayCastCallback {
 	entity_id subject;
 	b2Filter subject_filter;
@@ -18,10 +32,7 @@ struct raycast_input : public b2RayCastCallback {
 };
 
 bool raycast_input::ShouldRaycast(b2Fixture* const fixture) {
-	const auto fixture_entity = fixture->GetBody()->GetUserData();
-	return
-		(subject == entity_id() || fixture_entity != FixtureUserdata(subject)) &&
-		(b2ContactFilter::ShouldCollide(&subject_filter, &fixture->GetFilterData()));
+	return should_raycast(subject, subject_filter, *fixture);
 }
 
 float32 raycast_input::ReportFixture(
@@ -61,10 +72,213 @@ std::vector<physics_raycast_output> physics_world_cache::ray_cast_all_intersecti
 		return callback.outputs;
 	}
 
+	++num_raycasts_on_this_thread;
+
 	b2world->RayCast(&callback, b2Vec2(p1_meters), b2Vec2(p2_meters));
 	return callback.outputs;
 }
 
+/*
+	A single ray of a group, prepared the same way b2DynamicTree::RayCast prepares it.
+*/
+
+struct grouped_ray {
+	std::size_t index = 0;
+
+	b2Vec2 p1;
+	b2Vec2 p2;
+
+	/* Perpendicular to the segment. */
+	b2Vec2 v;
+	b2Vec2 abs_v;
+
+	b2AABB segment_aabb;
+};
+
+static constexpr std::size_t max_rays_in_group = 32;
+
+struct grouped_raycast_callback {
+	const b2BroadPhase& broad_phase;
+	const std::vector<physics_ray>& rays;
+
+	const grouped_ray* group;
+	std::size_t group_size;
+
+	std::vector<std::pair<std::size_t, physics_raycast_output>>& group_hits;
+
+	bool QueryCallback(const int32 proxy_id) {
+		/*
+			Whatever b2DynamicTree::RayCast would prune at an inner node,
+			it would also prune at every leaf below it,
+			so testing the leaves alone gives the same hits in the same order.
+		*/
+
+		const auto& aabb = broad_phase.GetFatAABB(proxy_id);
+
+		const auto c = aabb.GetCenter();
+		const auto h = aabb.GetExtents();
+
+		const auto proxy = static_cast<const b2FixtureProxy*>(broad_phase.GetUserData(proxy_id));
+		const auto& fixture = *proxy->fixture;
+
+		for (std::size_t i = 0; i < group_size; ++i) {
+			const auto& r = group[i];
+
+			if (b2TestOverlap(aabb, r.segment_aabb) == false) {
+				continue;
+			}
+
+			const auto separation = b2Abs(b2Dot(r.v, r.p1 - c)) - b2Dot(r.abs_v, h);
+
+			if (separation > 0.0f) {
+				continue;
+			}
+
+			const auto& ray = rays[r.index];
+
+			if (!should_raycast(ray.ignore_entity, ray.filter, fixture)) {
+				continue;
+			}
+
+			b2RayCastInput input;
+			input.p1 = r.p1;
+			input.p2 = r.p2;
+			input.maxFraction = 1.0f;
+
+			b2RayCastOutput output;
+
+			if (fixture.RayCast(&output, input, proxy->childIndex)) {
+				const auto fraction = output.fraction;
+
+				physics_raycast_output hit;
+
+				hit.intersection = (1.0f - fraction) * input.p1 + fraction * input.p2;
+				hit.hit = true;
+				hit.what_entity = fixture.GetBody()->GetUserData();
+				hit.what_fixture = const_cast<b2Fixture*>(std::addressof(fixture));
+				hit.normal = output.normal;
+
+				group_hits.emplace_back(i, hit);
+			}
+		}
+
+		return true;
+	}
+};
+
+void physics_world_cache::ray_cast_all_intersections(
+	const std::vector<physics_ray>& rays,
+	physics_raycast_batch& output
+) const {
+	output.clear();
+	output.ranges.resize(rays.size());
+
+	const auto& broad_phase = b2world->GetContactManager().m_broadPhase;
+
+	std::array<grouped_ray, max_rays_in_group> group;
+	std::size_t group_size = 0;
+
+	b2AABB group_aabb;
+	float group_perimeters = 0.f;
+
+	auto cast_group = [&]() {
+		if (group_size == 0) {
+			return;
+		}
+
+		output.group_hits.clear();
+
+		grouped_raycast_callback callback {
+			broad_phase,
+			rays,
+			group.data(),
+			group_size,
+			output.group_hits
+		};
+
+		broad_phase.Query(&callback, group_aabb);
+
+		/* Order the hits by ray, keeping the order of traversal for each ray. */
+
+		std::array<std::size_t, max_rays_in_group + 1> offsets {};
+
+		for (const auto& h : output.group_hits) {
+			++offsets[h.first + 1];
+		}
+
+		for (std::size_t i = 0; i < group_size; ++i) {
+			offsets[i + 1] += offsets[i];
+		}
+
+		const auto base = output.hits.size();
+
+		for (std::size_t i = 0; i < group_size; ++i) {
+			output.ranges[group[i].index] = { base + offsets[i], base + offsets[i + 1] };
+		}
+
+		output.hits.resize(base + output.group_hits.size());
+
+		for (const auto& h : output.group_hits) {
+			output.hits[base + offsets[h.first]++] = h.second;
+		}
+
+		num_raycasts_on_this_thread += group_size;
+		group_size = 0;
+	};
+
+	for (std::size_t i = 0; i < rays.size(); ++i) {
+		const auto& ray = rays[i];
+
+		if (!((ray.from_meters - ray.to_meters).length_sq() > 0.f)) {
+			output.ranges[i] = { output.hits.size(), output.hits.size() };
+			continue;
+		}
+
+		grouped_ray r;
+
+		r.index = i;
+		r.p1 = b2Vec2(ray.from_meters);
+		r.p2 = b2Vec2(ray.to_meters);
+
+		auto dir = r.p2 - r.p1;
+		dir.Normalize();
+
+		r.v = b2Cross(1.0f, dir);
+		r.abs_v = b2Abs(r.v);
+
+		r.segment_aabb.lowerBound = b2Min(r.p1, r.p2);
+		r.segment_aabb.upperBound = b2Max(r.p1, r.p2);
+
+		const auto perimeter = r.segment_aabb.GetPerimeter();
+
+		if (group_size > 0) {
+			/* Only rays close enough to each other are worth traversing together. */
+
+			b2AABB merged;
+			merged.Combine(group_aabb, r.segment_aabb);
+
+			const bool coherent = merged.GetPerimeter() <= group_perimeters + perimeter;
+
+			if (!coherent || group_size == max_rays_in_group) {
+				cast_group();
+			}
+			else {
+				group_aabb = merged;
+			}
+		}
+
+		if (group_size == 0) {
+			group_aabb = r.segment_aabb;
+			group_perimeters = 0.f;
+		}
+
+		group[group_size++] = r;
+		group_perimeters += perimeter;
+	}
+
+	cast_group();
+}
+
 float physics_world_cache::get_closest_wall_intersection(
 	const si_scaling si,
 	const vec2 position, 
@@ -143,6 +357,8 @@ physics_raycast_output physics_world_cache::ray_cast(const vec2 p1_meters, const
 		return callback.output;
 	}
 
+	++num_raycasts_on_this_thread;
+
 	b2world->RayCast(&callback, b2Vec2(p1_meters), b2Vec2(p2_meters));
 	return callback.output;
 }
@@ -159,9 +159,9 @@ auto circular_sector_overlaps_entity(
 	v[4] = b2Vec2(right_edge_off);
 
 #if 0
-	debug_draw_verts(DEBUG_LOGIC_STEP_LINES, white, v, shape_pos);
-	debug_draw_verts(DEBUG_LOGIC_STEP_LINES, cyan, tangent, shape_pos);
-	debug_draw_verts(DEBUG_LOGIC_STEP_LINES, red, vec2::segment_type{ vec2::zero, sector_tip }, shape_pos);
+	debug_draw_verts(get_logic_step_lines(), white, v, shape_pos);
+	debug_draw_verts(get_logic_step_lines(), cyan, tangent, shape_pos);
+	debug_draw_verts(get_logic_step_lines(), red, vec2::segment_type{ vec2::zero, sector_tip }, shape_pos);
 #endif
 
 	const auto shape = to_polygon_shape(v, si);
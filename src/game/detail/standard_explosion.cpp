@@ -1,6 +1,7 @@
 #include "augs/misc/randomization.h"
 #include "game/detail/physics/physics_queries.h"
 #include "game/detail/standard_explosion.h"
+#include "game/detail/explosive/precalculated_explosion_visibility.h"
 #include "game/assets/ids/asset_ids.h"
 #include "game/cosmos/cosmos.h"
 #include "game/cosmos/entity_handle.h"
@@ -21,6 +22,7 @@
 #include "game/detail/damage_origin.hpp"
 #include "game/detail/movement/dash_logic.h"
 #include "game/detail/sentience/sentience_logic.h"
+#include "augs/templates/thread_pool.h"
 
 static bool triangle_degenerate(const std::array<vec2, 3>& v) {
 	constexpr auto eps_triangle_degenerate = 0.5f;
@@ -40,11 +42,119 @@ static bool triangle_degenerate(const std::array<vec2, 3>& v) {
 	return false;
 }
 
+visibility_request standard_explosion_input::make_visibility_request(
+	const transformr explosion_location,
+	const damage_cause cause
+) const {
+	visibility_request request;
+	request.eye_transform = explosion_location;
+	request.filter = predefined_queries::pathfinding();
+	request.queried_rect = vec2::square(effective_radius * 2);
+	request.subject = cause.entity;
+
+	return request;
+}
+
+void precalculated_explosion_visibility::clear() {
+	requests.clear();
+}
+
+void precalculated_explosion_visibility::expect(const request_type& request) {
+	requests.push_back(request);
+}
+
+void precalculated_explosion_visibility::calculate(const cosmos& cosm, augs::thread_pool* const pool) {
+	const auto n = requests.size();
+
+	if (responses.size() < n) {
+		responses.resize(n);
+	}
+
+	const bool parallel = pool != nullptr && pool->size() > 0 && n > 1;
+
+	if (!parallel) {
+		for (std::size_t i = 0; i < n; ++i) {
+			visibility_system(get_logic_step_lines()).calc_visibility(cosm, requests[i], responses[i]);
+		}
+
+		return;
+	}
+
+	if (lines_per_request.size() < n) {
+		lines_per_request.resize(n);
+	}
+
+	for (std::size_t i = 0; i < n; ++i) {
+		auto& lines = lines_per_request[i];
+		lines.clear();
+
+		pool->enqueue([&cosm, &lines, &request = requests[i], &response = responses[i]]() {
+			visibility_system(lines).calc_visibility(cosm, request, response);
+		});
+	}
+
+	pool->submit();
+	pool->help_until_no_tasks();
+	pool->wait_for_all_tasks_to_complete();
+
+	auto& merged = get_logic_step_lines();
+
+	for (std::size_t i = 0; i < n; ++i) {
+		const auto& lines = lines_per_request[i];
+		merged.insert(merged.end(), lines.begin(), lines.end());
+	}
+}
+
+auto precalculated_explosion_visibility::find(const request_type& request) const -> const response_type* {
+	auto same = [](const request_type& a, const request_type& b) {
+		return
+			a.subject == b.subject
+			&& a.eye_transform.pos == b.eye_transform.pos
+			&& a.eye_transform.rotation == b.eye_transform.rotation
+			&& a.queried_rect == b.queried_rect
+			&& a.filter.categoryBits == b.filter.categoryBits
+			&& a.filter.maskBits == b.filter.maskBits
+			&& a.filter.groupIndex == b.filter.groupIndex
+		;
+	};
+
+	for (std::size_t i = 0; i < requests.size(); ++i) {
+		if (same(requests[i], request)) {
+			return std::addressof(responses[i]);
+		}
+	}
+
+	return nullptr;
+}
+
 void standard_explosion_input::instantiate(
 	const logic_step step,
 	const transformr explosion_location,
 	const damage_cause cause,
-	const predictability_info predictability
+	const predictability_info predictability,
+	const precalculated_explosion_visibility* const precalculated
+) const {
+	const auto request = make_visibility_request(explosion_location, cause);
+
+	if (precalculated != nullptr) {
+		if (const auto response = precalculated->find(request)) {
+			instantiate(step, explosion_location, cause, predictability, *response);
+			return;
+		}
+	}
+
+	auto& response = thread_local_visibility_response();
+	visibility_system(get_logic_step_lines()).calc_visibility(step.get_cosmos(), request, response);
+
+	instantiate(step, explosion_location, cause, predictability, response);
+}
+
+void standard_explosion_input::instantiate(
+	const logic_step step,
+	const transformr explosion_location,
+	const damage_cause cause,
+	const predictability_info predictability,
+	const visibility_response& response
 ) const {
 	const auto subject_if_any = cause.entity;
 
@@ -147,15 +257,6 @@ void standard_explosion_input::instantiate(
 		startle_nearby_organisms(cosm, explosion_pos, effective_radius * 1.8f, 60.f, startle_type::IMMEDIATE);
 	}
 
-	messages::visibility_information_request request;
-	request.eye_transform = explosion_location;
-	request.filter = predefined_queries::pathfinding();
-	request.queried_rect = vec2::square(effective_radius * 2);
-	request.subject = subject_if_any;
-
-	auto& response = thread_local_visibility_response();
-	visibility_system(DEBUG_LOGIC_STEP_LINES).calc_visibility(cosm, request, response);
-
 	if (response.empty()) {
 		return;
 	}
@@ -165,7 +266,7 @@ void standard_explosion_input::instantiate(
 	std::unordered_set<unversioned_entity_id> affected_entities_of_bodies;
 
 	for (auto i = 0u; i < response.get_num_triangles(); ++i) {
-		auto damaging_triangle = response.get_world_triangle(i, request.eye_transform.pos);
+		auto damaging_triangle = response.get_world_triangle(i, explosion_pos);
 		damaging_triangle[1] += (damaging_triangle[1] - damaging_triangle[0]).set_length(5);
 		damaging_triangle[2] += (damaging_triangle[2] - damaging_triangle[0]).set_length(5);
 
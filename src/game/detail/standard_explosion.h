@@ -15,6 +15,12 @@
 #include "game/detail/view_input/predictability_info.h"
 
 struct damage_cause;
+class precalculated_explosion_visibility;
+
+namespace messages {
+	struct visibility_information_request;
+	struct visibility_information_response;
+}
 
 struct standard_explosion_input {
 	// GEN INTROSPECTOR struct standard_explosion_input
@@ -48,10 +54,25 @@ struct standard_explosion_input {
 		return *this;
 	}
 
+	messages::visibility_information_request make_visibility_request(
+		transformr explosion_location, 
+		damage_cause cause
+	) const;
+
+	void instantiate(
+		logic_step step, 
+		transformr explosion_location, 
+		damage_cause cause,
+		predictability_info info = always_predictable_v,
+		const precalculated_explosion_visibility* precalculated = nullptr
+	) const;
+
+	/* Uses an already calculated response to make_visibility_request. */
 	void instantiate(
 		logic_step step, 
 		transformr explosion_location, 
 		damage_cause cause,
-		predictability_info info = always_predictable_v
+		predictability_info info,
+		const messages::visibility_information_response& visibility
 	) const;
 };
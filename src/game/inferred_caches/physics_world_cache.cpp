@@ -202,9 +202,20 @@ physics_world_cache::physics_world_cache(const physics_world_cache&) : physics_w
 }
 
 physics_world_cache& physics_world_cache::operator=(const physics_world_cache&) {
+	stepped_since_sync = true;
 	return *this;
 }
 
+bool physics_world_cache::has_awake_bodies() const {
+	for (const b2Body* b = b2world->GetBodyList(); b != nullptr; b = b->GetNext()) {
+		if (b->GetType() != b2_staticBody && b->IsAwake()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void physics_world_cache::clone_from(const physics_world_cache& source_cache, cosmos& target_cosm, const cosmos& source_cosm) {
 	ensure(std::addressof(target_cosm) != std::addressof(source_cosm));
 	ensure(this != std::addressof(source_cache));
@@ -259,6 +270,22 @@ void physics_world_cache::clone_from(const physics_world_cache& source_cache, co
 	std::unordered_map<const void*, bool> contact_edge_a_or_b_in_contacts;
 	std::unordered_map<const void*, bool> joint_edge_a_or_b_in_joints;
 
+	{
+		/*
+			Presize the maps to avoid rehashing in the middle of the migration.
+			Every fixture owns exactly one array of proxies, hence the proxy count is doubled.
+		*/
+
+		const auto num_bodies = static_cast<std::size_t>(source_b2World.GetBodyCount());
+		const auto num_joints = static_cast<std::size_t>(source_b2World.GetJointCount());
+		const auto num_contacts = static_cast<std::size_t>(source_b2World.GetContactCount());
+		const auto num_proxies = static_cast<std::size_t>(source_b2World.GetProxyCount());
+
+		pointer_migrations.reserve(num_bodies + num_joints + num_contacts + num_proxies * 2);
+		contact_edge_a_or_b_in_contacts.reserve(num_contacts * 2);
+		joint_edge_a_or_b_in_joints.reserve(num_joints * 2);
+	}
+
 	b2BlockAllocator& migrated_allocator = migrated_b2World.m_blockAllocator;
 
 	const auto contact_edge_a_offset = augs_offsetof(b2Contact, m_nodeA);
@@ -40,6 +40,43 @@ struct physics_raycast_output {
 	bool hit = false;
 };
 
+struct physics_ray {
+	vec2 from_meters;
+	vec2 to_meters;
+	b2Filter filter;
+	entity_id ignore_entity;
+};
+
+/*
+	Hits of a batch of rays, in the same order as ray_cast_all_intersections would return them.
+	Meant to be kept for longer than a single batch, so that the buffers are only ever allocated once.
+*/
+
+struct physics_raycast_batch {
+	std::vector<physics_raycast_output> hits;
+
+	/* Begin and end of the hits of each ray, in order of the rays. */
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+
+	/* Hits of a single group of rays before they are ordered by ray. */
+	std::vector<std::pair<std::size_t, physics_raycast_output>> group_hits;
+
+	void clear() {
+		hits.clear();
+		ranges.clear();
+		group_hits.clear();
+	}
+
+	template <class F>
+	void for_each_hit_of(const std::size_t ray_index, F&& callback) const {
+		const auto range = ranges[ray_index];
+
+		for (auto i = range.first; i < range.second; ++i) {
+			callback(hits[i]);
+		}
+	}
+};
+
 class physics_world_cache {
 	friend rigid_body_cache;
 	friend colliders_cache;
@@ -66,6 +103,13 @@ public:
 
 	std::vector<messages::collision_message> accumulated_messages;
 
+	/*
+		Whether a step moved anything since cosmos::assign_solvable_changes last synced this world.
+		Set for new and copied caches too, as their b2World is unrelated to any other one.
+	*/
+
+	bool stepped_since_sync = true;
+
 	physics_world_cache();
 	~physics_world_cache();
 
@@ -77,6 +121,8 @@ public:
 
 	void clone_from(const physics_world_cache& source_world, cosmos& target_cosmos, const cosmos& source_cosmos);
 
+	bool has_awake_bodies() const;
+
 	std::vector<physics_raycast_output> ray_cast_all_intersections(
 		const vec2 p1_meters,
 		const vec2 p2_meters, 
@@ -84,6 +130,16 @@ public:
 		const entity_id ignore_entity = entity_id()
 	) const;
 
+	/*
+		Casts many rays at once.
+		Consecutive rays that lie close to each other traverse the broadphase tree together.
+	*/
+
+	void ray_cast_all_intersections(
+		const std::vector<physics_ray>& rays,
+		physics_raycast_batch& output
+	) const;
+
 	physics_raycast_output ray_cast(
 		const vec2 p1_meters, 
 		const vec2 p2_meters, 
@@ -91,6 +147,9 @@ public:
 		const entity_id ignore_entity = entity_id()
 	) const;
 
+	/* Counts rays of all the above queries. */
+	static std::size_t get_num_raycasts_on_this_thread();
+
 	physics_raycast_output ray_cast_px(
 		const si_scaling si,
 		const vec2 p1, 
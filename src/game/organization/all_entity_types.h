@@ -47,6 +47,13 @@ struct controlled_character {
 		components::head
 	>;
 
+	/* Physics and sentience passes touch every character each step. */
+
+	using split_components = type_list<
+		components::rigid_body,
+		components::sentience
+	>;
+
 	using synchronized_arrays = type_list<
 		components::interpolation,
 		items_of_slots_cache,
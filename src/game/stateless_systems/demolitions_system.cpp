@@ -10,6 +10,7 @@
 
 #include "game/detail/hand_fuse_logic.h"
 #include "game/detail/standard_explosion.h"
+#include "game/detail/explosive/precalculated_explosion_visibility.h"
 
 #include "game/detail/hand_fuse_math.h"
 
@@ -19,11 +20,60 @@
 #include "game/detail/explosive/detonate.h"
 #include "game/detail/entity_handle_mixins/inventory_mixin.hpp"
 #include "augs/misc/randomization.h"
+#include "augs/templates/thread_pool.h"
 
-void demolitions_system::detonate_fuses(const logic_step step) {
+static bool worth_precalculating(const augs::thread_pool* const pool) {
+	return pool != nullptr && pool->size() > 0;
+}
+
+struct cascade_explosion_rolls {
+	real32 next_explosion_in_ms = 0.f;
+	real32 angle_displacement = 0.f;
+	real32 explosion_scale = 1.f;
+};
+
+template <class E>
+static auto roll_cascade_explosion(const E& it) {
+	const auto& cascade_def = it.template get<invariants::cascade_explosion>();
+	auto rng = it.get_cosmos().get_nontemporal_rng_for(it);
+
+	cascade_explosion_rolls rolls;
+
+	rolls.next_explosion_in_ms = rng.randval(cascade_def.explosion_interval_ms);
+	rolls.angle_displacement = rng.randval_h(cascade_def.max_explosion_angle_displacement);
+	rolls.explosion_scale = rng.randval_vm(1.f, cascade_def.explosion_scale_variation);
+
+	return rolls;
+}
+
+void demolitions_system::detonate_fuses(const logic_step step, augs::thread_pool* const pool) {
 	auto& cosm = step.get_cosmos();
 	const auto& clk = cosm.get_clock();
 
+	thread_local precalculated_explosion_visibility precalculated;
+	precalculated.clear();
+
+	const bool precalculate = worth_precalculating(pool);
+
+	if (precalculate) {
+		cosm.for_each_having<components::hand_fuse>(
+			[&](const auto& it) {
+				using E = remove_cref<decltype(it)>;
+
+				if constexpr(E::template has<invariants::explosive>()) {
+					const auto& fuse = it.template get<components::hand_fuse>();
+					const auto& explosive = it.template get<invariants::explosive>();
+
+					if (explosive.is_set() && fuse.armed() && clk.is_ready(fuse.fuse_delay_ms, fuse.when_armed)) {
+						precalculated.expect(explosive.explosion.make_visibility_request(it.get_logic_transform(), damage_cause(it)));
+					}
+				}
+			}
+		);
+
+		precalculated.calculate(cosm, pool);
+	}
+
 	cosm.for_each_having<components::hand_fuse>(
 		[&](const auto& it) {
 			const auto fuse_logic = fuse_logic_provider(it, step);
@@ -58,17 +108,40 @@ void demolitions_system::detonate_fuses(const logic_step step) {
 				const auto when_armed = fuse.when_armed;
 
 				if (clk.is_ready(fuse.fuse_delay_ms, when_armed)) {
-					detonate_if(it, step);
+					detonate_if(it, step, precalculate ? std::addressof(precalculated) : nullptr);
 				}
 			}
 		}
 	);
 }
 
-void demolitions_system::advance_cascade_explosions(const logic_step step) {
+void demolitions_system::advance_cascade_explosions(const logic_step step, augs::thread_pool* const pool) {
 	auto& cosm = step.get_cosmos();
 	const auto& clk = cosm.get_clock();
 
+	thread_local precalculated_explosion_visibility precalculated;
+	precalculated.clear();
+
+	const bool precalculate = worth_precalculating(pool);
+
+	if (precalculate) {
+		cosm.for_each_having<components::cascade_explosion>(
+			[&](const auto it) {
+				const auto& cascade_def = it.template get<invariants::cascade_explosion>();
+				const auto& cascade = it.template get<components::cascade_explosion>();
+
+				if (clk.now >= cascade.when_next_explosion) {
+					auto expl_in = cascade_def.explosion;
+					expl_in *= roll_cascade_explosion(it).explosion_scale;
+
+					precalculated.expect(expl_in.make_visibility_request(it.get_logic_transform(), damage_cause(it)));
+				}
+			}
+		);
+
+		precalculated.calculate(cosm, pool);
+	}
+
 	cosm.for_each_having<components::cascade_explosion>(
 		[&](const auto it) {
 			const auto& cascade_def = it.template get<invariants::cascade_explosion>();
@@ -77,30 +150,30 @@ void demolitions_system::advance_cascade_explosions(const logic_step step) {
 			auto& when_next = cascade.when_next_explosion;
 
 			if (clk.now >= when_next) {
-				auto rng = cosm.get_nontemporal_rng_for(it);
+				const auto rolls = roll_cascade_explosion(it);
 
 				{
-					const auto next_explosion_in_ms = rng.randval(cascade_def.explosion_interval_ms);
 					when_next = clk.now;
-					when_next.step += next_explosion_in_ms / clk.dt.in_milliseconds();
+					when_next.step += rolls.next_explosion_in_ms / clk.dt.in_milliseconds();
 				}
 
 				{
-					const auto angle_displacement = rng.randval_h(cascade_def.max_explosion_angle_displacement);
 					const auto& body = it.template get<components::rigid_body>();
 
 					auto vel = body.get_velocity();
-					vel.rotate(angle_displacement, vec2());
+					vel.rotate(rolls.angle_displacement, vec2());
 					body.set_velocity(vel);
 				}
 
 				auto expl_in = cascade_def.explosion;
-				expl_in *= rng.randval_vm(1.f, cascade_def.explosion_scale_variation);
+				expl_in *= rolls.explosion_scale;
 
 				expl_in.instantiate(
 					step,
 					it.get_logic_transform(),
-					damage_cause(it)
+					damage_cause(it),
+					always_predictable_v,
+					precalculate ? std::addressof(precalculated) : nullptr
 				);
 
 				--cascade.explosions_left;
@@ -1,8 +1,13 @@
 #pragma once
 #include "game/cosmos/step_declaration.h"
 
+namespace augs {
+	class thread_pool;
+}
+
 class demolitions_system {
 public:
-	void detonate_fuses(const logic_step step);
-	void advance_cascade_explosions(const logic_step step);
+	/* If a pool is given, visibility of the expected explosions is calculated on it ahead of instantiating them. */
+	void detonate_fuses(const logic_step step, augs::thread_pool* pool = nullptr);
+	void advance_cascade_explosions(const logic_step step, augs::thread_pool* pool = nullptr);
 };
@@ -75,6 +75,55 @@ void missile_system::advance_penetrations(const logic_step step) {
 	thread_local std::vector<b2Fixture*> hits;
 	//const auto& delta = step.get_delta();
 
+	thread_local std::vector<physics_ray> rays;
+	thread_local physics_raycast_batch ray_hits;
+
+	const auto filter = filters[predefined_filter_type::PENETRATING_PROGRESS_QUERY];
+
+	auto find_penetrated_segment = [](const auto& it) -> std::optional<std::pair<vec2, vec2>> {
+		const auto& missile = it.template get<components::missile>();
+
+		if (!missile.during_penetration) {
+			return std::nullopt;
+		}
+
+		const auto maybe_tip = it.find_logical_tip();
+
+		if (!maybe_tip.has_value()) {
+			return std::nullopt;
+		}
+
+		if (*maybe_tip == missile.prev_tip_position) {
+			//LOG("SAME TIP");
+			return std::nullopt;
+		}
+
+		return std::pair(missile.prev_tip_position, *maybe_tip);
+	};
+
+	/* 
+		Cast the rays of all penetrating missiles at once, forward and backward for each.
+		Only walls and glass obstacles are queried, which nothing below alters.
+	*/
+
+	rays.clear();
+
+	cosm.for_each_having<components::missile>(
+		[&](const auto& it) {
+			if (const auto segment = find_penetrated_segment(it)) {
+				const auto p1_meters = si.get_meters(segment->first);
+				const auto p2_meters = si.get_meters(segment->second);
+
+				rays.push_back({ p1_meters, p2_meters, filter });
+				rays.push_back({ p2_meters, p1_meters, filter });
+			}
+		}
+	);
+
+	physics.ray_cast_all_intersections(rays, ray_hits);
+
+	std::size_t next_ray = 0;
+
 	cosm.for_each_having<components::missile>(
 		[&](const auto& it) {
 			auto& missile = it.template get<components::missile>();
@@ -118,26 +167,18 @@ void missile_system::advance_penetrations(const logic_step step) {
 			}
 #endif
 
-			if (!missile.during_penetration) {
-				return;
-			}
-
-			const auto maybe_tip = it.find_logical_tip();
+			const auto segment = find_penetrated_segment(it);
 
-			if (!maybe_tip.has_value()) {
+			if (!segment.has_value()) {
 				return;
 			}
 
-			const auto& tip = *maybe_tip;
-
-			if (tip == missile.prev_tip_position) {
-				//LOG("SAME TIP");
-				return;
-			}
+			const auto forward_ray = next_ray++;
+			const auto backward_ray = next_ray++;
 
-			const auto filter = filters[predefined_filter_type::PENETRATING_PROGRESS_QUERY];
+			const auto& tip = segment->second;
 
-			const auto p1 = missile.prev_tip_position;
+			const auto p1 = segment->first;
 			const auto p2 = tip;
 
 			const auto p1_meters = si.get_meters(p1);
@@ -179,14 +220,12 @@ void missile_system::advance_penetrations(const logic_step step) {
 					}
 				);
 
-				const auto results = physics.ray_cast_all_intersections(p1_meters, p2_meters, filter);
-
-				for (const auto& result : results) {
+				ray_hits.for_each_hit_of(forward_ray, [&](const auto& result) {
 					auto f = result.what_fixture;
 					f->penetrated_forward = true;
 					f->forward_point = b2Vec2(si.get_pixels(result.intersection));
 					hits.push_back(f);
-				}
+				});
 			}
 
 			/* Fill backward facing hits */
@@ -211,9 +250,7 @@ void missile_system::advance_penetrations(const logic_step step) {
 
 				bool saved_first = false;
 
-				const auto results = physics.ray_cast_all_intersections(p2_meters, p1_meters, filter);
-
-				for (const auto& result : results) {
+				ray_hits.for_each_hit_of(backward_ray, [&](const auto& result) {
 					auto f = result.what_fixture;
 					f->penetrated_backward = true;
 					f->backward_point = b2Vec2(si.get_pixels(result.intersection));
@@ -223,7 +260,7 @@ void missile_system::advance_penetrations(const logic_step step) {
 						saved_first = true;
 						missile.potential_exit = vec2(f->backward_point);
 					}
-				}
+				});
 
 				if (!saved_first) {
 					missile.potential_exit = tip;
@@ -68,7 +68,7 @@ void particles_existence_system::displace_streams(const logic_step step) const {
 
 			if (DEBUG_DRAWING.enabled) {
 				const auto tr = it.get_logic_transform();
-				DEBUG_LOGIC_STEP_LINES.emplace_back(white, tr.pos, tr.pos + state.current);
+				get_logic_step_lines().emplace_back(white, tr.pos, tr.pos + state.current);
 			}
 		}
 	);
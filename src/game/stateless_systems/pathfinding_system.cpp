@@ -60,7 +60,7 @@ void pathfinding_system::advance_pathfinding_sessions(const logic_step step) {
 	/* we'll need a reference to physics system for raycasting */
 	const physics_world_cache& physics = cosm.get_solvable_inferred().physics;
 
-	auto& lines = DEBUG_LOGIC_STEP_LINES;
+	auto& lines = get_logic_step_lines();
 
 	cosm.for_each_having<components::pathfinding>(
 		[&](const auto it) {
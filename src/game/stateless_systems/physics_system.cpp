@@ -33,12 +33,19 @@ void physics_system::step_and_set_new_transforms(const logic_step step) {
 		const int32 velocityIterations = 8;
 		const int32 positionIterations = 3;
 
+		/* A world with all bodies asleep stays exactly the same after a step. */
+		const bool was_awake = physics.has_awake_bodies();
+
 		physics.b2world->Step(
 			static_cast<float32>(delta.in_seconds()),
 			velocityIterations,
 			positionIterations
 		);
 
+		if (was_awake || physics.has_awake_bodies()) {
+			physics.stepped_since_sync = true;
+		}
+
 		post_and_clear_accumulated_collision_messages(step);
 	}
 
@@ -749,7 +749,7 @@ void sentience_system::cooldown_aimpunches(const logic_step step) const {
 void sentience_system::rotate_towards_crosshairs_and_driven_vehicles(const logic_step step) const {
 	auto debug_line_drawer = [](const rgba col, const vec2 a, const vec2 b){
 		if (DEBUG_DRAWING.draw_collinearization) {
-			DEBUG_LOGIC_STEP_LINES.emplace_back(col, a, b);
+			get_logic_step_lines().emplace_back(col, a, b);
 		}
 	};
 
@@ -894,25 +894,25 @@ void sentience_system::rotate_towards_crosshairs_and_driven_vehicles(const logic
 				const auto head_radius = subject.template get<invariants::sentience>().head_hitbox_radius;
 				const auto head_pos = head_transform->pos;
 
-				DEBUG_LOGIC_STEP_LINES.emplace_back(
+				get_logic_step_lines().emplace_back(
 					orange,
 					head_pos,
 					head_pos + vec2(0, head_radius)
 				);
 
-				DEBUG_LOGIC_STEP_LINES.emplace_back(
+				get_logic_step_lines().emplace_back(
 					orange,
 					head_pos,
 					head_pos + vec2(head_radius, 0)
 				);
 
-				DEBUG_LOGIC_STEP_LINES.emplace_back(
+				get_logic_step_lines().emplace_back(
 					orange,
 					head_pos,
 					head_pos + vec2(-head_radius, 0)
 				);
 
-				DEBUG_LOGIC_STEP_LINES.emplace_back(
+				get_logic_step_lines().emplace_back(
 					orange,
 					head_pos,
 					head_pos + vec2(0, -head_radius)
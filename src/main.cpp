@@ -3,6 +3,8 @@
 #include <mutex>
 
 #include "augs/log.h"
+#include "augs/log_async.h"
+#include "augs/misc/scope_guard.h"
 #include "augs/log_path_getters.h"
 #include "augs/filesystem/file.h"
 #include "augs/window_framework/shell.h"
@@ -176,6 +178,17 @@ int main(const int argc, const char* const * const argv) {
 		}
 	}
 
+	/*
+		From now on, LOG only queues the line,
+		so that many server instances logging at once do not stall on the console or the live log file.
+	*/
+
+	augs::start_async_log();
+
+	auto stop_async_log = augs::scope_guard([]() {
+		augs::stop_async_log();
+	});
+
 	/*
 		Now that the documents/logs folder exists,
 		and we have set the potential live log path,
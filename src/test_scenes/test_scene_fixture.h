@@ -0,0 +1,25 @@
+#pragma once
+#include <memory>
+
+#include "game/cosmos/cosmos.h"
+#include "game/cosmos/solvers/standard_solver.h"
+#include "test_scenes/test_scene_settings.h"
+
+/*
+	The world that unit tests and internal benchmarks of the simulation run on.
+	It is too large for the stack.
+
+	Defined next to intercosm::make_test_scene,
+	as intercosm.h must not be included after the I/O traits that many test files include first.
+*/
+
+std::unique_ptr<cosmos> make_test_scene_cosmos(test_scene_settings = test_scene_settings());
+
+/* Steps with no input, so that cosmoi copied from one another stay comparable. */
+
+inline void advance_test_scene(cosmos& cosm, const int steps, const solve_settings& settings = solve_settings()) {
+	for (int i = 0; i < steps; ++i) {
+		auto entropy = cosmic_entropy();
+		standard_solver()({ cosm, entropy, settings }, solver_callbacks());
+	}
+}
@@ -343,7 +343,7 @@ void particles_simulation_system::remove_dead_particles(const cosmos& cosm) {
 	};
 
 	for (auto& particle_layer : general_particles) {
-		dead_particles_remover(particle_layer);
+		particle_layer.remove_dead();
 	}
 
 	for (auto& particle_layer : animated_particles) {
@@ -399,57 +399,55 @@ void particles_simulation_system::integrate_and_draw_all_particles(const integra
 	auto generic_integrate = [&anims, delta](const particle_layer, auto& range, int, int from_i, const int till_i, auto&&... args) {
 		using P = typename remove_cref<decltype(range)>::value_type;
 
-		for (; from_i < till_i; ++from_i) {
-			auto& particle = range[from_i];
+		if constexpr(std::is_same_v<P, general_particle>) {
+			range.integrate(from_i, till_i, delta);
+		}
+		else {
+			for (; from_i < till_i; ++from_i) {
+				auto& particle = range[from_i];
 
-			if constexpr(std::is_same_v<P, general_particle>) {
-				particle.integrate(delta);
-			}
-			else if constexpr(std::is_same_v<P, animated_particle>) {
-				particle.integrate(delta, anims);
-			}
-			else if constexpr(std::is_same_v<P, homing_animated_particle>) {
-				particle.integrate(delta, anims, std::forward<decltype(args)>(args)...);
-			}
-			else {
-				static_assert(always_false_v<P>, "Unimplemented!");
+				if constexpr(std::is_same_v<P, animated_particle>) {
+					particle.integrate(delta, anims);
+				}
+				else if constexpr(std::is_same_v<P, homing_animated_particle>) {
+					particle.integrate(delta, anims, std::forward<decltype(args)>(args)...);
+				}
+				else {
+					static_assert(always_false_v<P>, "Unimplemented!");
+				}
 			}
 		}
 	};
 
 	auto generic_draw = [&output_buffers, &game_images, &anims](const particle_layer p, auto& range, const int layer_index, const int from_i, const int till_i, auto&&...) {
-		{
-			auto& target_buffer = output_buffers.diffuse[p];
-
-			auto li = layer_index;
-
-			for (int i = from_i; i < till_i; ++i) {
-				auto& particle = range[i];
-
-				auto& t1 = target_buffer[2 * li];
-				auto& t2 = target_buffer[2 * li + 1];
+		using P = typename remove_cref<decltype(range)>::value_type;
 
-				particle.template draw_as_sprite<false>(t1, t2, game_images, anims);
+		auto draw_into = [&](auto& target_buffer, auto use_neon_maps) {
+			constexpr bool neon = decltype(use_neon_maps)::value;
 
-				++li;
+			if constexpr(std::is_same_v<P, general_particle>) {
+				range.template draw_as_sprites<neon>(from_i, till_i, target_buffer.data() + 2 * layer_index, game_images);
 			}
-		}
+			else {
+				auto li = layer_index;
 
-		if (p == particle_layer::NEONING_PARTICLES) {
-			auto& target_buffer = output_buffers.neons;
+				for (int i = from_i; i < till_i; ++i) {
+					auto& particle = range[i];
 
-			auto li = layer_index;
+					auto& t1 = target_buffer[2 * li];
+					auto& t2 = target_buffer[2 * li + 1];
 
-			for (int i = from_i; i < till_i; ++i) {
-				auto& particle = range[i];
+					particle.template draw_as_sprite<neon>(t1, t2, game_images, anims);
 
-				auto& t1 = target_buffer[2 * li];
-				auto& t2 = target_buffer[2 * li + 1];
+					++li;
+				}
+			}
+		};
 
-				particle.template draw_as_sprite<true>(t1, t2, game_images, anims);
+		draw_into(output_buffers.diffuse[p], std::false_type());
 
-				++li;
-			}
+		if (p == particle_layer::NEONING_PARTICLES) {
+			draw_into(output_buffers.neons, std::true_type());
 		}
 	};
 
@@ -871,3 +869,131 @@ void particles_simulation_system::advance_visible_streams(
 		settings
 	);
 }
+
+#if BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS
+namespace {
+	template <std::size_t N>
+	struct aos_and_soa_particles {
+		using soa_type = general_particles_soa<N>;
+
+		per_particle_layer_t<std::vector<general_particle>> aos;
+		per_particle_layer_t<std::unique_ptr<soa_type>> soa;
+
+		aos_and_soa_particles() {
+			auto rng = randomization(1337);
+
+			for (auto& layer : soa) {
+				layer = std::make_unique<soa_type>();
+			}
+
+			augs::for_each_enum_except_bounds([&](const particle_layer p) {
+				for (std::size_t i = 0; i < N; ++i) {
+					general_particle g;
+
+					g.pos = vec2(rng.randval(-1000.f, 1000.f), rng.randval(-1000.f, 1000.f));
+					g.vel = vec2(rng.randval(-500.f, 500.f), rng.randval(-500.f, 500.f));
+					g.acc = vec2(rng.randval(-50.f, 50.f), rng.randval(-50.f, 50.f));
+					g.rotation = rng.randval(0.f, 360.f);
+					g.rotation_speed = rng.randval(-720.f, 720.f);
+					g.linear_damping = i % 4 == 0 ? 0.f : rng.randval(0.f, 2000.f);
+					g.angular_damping = rng.randval(0.f, 1000.f);
+					g.max_lifetime_ms = rng.randval(100.f, 2000.f);
+
+					aos[p].push_back(g);
+					soa[p]->push_back(g);
+				}
+			});
+		}
+
+		void integrate_aos(const float dt) {
+			for (auto& layer : aos) {
+				for (auto& g : layer) {
+					g.integrate(dt);
+				}
+
+				erase_if(layer, [](const general_particle& g) { return g.is_dead(); });
+			}
+		}
+
+		void integrate_soa(const float dt) {
+			for (auto& layer : soa) {
+				layer->integrate(dt);
+				layer->remove_dead();
+			}
+		}
+	};
+}
+#endif
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("ParticlesSimulation SoAIntegration") {
+	constexpr float dt = 1 / 60.f;
+
+	auto particles = std::make_unique<aos_and_soa_particles<1000>>();
+	auto& aos = particles->aos;
+	auto& soa = particles->soa;
+
+	/* Long enough for most particles to die, so that culling is checked too. */
+
+	for (int s = 0; s < 90; ++s) {
+		particles->integrate_aos(dt);
+		particles->integrate_soa(dt);
+	}
+
+	augs::for_each_enum_except_bounds([&](const particle_layer p) {
+		REQUIRE(aos[p].size() == soa[p]->size());
+
+		for (std::size_t i = 0; i < aos[p].size(); ++i) {
+			const auto a = aos[p][i];
+			const auto b = soa[p]->get(i);
+
+			REQUIRE(std::abs(a.pos.x - b.pos.x) < 0.01f);
+			REQUIRE(std::abs(a.pos.y - b.pos.y) < 0.01f);
+			REQUIRE(a.rotation == b.rotation);
+			REQUIRE(a.rotation_speed == b.rotation_speed);
+			REQUIRE(a.current_lifetime_ms == b.current_lifetime_ms);
+		}
+	});
+}
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS
+#include "augs/internal_benchmarks.h"
+#include "augs/log.h"
+#include "augs/misc/timing/timer.h"
+
+INTERNAL_BENCHMARK("ParticlesSimulation SoAIntegration") {
+	constexpr std::size_t particles_per_layer = 100000;
+	constexpr int num_steps = 60;
+	constexpr float dt = 1 / 60.f;
+
+	auto particles = std::make_unique<aos_and_soa_particles<particles_per_layer>>();
+
+	double aos_ms = 0.0;
+	double soa_ms = 0.0;
+
+	for (int s = 0; s < num_steps; ++s) {
+		{
+			augs::timer t;
+			particles->integrate_aos(dt);
+			aos_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+			particles->integrate_soa(dt);
+			soa_ms += t.get<std::chrono::milliseconds>();
+		}
+	}
+
+	LOG(
+		"Integrating and culling %x general particles per layer over %x steps. AoS: %x ms, SoA: %x ms (avg. per step).",
+		particles_per_layer,
+		num_steps,
+		aos_ms / num_steps,
+		soa_ms / num_steps
+	);
+}
+#endif
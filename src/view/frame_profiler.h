@@ -19,6 +19,8 @@ struct frame_profiler : public augs::profiler_mixin<frame_profiler> {
 	augs::time_measurements debug_details;
 	augs::time_measurements debug_lines;
 	augs::time_measurements light_visibility;
+	augs::amount_measurements<std::size_t> num_reused_light_visibilities = 1;
+	augs::amount_measurements<std::size_t> num_recalculated_light_visibilities = 1;
 	augs::time_measurements light_rendering;
 	augs::time_measurements particles_rendering;
 	augs::time_measurements advance_setup;
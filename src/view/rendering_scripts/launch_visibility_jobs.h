@@ -1,6 +1,135 @@
 #pragma once
+#include <optional>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
 #include "view/rendering_scripts/vis_response_to_triangles.h"
 #include "game/enums/filters.h"
+#include "game/detail/physics/physics_queries.h"
+#include "augs/templates/hash_templates.h"
+#include "augs/templates/container_templates.h"
+
+inline uint64_t hash_fixture_shape(const b2Shape& shape) {
+	auto h = augs::hash_multiple(static_cast<int32_t>(shape.GetType()), shape.m_radius);
+
+	auto combine_vertices = [&h](const b2Vec2* const vertices, const int32 n) {
+		augs::hash_combine(h, n);
+
+		for (int32 i = 0; i < n; ++i) {
+			augs::hash_combine(h, vertices[i].x, vertices[i].y);
+		}
+	};
+
+	switch (shape.GetType()) {
+		case b2Shape::e_circle: {
+			const auto& circle = static_cast<const b2CircleShape&>(shape);
+			augs::hash_combine(h, circle.m_p.x, circle.m_p.y);
+			break;
+		}
+		case b2Shape::e_edge: {
+			const auto& edge = static_cast<const b2EdgeShape&>(shape);
+			augs::hash_combine(h, edge.m_vertex1.x, edge.m_vertex1.y, edge.m_vertex2.x, edge.m_vertex2.y);
+			break;
+		}
+		case b2Shape::e_polygon: {
+			const auto& poly = static_cast<const b2PolygonShape&>(shape);
+			combine_vertices(poly.m_vertices, poly.m_count);
+			break;
+		}
+		case b2Shape::e_chain: {
+			const auto& chain = static_cast<const b2ChainShape&>(shape);
+			combine_vertices(chain.m_vertices, chain.m_count);
+			break;
+		}
+		default:
+			break;
+	}
+
+	return h;
+}
+
+/*
+	Hashes everything that the visibility of a light depends on:
+	the request itself and, for every fixture within the queried rect,
+	the entity that owns it, its shape and the transform of its body.
+
+	Nothing here depends on where the fixtures live in memory,
+	so the signature survives the physics world being rebuilt with the same content.
+
+	Returns std::nullopt if any of these fixtures belongs to a non-static body,
+	in which case the visibility must be recalculated.
+*/
+
+inline std::optional<uint64_t> calc_static_visibility_signature(
+	const cosmos& cosm,
+	const visibility_request& request
+) {
+	const auto si = cosm.get_si();
+	const auto& physics = cosm.get_solvable_inferred().physics;
+
+	const auto& eye = request.eye_transform;
+	const auto& filter = request.filter;
+
+	const vec2 eye_meters = si.get_meters(eye.pos + request.offset);
+	const auto vision_meters = si.get_meters(request.queried_rect);
+
+	b2AABB aabb;
+	aabb.lowerBound = b2Vec2(eye_meters - vision_meters / 2);
+	aabb.upperBound = b2Vec2(eye_meters + vision_meters / 2);
+
+	bool only_static = true;
+
+	/* 
+		Summed so that the order in which the broadphase reports fixtures does not matter.
+		It can change whenever dynamic proxies move around the tree.
+	*/
+
+	uint64_t occluders_sum = 0;
+
+	physics.for_each_in_aabb_meters(
+		aabb,
+		filter,
+		[&](const b2Fixture& f) {
+			if (get_body_entity_that_owns(f) == Userdata(request.subject)) {
+				return callback_result::CONTINUE;
+			}
+
+			const auto& body = *f.GetBody();
+
+			if (body.GetType() != b2_staticBody) {
+				only_static = false;
+				return callback_result::ABORT;
+			}
+
+			const auto& xf = body.GetTransform();
+
+			occluders_sum += augs::hash_multiple(
+				get_entity_that_owns(f),
+				get_body_entity_that_owns(f),
+				xf.p.x, xf.p.y, xf.q.s, xf.q.c,
+				::hash_fixture_shape(*f.GetShape())
+			);
+
+			return callback_result::CONTINUE;
+		}
+	);
+
+	if (!only_static) {
+		return std::nullopt;
+	}
+
+	return augs::hash_multiple(
+		eye.pos.x, eye.pos.y, eye.rotation,
+		request.offset.x, request.offset.y,
+		request.queried_rect.x, request.queried_rect.y,
+		request.ignore_discontinuities_shorter_than,
+		filter.categoryBits, 
+		filter.maskBits, 
+		static_cast<int32_t>(filter.groupIndex),
+		occluders_sum
+	);
+}
 
 inline void enqueue_visibility_jobs(
 	augs::thread_pool& pool,
@@ -21,30 +150,71 @@ inline void enqueue_visibility_jobs(
 		const auto& light_requests = cached_visibility.light_requests;
 		const auto lights_n = light_requests.size();
 
-		auto& light_responses = cached_visibility.light_responses;
-		light_responses.resize(lights_n);
+		auto& per_light = cached_visibility.per_light;
+
+		if (cached_visibility.per_light_cosmos != std::addressof(cosm)) {
+			per_light.clear();
+			cached_visibility.per_light_cosmos = std::addressof(cosm);
+		}
+
+		for (auto& entry : per_light) {
+			entry.second.used = false;
+		}
+
+		auto& num_reused = cached_visibility.num_reused_lights;
+		auto& num_recalculated = cached_visibility.num_recalculated_lights;
+
+		num_reused.store(0, std::memory_order_relaxed);
+		num_recalculated.store(0, std::memory_order_relaxed);
 
 		auto& light_triangles_vectors = dedicated[DV::LIGHT_VISIBILITY];
 		light_triangles_vectors.resize(lights_n);
 
 		for (std::size_t i = 0; i < lights_n; ++i) {
 			const auto& request = light_requests[i];
-			auto& response = light_responses[i];
 
 			if (!request.valid()) {
-				response.clear();
 				continue;
 			}
 
+			/* 
+				Element references of an unordered_map stay valid while more lights are inserted,
+				and every job only touches the entry of its own light.
+			*/
+
+			auto& cached = per_light[request.subject];
 			auto& triangles = light_triangles_vectors[i].triangles;
 
-			auto light_job = [&cosm, request, &response, &triangles]() {
-				visibility_system(DEBUG_FRAME_LINES).calc_visibility(cosm, request, response);
+			cached.used = true;
+
+			/* The signature queries the physics just like the visibility does, so it is calculated in the job too. */
+
+			auto light_job = [&cosm, request, &cached, &triangles, &num_reused, &num_recalculated]() {
+				auto& response = cached.response;
+
+				const auto signature = ::calc_static_visibility_signature(cosm, request);
+
+				if (signature && cached.valid && cached.signature == *signature) {
+					num_reused.fetch_add(1, std::memory_order_relaxed);
+				}
+				else {
+					num_recalculated.fetch_add(1, std::memory_order_relaxed);
+
+					cached.valid = signature.has_value();
+					cached.signature = signature ? *signature : 0;
+
+					visibility_system(DEBUG_FRAME_LINES).calc_visibility(cosm, request, response);
+				}
+
 				vis_response_to_triangles(response, triangles, request.color, request.eye_transform.pos);
 			};
 
 			pool.enqueue(light_job);
 		}
+
+		erase_if(per_light, [](const auto& entry) {
+			return !entry.second.used;
+		});
 	};
 
 	launch_light_jobs();
@@ -0,0 +1,244 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "view/viewables/particle_types.h"
+
+/*
+	Structure-of-arrays storage for the general particles of a single layer.
+
+	Every field lives in its own contiguous column,
+	so integration and culling only stream through the columns they need,
+	in branchless loops that the compiler can vectorize for whatever instruction set we target.
+*/
+
+template <std::size_t max_count>
+class general_particles_soa {
+	template <class T>
+	using column = std::array<T, max_count>;
+
+	std::size_t count = 0;
+
+	alignas(32) column<float> pos_x;
+	alignas(32) column<float> pos_y;
+	alignas(32) column<float> vel_x;
+	alignas(32) column<float> vel_y;
+	alignas(32) column<float> acc_x;
+	alignas(32) column<float> acc_y;
+
+	alignas(32) column<float> rotation;
+	alignas(32) column<float> rotation_speed;
+	alignas(32) column<float> linear_damping;
+	alignas(32) column<float> angular_damping;
+
+	alignas(32) column<float> current_lifetime_ms;
+	alignas(32) column<float> max_lifetime_ms;
+	alignas(32) column<float> shrink_when_ms_remaining;
+	alignas(32) column<float> unshrinking_time_ms;
+
+	column<assets::image_id> image_id;
+	column<rgba> color;
+	column<vec2i> image_size;
+	column<int> alpha_levels;
+
+	void move_particle(const std::size_t from, const std::size_t to) {
+		pos_x[to] = pos_x[from];
+		pos_y[to] = pos_y[from];
+		vel_x[to] = vel_x[from];
+		vel_y[to] = vel_y[from];
+		acc_x[to] = acc_x[from];
+		acc_y[to] = acc_y[from];
+
+		rotation[to] = rotation[from];
+		rotation_speed[to] = rotation_speed[from];
+		linear_damping[to] = linear_damping[from];
+		angular_damping[to] = angular_damping[from];
+
+		current_lifetime_ms[to] = current_lifetime_ms[from];
+		max_lifetime_ms[to] = max_lifetime_ms[from];
+		shrink_when_ms_remaining[to] = shrink_when_ms_remaining[from];
+		unshrinking_time_ms[to] = unshrinking_time_ms[from];
+
+		image_id[to] = image_id[from];
+		color[to] = color[from];
+		image_size[to] = image_size[from];
+		alpha_levels[to] = alpha_levels[from];
+	}
+
+public:
+	using value_type = general_particle;
+
+	std::size_t size() const {
+		return count;
+	}
+
+	static constexpr std::size_t max_size() {
+		return max_count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	void clear() {
+		count = 0;
+	}
+
+	void push_back(const general_particle& p) {
+		const auto i = count++;
+
+		pos_x[i] = p.pos.x;
+		pos_y[i] = p.pos.y;
+		vel_x[i] = p.vel.x;
+		vel_y[i] = p.vel.y;
+		acc_x[i] = p.acc.x;
+		acc_y[i] = p.acc.y;
+
+		rotation[i] = p.rotation;
+		rotation_speed[i] = p.rotation_speed;
+		linear_damping[i] = p.linear_damping;
+		angular_damping[i] = p.angular_damping;
+
+		current_lifetime_ms[i] = p.current_lifetime_ms;
+		max_lifetime_ms[i] = p.max_lifetime_ms;
+		shrink_when_ms_remaining[i] = p.shrink_when_ms_remaining;
+		unshrinking_time_ms[i] = p.unshrinking_time_ms;
+
+		image_id[i] = p.image_id;
+		color[i] = p.color;
+		image_size[i] = p.size;
+		alpha_levels[i] = p.alpha_levels;
+	}
+
+	general_particle get(const std::size_t i) const {
+		general_particle p;
+
+		p.pos = vec2(pos_x[i], pos_y[i]);
+		p.vel = vec2(vel_x[i], vel_y[i]);
+		p.acc = vec2(acc_x[i], acc_y[i]);
+
+		p.rotation = rotation[i];
+		p.rotation_speed = rotation_speed[i];
+		p.linear_damping = linear_damping[i];
+		p.angular_damping = angular_damping[i];
+
+		p.current_lifetime_ms = current_lifetime_ms[i];
+		p.max_lifetime_ms = max_lifetime_ms[i];
+		p.shrink_when_ms_remaining = shrink_when_ms_remaining[i];
+		p.unshrinking_time_ms = unshrinking_time_ms[i];
+
+		p.image_id = image_id[i];
+		p.color = color[i];
+		p.size = image_size[i];
+		p.alpha_levels = alpha_levels[i];
+
+		return p;
+	}
+
+	/* Same arithmetic as general_particle::integrate. */
+
+	void integrate(const std::size_t from, const std::size_t till, const float dt) {
+		const auto dt_ms = dt * 1000;
+
+		for (std::size_t i = from; i < till; ++i) {
+			const auto vx = vel_x[i] + acc_x[i] * dt;
+			const auto vy = vel_y[i] + acc_y[i] * dt;
+
+			pos_x[i] += vx * dt;
+			pos_y[i] += vy * dt;
+
+			/* 
+				vec2::shrink without branches.
+				With no damping, speed / speed is exactly 1 and a zero speed stays zero.
+			*/
+
+			const auto shrink_by = linear_damping[i] * dt;
+			const auto speed = std::sqrt(vx * vx + vy * vy);
+			const auto vel_mult = std::max(speed - shrink_by, 0.f) / std::max(speed, std::numeric_limits<float>::min());
+
+			vel_x[i] = vx * vel_mult;
+			vel_y[i] = vy * vel_mult;
+
+			current_lifetime_ms[i] += dt_ms;
+
+			/* augs::shrink without branches. */
+			const auto rs = rotation_speed[i];
+			rotation[i] += rs * dt;
+			rotation_speed[i] = std::copysign(std::max(std::abs(rs) - angular_damping[i] * dt, 0.f), rs);
+		}
+	}
+
+	void integrate(const float dt) {
+		integrate(0, count, dt);
+	}
+
+	/* Keeps the order of the survivors so that they're drawn exactly as before. */
+
+	void remove_dead() {
+		std::size_t alive = 0;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			if (current_lifetime_ms[i] >= max_lifetime_ms[i]) {
+				continue;
+			}
+
+			if (alive != i) {
+				move_particle(i, alive);
+			}
+
+			++alive;
+		}
+
+		count = alive;
+	}
+
+	/* Same output as general_particle::draw_as_sprite, written to two consecutive triangles per particle. */
+
+	template <bool use_neon_maps, class M>
+	void draw_as_sprites(
+		const std::size_t from,
+		const std::size_t till,
+		augs::vertex_triangle* const triangles,
+		const M& manager
+	) const {
+		for (std::size_t i = from; i < till; ++i) {
+			auto& t1 = triangles[2 * (i - from)];
+			auto& t2 = triangles[2 * (i - from) + 1];
+
+			const auto lifetime = current_lifetime_ms[i];
+
+			float size_mult = 1.f;
+
+			if (const auto shrink_when = shrink_when_ms_remaining[i]; shrink_when > 0.f) {
+				size_mult *= std::sqrt(std::min(1.f, (max_lifetime_ms[i] - lifetime) / shrink_when));
+			}
+
+			if (const auto unshrinking = unshrinking_time_ms[i]; unshrinking > 0.f) {
+				size_mult *= std::min(1.f, (lifetime / unshrinking) * (lifetime / unshrinking));
+			}
+
+			const auto pos = vec2(pos_x[i], pos_y[i]);
+
+			auto draw = [&](const vec2i drawn_size) {
+				if constexpr(use_neon_maps) {
+					augs::detail_write_neon_sprite(t1, t2, manager.at(image_id[i]), drawn_size, pos, rotation[i], color[i]);
+				}
+				else {
+					augs::detail_write_sprite(t1, t2, manager.at(image_id[i]), drawn_size, pos, rotation[i], color[i]);
+				}
+			};
+
+			if (size_mult != 1.f) {
+				if (const auto target_size = vec2i(vec2(image_size[i]) * size_mult); target_size.area() > 1) {
+					draw(target_size);
+				}
+			}
+			else {
+				draw(image_size[i]);
+			}
+		}
+	}
+};
@@ -7,6 +7,7 @@ struct content_regeneration_settings {
 
 	unsigned atlas_blitting_threads = 2;
 	unsigned neon_regeneration_threads = 2;
+	unsigned sound_decoding_threads = 3;
 	// END GEN INTROSPECTOR
 
 	bool operator==(const content_regeneration_settings& b) const = default;
@@ -1,9 +1,11 @@
 #include <sstream>
+#include <thread>
 
 #include "augs/filesystem/file.h"
 #include "augs/filesystem/directory.h"
 #include "augs/misc/simple_pair.h"
 
+#include "augs/log.h"
 #include "augs/ensure.h"
 #include "augs/readwrite/memory_stream.h"
 
@@ -13,14 +15,42 @@
 
 #include "augs/readwrite/byte_file.h"
 #include "augs/readwrite/to_bytes.h"
+#include "augs/misc/secure_hash.h"
+#include "augs/misc/streaming_hasher.h"
+#include "all_paths.h"
 
 #define PIXEL_NONE rgba(0,0,0,0)
 
+/* Bump whenever make_neon starts producing different output, so that stale cached results are not reused. */
+constexpr uint32_t neon_map_generator_version_v = 2;
+
+/* Least recently used results are evicted once all of them take more than this. */
+constexpr std::uintmax_t neon_map_cache_max_bytes_v = 256 * 1024 * 1024;
+
+#define NEON_MAPS_CACHE_DIR (CACHE_DIR / "neon_maps")
+
 void make_neon(
 	const neon_map_input& input,
 	augs::image& source
 );
 
+augs::path_type get_hashed_neon_map_path(
+	const std::vector<std::byte>& source_image_bytes,
+	const neon_map_input& in
+) {
+	augs::streaming_hasher hasher;
+
+	hasher.write(neon_map_generator_version_v);
+	hasher.write_bytes(source_image_bytes.data(), source_image_bytes.size());
+
+	const auto input_bytes = augs::to_bytes(in);
+	hasher.write_bytes(input_bytes.data(), input_bytes.size());
+
+	const auto hash = hasher.finalize<augs::secure_hash_type>();
+
+	return NEON_MAPS_CACHE_DIR / (std::string(augs::to_hex_format(hash)) + ".png");
+}
+
 std::optional<cached_neon_map_in> should_regenerate_neon_map(
 	const augs::path_type& input_image_path,
 	const augs::path_type& output_image_path,
@@ -82,13 +112,63 @@ void regenerate_neon_map(
 
 	const auto new_stamp_bytes = augs::to_bytes(new_stamp);
 
-	thread_local augs::image source_image;
-	source_image.clear();
-	source_image.from_file(input_image_path);
+	/*
+		Identical images with identical settings, e.g. the same sprite copied between projects,
+		or a file that was only touched by a content update, share a single generated result.
+	*/
+
+	const auto source_image_bytes = augs::file_to_bytes(input_image_path);
+	const auto hashed_path = get_hashed_neon_map_path(source_image_bytes, in);
+
+	augs::create_directories_for(neon_map_path);
+
+	/*
+		The shared results are only an optimization.
+		If they can't be read or written, e.g. because another process has just evicted them,
+		the neon map is still generated and saved.
+	*/
+
+	const bool copied_from_cache = [&]() {
+		try {
+			if (augs::exists(hashed_path)) {
+				std::filesystem::copy_file(hashed_path, neon_map_path, std::filesystem::copy_options::overwrite_existing);
 
-	make_neon(in, source_image);
+				/* Mark it as recently used for the eviction. */
+				std::filesystem::last_write_time(hashed_path, std::filesystem::file_time_type::clock::now());
+				return true;
+			}
+		}
+		catch (const std::filesystem::filesystem_error& err) {
+			LOG("Failed to reuse the cached neon map %x: %x", hashed_path, err.what());
+		}
+
+		return false;
+	}();
+
+	if (!copied_from_cache) {
+		thread_local augs::image source_image;
+		source_image.clear();
+		source_image.from_bytes(source_image_bytes, input_image_path);
+
+		make_neon(in, source_image);
+
+		source_image.save(neon_map_path);
 
-	source_image.save(neon_map_path);
+		/* Another worker might be generating the same image, so publish the result atomically. */
+
+		const auto thread_suffix = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+		const auto temporary_path = augs::path_type(hashed_path).replace_extension(thread_suffix + ".tmp");
+
+		try {
+			augs::create_directories_for(hashed_path);
+			std::filesystem::copy_file(neon_map_path, temporary_path, std::filesystem::copy_options::overwrite_existing);
+			std::filesystem::rename(temporary_path, hashed_path);
+		}
+		catch (const std::filesystem::filesystem_error& err) {
+			LOG("Failed to cache the neon map %x: %x", hashed_path, err.what());
+			augs::remove_file(temporary_path);
+		}
+	}
 
 	augs::create_directories_for(neon_map_stamp_path);
 	augs::bytes_to_file(cached_in.new_stamp_bytes, neon_map_stamp_path);
@@ -97,6 +177,67 @@ catch (...) {
 	augs::remove_file(output_image_path);
 }
 
+std::size_t evict_cached_neon_maps() {
+	struct cached_neon_map {
+		std::filesystem::file_time_type last_used;
+		std::uintmax_t size = 0;
+		augs::path_type path;
+	};
+
+	std::vector<cached_neon_map> cached;
+
+	try {
+		if (!augs::exists(NEON_MAPS_CACHE_DIR)) {
+			return 0;
+		}
+
+		augs::for_each_in_directory(
+			NEON_MAPS_CACHE_DIR,
+			[](const auto&) { return callback_result::CONTINUE; },
+			[&](const auto& p) {
+				if (p.extension() == ".png") {
+					std::error_code err;
+
+					const auto last_used = std::filesystem::last_write_time(p, err);
+					const auto size = err ? 0 : std::filesystem::file_size(p, err);
+
+					/* Might have just been evicted by another process. */
+					if (!err) {
+						cached.push_back({ last_used, size, p });
+					}
+				}
+
+				return callback_result::CONTINUE;
+			}
+		);
+	}
+	catch (const std::filesystem::filesystem_error& err) {
+		LOG("Failed to list the cached neon maps: %x", err.what());
+		return 0;
+	}
+
+	std::sort(
+		cached.begin(),
+		cached.end(),
+		[](const auto& a, const auto& b) {
+			return a.last_used > b.last_used;
+		}
+	);
+
+	std::uintmax_t total_bytes = 0;
+	std::size_t num_removed = 0;
+
+	for (const auto& c : cached) {
+		total_bytes += c.size;
+
+		if (total_bytes > neon_map_cache_max_bytes_v && augs::remove_file(c.path)) {
+			++num_removed;
+		}
+	}
+
+	return num_removed;
+}
+
 void generate_gauss_kernel(
 	const neon_map_input& input,
 	std::vector<double>& result
@@ -115,11 +256,270 @@ void resize_image(
 
 void cut_empty_edges(augs::image& source);
 
-/* Thread local usage actually makes this slower, I have no idea why. */
+/*
+	Every light pixel contributes min(255, 255 * amplification * kernel) of alpha to the pixels around it.
+	A neon pixel takes the highest alpha it receives,
+	and its color is a running blend of the contributing light colors in the order they were found.
+
+	If all light pixels share a single color, the blend always results in exactly that color,
+	so only the alpha has to be found. The kernel only depends on the squared distance from its center,
+	and decreases with it, so the highest contribution comes from the nearest light pixel within the kernel's rectangle.
+	The rectangle is a product of two ranges, so the nearest squared distance can be found in two one-dimensional passes:
+	first along the rows, then along the columns. The alpha is then looked up by that distance
+	in the very same two-dimensional kernel, so the result is identical to splatting the kernel pixel by pixel.
+	This turns O(light pixels * radius.x * radius.y) into O((light pixels + touched rows * width) * radius).
+
+	Otherwise the result depends on the order, so we have to splat light pixels one by one,
+	but only with the kernel entries whose alpha isn't truncated to zero.
+	For the usual settings that is a small disc in the middle of the radius.x * radius.y square.
+*/
+
+void splat_single_color_neon(
+	const neon_map_input& input,
+	const std::vector<vec2u>& pixel_coordinates,
+	const rgba light_color,
+	augs::image& source
+) {
+	const auto radius = input.radius;
+
+	thread_local std::vector<double> kernel_;
+	thread_local std::vector<unsigned> alpha_by_distance_sq_;
+	thread_local std::vector<unsigned> rows_nearest_;
+	thread_local std::vector<unsigned> columns_nearest_;
+	thread_local std::vector<augs::simple_pair<unsigned, unsigned>> touched_columns_;
+
+	auto& kernel = kernel_;
+	auto& alpha_by_distance_sq = alpha_by_distance_sq_;
+	auto& rows_nearest = rows_nearest_;
+	auto& columns_nearest = columns_nearest_;
+	auto& touched_columns = touched_columns_;
+
+	/* Offsets covered by the kernel are [-radius / 2, radius - radius / 2). */
+
+	const auto min_dx = -static_cast<int>(radius.x / 2);
+	const auto max_dx = static_cast<int>(radius.x - radius.x / 2) - 1;
+	const auto min_dy = -static_cast<int>(radius.y / 2);
+	const auto max_dy = static_cast<int>(radius.y - radius.y / 2) - 1;
+
+	auto square = [](const int v) {
+		return static_cast<unsigned>(v * v);
+	};
+
+	generate_gauss_kernel(input, kernel);
+
+	const auto max_distance_sq = std::max(square(min_dx), square(max_dx)) + std::max(square(min_dy), square(max_dy));
+	alpha_by_distance_sq.assign(max_distance_sq + 1, 0u);
+
+	for (unsigned y = 0; y < radius.y; ++y) {
+		for (unsigned x = 0; x < radius.x; ++x) {
+			const auto distance_sq = square(static_cast<int>(x) + min_dx) + square(static_cast<int>(y) + min_dy);
+			alpha_by_distance_sq[distance_sq] = std::min(255u, static_cast<unsigned>(255 * kernel[y * radius.x + x] * input.amplification));
+		}
+	}
+
+	const auto source_rows = source.get_rows();
+	const auto source_cols = source.get_columns();
+	const auto total_pixels = static_cast<std::size_t>(source_rows) * source_cols;
+
+	/* Larger than any distance in the kernel, and still safe to add to another one. */
+	const auto none = max_distance_sq + 1;
+
+	rows_nearest.assign(total_pixels, none);
+	columns_nearest.assign(total_pixels, none);
+
+	/* Per row, the range of columns the first pass has written to. Empty if first >= second. */
+	touched_columns.assign(source_rows, { source_cols, 0u });
+
+	for (const auto coord : pixel_coordinates) {
+		const auto first_x = std::max(static_cast<int>(coord.x) + min_dx, 0);
+		const auto last_x = std::min(static_cast<int>(coord.x) + max_dx + 1, static_cast<int>(source_cols));
+
+		if (first_x >= last_x) {
+			continue;
+		}
+
+		auto* const nearest = rows_nearest.data() + static_cast<std::size_t>(coord.y) * source_cols;
+
+		for (int x = first_x; x < last_x; ++x) {
+			nearest[x] = std::min(nearest[x], square(x - static_cast<int>(coord.x)));
+		}
+
+		auto& touched = touched_columns[coord.y];
+		touched.first = std::min(touched.first, static_cast<unsigned>(first_x));
+		touched.second = std::max(touched.second, static_cast<unsigned>(last_x));
+	}
+
+	for (unsigned y = 0; y < source_rows; ++y) {
+		const auto touched = touched_columns[y];
+
+		if (touched.first >= touched.second) {
+			continue;
+		}
+
+		const auto* const in_nearest = rows_nearest.data() + static_cast<std::size_t>(y) * source_cols;
+
+		for (int dy = min_dy; dy <= max_dy; ++dy) {
+			const unsigned target_y = y + dy;
+
+			if (target_y >= source_rows) {
+				continue;
+			}
+
+			auto* const nearest = columns_nearest.data() + static_cast<std::size_t>(target_y) * source_cols;
+			const auto dy_sq = square(dy);
+
+			for (unsigned x = touched.first; x < touched.second; ++x) {
+				nearest[x] = std::min(nearest[x], dy_sq + in_nearest[x]);
+			}
+		}
+	}
+
+	for (std::size_t i = 0; i < total_pixels; ++i) {
+		const auto distance_sq = columns_nearest[i];
+
+		if (distance_sq == none) {
+			continue;
+		}
+
+		if (const auto alpha = alpha_by_distance_sq[distance_sq]) {
+			auto& drawn_pixel = source.pixel(static_cast<unsigned>(i));
+
+			drawn_pixel = light_color;
+			drawn_pixel[3] = static_cast<rgba_channel>(alpha);
+		}
+	}
+}
+
+struct neon_kernel_entry {
+	int x = 0;
+	int y = 0;
+	unsigned alpha = 0;
+};
+
+void splat_multi_color_neon(
+	const neon_map_input& input,
+	const std::vector<vec2u>& pixel_coordinates,
+	const std::vector<rgba>& pixels_original,
+	augs::image& source
+) {
+	const auto radius = input.radius;
+
+	thread_local std::vector<double> kernel_;
+	thread_local std::vector<neon_kernel_entry> entries_;
+
+	auto& kernel = kernel_;
+	auto& entries = entries_;
+
+	generate_gauss_kernel(input, kernel);
+
+	entries.clear();
+
+	for (unsigned y = 0; y < radius.y; ++y) {
+		for (unsigned x = 0; x < radius.x; ++x) {
+			if (const auto alpha = std::min(255u, static_cast<unsigned>(255 * kernel[y * radius.x + x] * input.amplification))) {
+				entries.push_back({
+					static_cast<int>(x) - static_cast<int>(radius.x / 2),
+					static_cast<int>(y) - static_cast<int>(radius.y / 2),
+					alpha
+				});
+			}
+		}
+	}
+
+	const auto source_rows = source.get_rows();
+	const auto source_cols = source.get_columns();
+
+	for (std::size_t i = 0; i < pixel_coordinates.size(); ++i) {
+		const auto coord = pixel_coordinates[i];
+		const auto current_light_pixel = pixels_original[i];
+
+		for (const auto& e : entries) {
+			const unsigned current_index_y = coord.y + e.y;
+
+			if (current_index_y >= source_rows) {
+				continue;
+			}
+
+			const unsigned current_index_x = coord.x + e.x;
+
+			if (current_index_x >= source_cols) {
+				continue;
+			}
+
+			const auto alpha = e.alpha;
+			auto& drawn_pixel = source.pixel({ current_index_x, current_index_y });
+
+			if (drawn_pixel == PIXEL_NONE) {
+				drawn_pixel[2] = current_light_pixel[2];
+				drawn_pixel[1] = current_light_pixel[1];
+				drawn_pixel[0] = current_light_pixel[0];
+			}
+
+			else if (drawn_pixel != current_light_pixel) {
+				drawn_pixel[2] = static_cast<rgba_channel>((alpha * current_light_pixel[2] + drawn_pixel[3] * drawn_pixel[2]) / (alpha + drawn_pixel[3]));
+				drawn_pixel[1] = static_cast<rgba_channel>((alpha * current_light_pixel[1] + drawn_pixel[3] * drawn_pixel[1]) / (alpha + drawn_pixel[3]));
+				drawn_pixel[0] = static_cast<rgba_channel>((alpha * current_light_pixel[0] + drawn_pixel[3] * drawn_pixel[0]) / (alpha + drawn_pixel[3]));
+			}
+
+			drawn_pixel[3] = std::max(drawn_pixel[3], static_cast<rgba_channel>(alpha));
+		}
+	}
+}
 
 void make_neon(
 	const neon_map_input& input,
 	augs::image& source
+) {
+	resize_image(source, input.radius);
+
+	thread_local std::vector<vec2u> pixel_coordinates_;
+	thread_local std::vector<rgba> pixels_original_;
+
+	auto& pixel_coordinates = pixel_coordinates_;
+	auto& pixels_original = pixels_original_;
+
+	pixel_coordinates.clear();
+	pixels_original.clear();
+
+	scan_and_hide_undesired_pixels(source, input.light_colors, pixel_coordinates);
+
+	for (const auto& p : pixel_coordinates) {
+		pixels_original.emplace_back(source.pixel(p));
+	}
+
+	const bool single_color = std::adjacent_find(
+		pixels_original.begin(),
+		pixels_original.end(),
+		std::not_equal_to<rgba>()
+	) == pixels_original.end();
+
+	if (single_color && !pixels_original.empty()) {
+		splat_single_color_neon(input, pixel_coordinates, pixels_original.front(), source);
+	}
+	else {
+		splat_multi_color_neon(input, pixel_coordinates, pixels_original, source);
+	}
+
+	for (std::size_t i = 0; i < pixel_coordinates.size(); ++i) {
+		source.pixel(pixel_coordinates[i]) = pixels_original[i];
+	}
+
+	cut_empty_edges(source);
+
+	for (auto& p : source) {
+		p.mult_alpha(input.alpha_multiplier);
+	}
+}
+
+#if BUILD_UNIT_TESTS || BUILD_INTERNAL_BENCHMARKS
+/*
+	The original generator, which splats the whole two-dimensional kernel around every light pixel.
+	Kept only to verify make_neon against it.
+*/
+
+void make_neon_per_pixel(
+	const neon_map_input& input,
+	augs::image& source
 ) {
 	const auto radius = input.radius;
 
@@ -197,6 +597,7 @@ void make_neon(
 		p.mult_alpha(input.alpha_multiplier);
 	}
 }
+#endif
 
 void generate_gauss_kernel(const neon_map_input& input, std::vector<double>& result) {
 	const auto radius = input.radius;
@@ -239,7 +640,6 @@ void generate_gauss_kernel(const neon_map_input& input, std::vector<double>& res
 	}
 }
 
-
 void scan_and_hide_undesired_pixels(
 	augs::image& original_image,
 	const std::vector<rgba>& color_whitelist,
@@ -346,3 +746,125 @@ void cut_empty_edges(augs::image& source) {
 
 	source = std::move(copy);
 }
+
+#if BUILD_UNIT_TESTS
+#include <Catch/single_include/catch2/catch.hpp>
+
+TEST_CASE("NeonMaps MatchPerPixel") {
+	const auto red = rgba(255, 0, 0, 255);
+	const auto green = rgba(0, 255, 0, 200);
+	const auto blue = rgba(0, 0, 255, 255);
+	const auto ignored = rgba(255, 255, 255, 255);
+
+	auto make_source = [&](const std::vector<rgba>& palette) {
+		augs::image source;
+		source.resize_fill({ 24u, 17u });
+
+		for (unsigned y = 0; y < source.get_rows(); ++y) {
+			for (unsigned x = 0; x < source.get_columns(); ++x) {
+				const auto n = (x * 7 + y * 13) % 11;
+
+				if (n < palette.size()) {
+					source.pixel({ x, y }) = palette[n];
+				}
+			}
+		}
+
+		/* Light pixels at the very edges, where the kernel is cut off. */
+		source.pixel({ 0u, 0u }) = palette.front();
+		source.pixel({ source.get_columns() - 1, source.get_rows() - 1 }) = palette.back();
+
+		return source;
+	};
+
+	auto check = [&](const neon_map_input& in, const std::vector<rgba>& palette) {
+		auto per_pixel = make_source(palette);
+		auto current = per_pixel;
+
+		make_neon_per_pixel(in, per_pixel);
+		make_neon(in, current);
+
+		REQUIRE(per_pixel.get_size() == current.get_size());
+
+		for (unsigned i = 0; i < per_pixel.get_rows() * per_pixel.get_columns(); ++i) {
+			REQUIRE(per_pixel.pixel(i) == current.pixel(i));
+		}
+	};
+
+	neon_map_input defaults;
+	defaults.light_colors = { red, green, blue };
+
+	neon_map_input small_odd = defaults;
+	small_odd.standard_deviation = 2.f;
+	small_odd.radius = { 13u, 9u };
+	small_odd.amplification = 3.f;
+	small_odd.alpha_multiplier = 0.5f;
+
+	for (const auto& in : { defaults, small_odd }) {
+		check(in, { red });
+		check(in, { green, ignored });
+		check(in, { red, green, blue });
+		check(in, { blue, ignored, red });
+	}
+}
+#endif
+
+#if BUILD_INTERNAL_BENCHMARKS && BUILD_TEST_SCENES
+#include "augs/log.h"
+#include "augs/internal_benchmarks.h"
+#include "augs/misc/timing/timer.h"
+#include "augs/misc/pool/pool.h"
+#include "view/viewables/image_definition.h"
+#include "test_scenes/test_scenes_content.h"
+
+INTERNAL_BENCHMARK("NeonMaps OfficialContent") {
+	image_definitions_map definitions;
+	load_test_scene_images(definitions);
+
+	double per_pixel_ms = 0.0;
+	double current_ms = 0.0;
+
+	std::size_t num_neon_maps = 0;
+	std::size_t num_mismatched_maps = 0;
+
+	for (const auto& definition : definitions) {
+		if (!definition.meta.extra_loadables.should_generate_neon_map()) {
+			continue;
+		}
+
+		const auto& in = definition.meta.extra_loadables.generate_neon_map.value;
+		const auto path = image_definition_view({}, definition).get_source_image_path();
+
+		augs::image per_pixel;
+		per_pixel.from_file(path);
+
+		auto current = per_pixel;
+
+		{
+			augs::timer t;
+			make_neon_per_pixel(in, per_pixel);
+			per_pixel_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		{
+			augs::timer t;
+			make_neon(in, current);
+			current_ms += t.get<std::chrono::milliseconds>();
+		}
+
+		if (!std::equal(per_pixel.begin(), per_pixel.end(), current.begin(), current.end())) {
+			++num_mismatched_maps;
+		}
+
+		++num_neon_maps;
+	}
+
+	LOG(
+		"Generated %x official neon maps (%x differ from the per pixel generator). Per pixel: %x ms, current: %x ms.",
+		num_neon_maps,
+		num_mismatched_maps,
+		per_pixel_ms,
+		current_ms
+	);
+}
+#endif
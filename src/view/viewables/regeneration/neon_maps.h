@@ -48,4 +48,7 @@ void regenerate_neon_map(
 	const augs::path_type& output_image_path,
 	const neon_map_input in,
 	cached_neon_map_in
-);
\ No newline at end of file
+);
+
+/* Removes the least recently used neon maps shared between identical images, once they grow too large. Returns how many were removed. */
+std::size_t evict_cached_neon_maps();
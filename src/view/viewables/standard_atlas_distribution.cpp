@@ -166,6 +166,12 @@ void regenerate_and_gather_subjects(
 			workers.wait_for_all_tasks_to_complete();
 		}
 
+		if (total_to_regenerate > 0) {
+			if (const auto num_evicted = ::evict_cached_neon_maps()) {
+				LOG("Evicted %x least recently used neon maps from the cache.", num_evicted);
+			}
+		}
+
 		for (const auto& d : in.image_definitions) {
 			const auto def = make_view(d);
 
@@ -16,8 +16,13 @@
 #include "augs/misc/compress.h"
 #include "augs/readwrite/byte_file.h"
 #include "augs/readwrite/to_bytes.h"
+#include "augs/readwrite/stream_read_error.h"
 #include "application/setups/client/demo_file_meta.h"
+#include "application/setups/client/indexed_demo.h"
 #include "augs/misc/scope_guard.h"
+#include "augs/audio/sound_data.h"
+#include "augs/templates/thread_pool.h"
+#include "all_paths.h"
 
 #if PLATFORM_WEB && !WEB_SINGLETHREAD
 #include "augs/templates/main_thread_queue.h"
@@ -327,7 +332,15 @@ void viewables_streaming::load_all(const viewables_load_input in) {
 
 			sounds_progress->max_sounds.store(sound_paths_info.size());
 
-			auto buffer_loader = [&](){
+			const auto num_decoding_workers = std::size_t(std::max(in.settings.sound_decoding_threads, 1u) - 1);
+
+#if PLATFORM_WEB
+			const auto pcm_cache_dir = augs::path_type();
+#else
+			const auto pcm_cache_dir = augs::path_type(CACHE_DIR / "decoded_sounds");
+#endif
+
+			auto buffer_loader = [&, num_decoding_workers, pcm_cache_dir](){
 				web_sdk_loading_start();
 				auto scoped_stop = augs::scope_guard([]() { web_sdk_loading_stop(); });
 
@@ -335,22 +348,75 @@ void viewables_streaming::load_all(const viewables_load_input in) {
 
 				value_type result;
 
-				for (const auto& r : sound_requests) {
-					if (r.second.source_sound.empty()) {
-						/* A request to unload. */
-						result.push_back(std::nullopt);
-						continue;
-					}
+				/*
+					Decoding doesn't touch OpenAL so it's spread across workers,
+					but the buffers are created on this thread, which on the web has to be the main one.
+
+					Going in batches bounds how many decoded, still uncompressed sounds are held at once.
+				*/
+
+				static augs::thread_pool decoders = 0;
+				decoders.resize(num_decoding_workers);
+
+				const auto batch_size = (num_decoding_workers + 1) * 4;
+
+				std::vector<std::optional<std::vector<augs::sound_data>>> decoded;
+
+				for (std::size_t batch_start = 0; batch_start < sound_requests.size(); batch_start += batch_size) {
+					const auto batch_end = std::min(batch_start + batch_size, sound_requests.size());
 
-					try {
-						augs::sound_buffer b = r.second;
-						result.emplace_back(std::move(b));
+					decoded.clear();
+					decoded.resize(batch_end - batch_start);
+
+					for (std::size_t i = batch_start; i < batch_end; ++i) {
+						const auto& r = sound_requests[i];
+
+						if (r.second.source_sound.empty()) {
+							continue;
+						}
+
+						auto& target = decoded[i - batch_start];
+
+						decoders.enqueue([&r, &target, &pcm_cache_dir, this]() {
+							try {
+								target.emplace(augs::decode_sound_variations(r.second, pcm_cache_dir));
+							}
+							catch (...) {
+								/* Will be reported as a missing sound, just like a missing file. */
+							}
+
+							sounds_progress->current_sound_num += 1;
+						});
 					}
-					catch (...) {
-						result.push_back(std::nullopt);
+
+					decoders.submit();
+					decoders.help_until_no_tasks();
+					decoders.wait_for_all_tasks_to_complete();
+
+					for (std::size_t i = batch_start; i < batch_end; ++i) {
+						auto& d = decoded[i - batch_start];
+
+						if (d == std::nullopt) {
+							/* A request to unload or a sound that failed to decode. */
+							result.push_back(std::nullopt);
+							continue;
+						}
+
+						try {
+							result.emplace_back(augs::sound_buffer(*d, sound_requests[i].second.settings));
+						}
+						catch (...) {
+							result.push_back(std::nullopt);
+						}
+
+						d.reset();
 					}
+				}
 
-					sounds_progress->current_sound_num += 1;
+				if (!pcm_cache_dir.empty()) {
+					if (const auto num_evicted = augs::evict_cached_pcm(pcm_cache_dir)) {
+						LOG("Evicted %x least recently used decoded sounds from the cache.", num_evicted);
+					}
 				}
 
 				return result;
@@ -521,7 +587,9 @@ void viewables_streaming::recompress_demos() {
 			augs::path_type(DEMOS_DIR),
 			[](auto&&...) { return callback_result::CONTINUE; },
 			[&file_list](const augs::path_type& demo) {
-				if (demo.extension() == ".dem") {
+				/* Both the recorded and the older, wholly compressed demos are converted to the indexed format. */
+
+				if (demo.extension() == ".dem" || demo.extension() == ".demc") {
 					file_list.push_back(demo);
 				}
 
@@ -536,46 +604,26 @@ void viewables_streaming::recompress_demos() {
 			LOG("All demos are already compressed.");
 		}
 
-		auto state = augs::make_compression_state();
-
 		for (const auto& demo_path : file_list) {
 			LOG("Compressing: %x", demo_path);
-			auto contents = augs::file_to_bytes(demo_path);
 
-			demo_file_meta meta;
+			auto new_path = demo_path;
+			new_path.replace_extension(".demi");
 
-			auto s = augs::make_ptr_read_stream(contents);
 			try {
-				augs::read_bytes(s, meta);
-			}
-			catch (...) {
-				/* Broken/deprecated demo. Just delete it and move on. */
-
-				augs::remove_file(demo_path);
-				continue;
+				if (0 == ::convert_demo_to_indexed(demo_path, new_path)) {
+					LOG("Demo was empty.");
+					continue;
+				}
 			}
+			catch (const std::exception& err) {
+				/* Only ever remove the source once the compressed demo was written and read back. */
 
-			const auto pos = s.get_read_pos();
-
-			if (pos == contents.size()) {
-				LOG("Demo was empty.");
+				LOG("Failed to compress %x: %x. Leaving it as it is.", demo_path, err.what());
+				augs::remove_file(new_path);
 				continue;
 			}
 
-			meta.uncompressed_size = contents.size() - pos;
-			auto compressed = augs::to_bytes(meta);
-
-			augs::compress(
-				state,
-				contents.data() + pos,
-				contents.size() - pos,
-				compressed
-			);
-
-			auto new_path = demo_path;
-			new_path.replace_extension(".demc");
-
-			augs::bytes_to_file(compressed, new_path);
 			augs::remove_file(demo_path);
 		}
 
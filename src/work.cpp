@@ -37,6 +37,7 @@
 #include "augs/window_framework/shell.h"
 #include "augs/log_path_getters.h"
 #include "augs/unit_tests.h"
+#include "augs/internal_benchmarks.h"
 #include "augs/global_libraries.h"
 
 #include "augs/templates/identity_templates.h"
@@ -181,6 +182,21 @@
 #include "augs/readwrite/file_to_bytes.h"
 #if !PLATFORM_WEB
 #include "application/main/dedicated_server_worker.hpp"
+#include "application/main/server_tick_scheduler.hpp"
+#include "application/arena/choose_arena.h"
+#include "application/main/compile_arenas_worker.hpp"
+#if BUILD_NETWORKING && !HEADLESS
+#include "augs/templates/hash_templates.h"
+#include "application/main/client_swarm_worker.hpp"
+#endif
+#if BUILD_NETWORKING
+#include "application/main/solver_benchmark_worker.hpp"
+#endif
+#if BUILD_MASTERSERVER
+#include "augs/misc/httplib_utils.h"
+#include "application/masterserver/masterserver_requests.h"
+#include "application/main/masterserver_load_worker.hpp"
+#endif
 #endif
 #include "work_result.h"
 
@@ -725,6 +741,20 @@ work_result work(
 		LOG("Unit tests were disabled.");
 	}
 
+	if (!params.benchmark_internals.empty()) {
+#if BUILD_INTERNAL_BENCHMARKS
+		if (augs::run_internal_benchmarks(params.benchmark_internals) == 0) {
+			LOG("No internal benchmark matches: %x", params.benchmark_internals);
+			return work_result::FAILURE;
+		}
+
+		return work_result::SUCCESS;
+#else
+		LOG("This build has no internal benchmarks. Rebuild with BUILD_INTERNAL_BENCHMARKS=ON.");
+		return work_result::FAILURE;
+#endif
+	}
+
 	LOG("Initializing ImGui.");
 
 #if !HEADLESS
@@ -1052,6 +1082,31 @@ work_result work(
 
 	};
 
+#if BUILD_MASTERSERVER
+	if (params.masterserver_load_servers > 0) {
+		const auto& masterserver = config.masterserver;
+
+		auto load_in = masterserver_load_input();
+
+		if (const auto local = ::find_netcode_addr(client_connect_string("127.0.0.1"))) {
+			load_in.masterserver_address = *local;
+		}
+
+		load_in.masterserver_address.port = params.first_udp_command_port.value_or(masterserver.first_udp_command_port);
+		load_in.server_list_url = typesafe_sprintf("http://127.0.0.1:%x", params.server_list_port.value_or(masterserver.server_list_port));
+
+		load_in.num_servers = params.masterserver_load_servers;
+		load_in.duration_secs = params.masterserver_load_secs;
+		load_in.heartbeat_interval_secs = std::clamp(config.server.send_heartbeat_to_server_list_once_every_secs, 1u, 60u);
+
+		const auto result = masterserver_load_worker(load_in, handle_sigint);
+
+		LOG("Quitting the masterserver load generator with: %x", ::describe_work_result(result));
+
+		return result;
+	}
+#endif
+
 	{
 		bool sync = false;
 		bool quit_after_sync = false;
@@ -1158,6 +1213,15 @@ work_result work(
 		}
 	}
 
+	if (params.compile_arenas || params.compile_arenas_and_quit) {
+		const auto result = compile_arenas_worker({ *official, config.server }, handle_sigint);
+
+		if (params.compile_arenas_and_quit) {
+			LOG("Quitting after compiling arenas with: %x", ::describe_work_result(result));
+			return result;
+		}
+	}
+
 	if (params.type == app_type::DEDICATED_SERVER) {
 #if BUILD_NETWORKING
 		LOG("Starting the dedicated server.");
@@ -1278,7 +1342,8 @@ work_result work(
 				this_config.self_update,
 				write_or_not,
 				instance_label,
-				"[" + instance_log_label + "] "
+				"[" + instance_log_label + "] ",
+				config_pattern.num_server_solve_workers
 			};
 		};
 
@@ -1337,6 +1402,35 @@ work_result work(
 				}
 			};
 
+			if (config_pattern.num_server_tick_workers > 0) {
+				std::vector<dedicated_server_worker_input> inputs;
+				inputs.reserve(num_total);
+
+				for (uint16_t i = 0; i < num_ranked; ++i) {
+					inputs.emplace_back(make_next_worker_input(i + 1, RANKED));
+				}
+
+				for (uint16_t i = 0; i < num_casual; ++i) {
+					inputs.emplace_back(make_next_worker_input(i + 1, CASUAL));
+				}
+
+				server_tick_scheduler scheduler(
+					{ config_pattern.num_server_tick_workers, config_pattern.pin_server_tick_workers },
+					should_interrupt,
+					on_instance_exit
+				);
+
+				for (const auto& in : inputs) {
+					scheduler.add(in);
+				}
+
+				scheduler.run();
+
+				LOG("Quitting the multi-dedicated server with: %x", ::describe_work_result(result));
+
+				return result;
+			}
+
 			auto make_worker = [&](const uint16_t i, const instance_type type) {
 				return make_server_worker(make_next_worker_input(i + 1, type), should_interrupt, on_instance_exit);
 			};
@@ -1363,6 +1457,67 @@ work_result work(
 #endif
 	}
 
+#if BUILD_NETWORKING && !HEADLESS
+	if (params.client_swarm_size > 0) {
+		auto swarm_in = client_swarm_input {
+			*official,
+			params.connect_address,
+			config.client,
+			config.simulation_receiver,
+			config.lag_compensation,
+			params.client_swarm_size,
+			params.client_swarm_secs
+		};
+
+		if (params.connect_address.empty()) {
+			/* Host the server in this process, so that the swarm can read its profiler. */
+
+			auto server_vars = config.server;
+			server_vars.show_on_server_list = false;
+
+			swarm_in.local_server = std::make_unique<server_setup>(
+				*official,
+				config.server_start,
+				server_vars,
+				config.server_private,
+				config.client,
+				config.dedicated_server,
+
+				std::nullopt,
+				true,
+				server_assigned_teams(),
+
+				config.webrtc_signalling_server_url
+			);
+
+			swarm_in.connect_string = typesafe_sprintf("127.0.0.1:%x", config.server_start.port);
+		}
+
+		const auto result = client_swarm_worker(std::move(swarm_in), handle_sigint);
+
+		LOG("Quitting the client swarm with: %x", ::describe_work_result(result));
+
+		return result;
+	}
+#endif
+
+#if BUILD_NETWORKING
+	if (!params.benchmark_demo.empty()) {
+		const auto benchmark_in = solver_benchmark_input {
+			*official,
+			CALLING_CWD / params.benchmark_demo,
+			params.benchmark_report.empty() ? augs::path_type() : CALLING_CWD / params.benchmark_report,
+			config.lag_compensation
+		};
+
+		const auto result = solver_benchmark_worker(benchmark_in, handle_sigint);
+
+		LOG("Quitting the solver benchmark with: %x", ::describe_work_result(result));
+
+		return result;
+	}
+#endif
+
 #endif // #if !PLATFORM_WEB
 
 #if HEADLESS
@@ -1469,6 +1624,15 @@ work_result work(
 	LOG("Creating the thread pool with %x workers.", num_pool_workers);
 	WEBSTATIC auto thread_pool = augs::thread_pool(num_pool_workers);
 
+	/*
+		The simulation steps have a pool of their own,
+		so that the solver never competes with rendering and audio jobs for the workers.
+	*/
+
+	WEBSTATIC const auto num_solve_workers = config.performance.get_num_solve_workers();
+	LOG("Creating the solve pool with %x workers.", num_solve_workers);
+	WEBSTATIC auto solve_pool = augs::thread_pool(num_solve_workers);
+
 	LOG("Initializing audio command buffers.");
 	WEBSTATIC augs::audio_command_buffers audio_buffers(thread_pool);
 
@@ -4225,7 +4389,8 @@ work_result work(
 						network_performance,
 						network_stats,
 						get_audiovisuals().get<interpolation_system>(),
-						get_audiovisuals().get<past_infection_system>()
+						get_audiovisuals().get<past_infection_system>(),
+						std::addressof(solve_pool)
 					},
 					callbacks
 				);
@@ -4250,7 +4415,8 @@ work_result work(
 						nonzoomedout_zoom,
 						get_detected_nat(),
 						network_performance,
-						server_stats
+						server_stats,
+						std::addressof(solve_pool)
 					},
 					callbacks
 				);
@@ -4525,6 +4691,13 @@ work_result work(
 				if (current_num_workers != requested_num_workers) {
 					thread_pool.resize(requested_num_workers);
 				}
+
+				const auto requested_num_solve_workers = config.performance.get_num_solve_workers();
+				const auto current_num_solve_workers = static_cast<int>(solve_pool.size());
+
+				if (current_num_solve_workers != requested_num_solve_workers) {
+					solve_pool.resize(requested_num_solve_workers);
+				}
 			}
 
 			/* Setup variables required by the lambdas */
@@ -5632,6 +5805,9 @@ work_result work(
 			thread_pool.help_until_no_tasks();
 			thread_pool.wait_for_all_tasks_to_complete();
 
+			game_thread_performance.num_reused_light_visibilities.measure(cached_visibility.num_reused_lights.load());
+			game_thread_performance.num_recalculated_light_visibilities.measure(cached_visibility.num_recalculated_lights.load());
+
 			/* 
 				This task is dependent upon completion of two other tasks: 
 				- game_gui_job